@@ -0,0 +1,235 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+#include <hayai/hayai.hpp>
+
+#include "../test/builder.h"
+
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Intrinsic>
+
+#include <libstdhl/Memory>
+
+#include <asmjit/asmjit.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace libcjel_ir;
+
+static const u64 SIZE = 1 << 16;
+
+/**
+   'equ', 'neq' and 'lnot' over random pairs of 'u64' elements, each kernel
+   is called once per element through its typed entry point and once over
+   the whole array in one batch call, 'equ_branch' is a reference kernel
+   which branches on the comparison like the former lowering of the asmjit
+   pass
+*/
+class CompareFixture : public ::hayai::Fixture
+{
+  public:
+    typedef u8 ( *Kernel )( const void* in );
+
+    CompareFixture( void )
+    : m_runtime( 1024, 0 )
+    {
+    }
+
+    void SetUp( void ) override
+    {
+        std::mt19937_64 random( 0xc7e1 );
+
+        m_pairs.resize( 2 * SIZE );
+        m_res.resize( SIZE );
+
+        for( u64 i = 0; i < 2 * SIZE; i++ )
+        {
+            // small values make equal pairs as likely as different ones
+            m_pairs[ i ] = random() % 2;
+        }
+
+        m_branch = branch();
+
+        m_equ = compile( "equ", []( const Value::Ptr& v, const Value::Ptr& w ) {
+            return libstdhl::Memory::make< EquInstruction >( v, w );
+        } );
+        m_neq = compile( "neq", []( const Value::Ptr& v, const Value::Ptr& w ) {
+            return libstdhl::Memory::make< NeqInstruction >( v, w );
+        } );
+        m_lnot = compile( "lnot", []( const Value::Ptr& v, const Value::Ptr& ) {
+            return libstdhl::Memory::make< LnotInstruction >( v );
+        } );
+    }
+
+    void TearDown( void ) override
+    {
+        m_equ.reset();
+        m_neq.reset();
+        m_lnot.reset();
+
+        m_runtime.release( (void*)m_branch );
+    }
+
+    /**
+       'in[ 0 ] == in[ 1 ]' with a conditional jump and two immediate moves
+    */
+    Kernel branch( void )
+    {
+        using namespace asmjit;
+
+        CodeHolder code;
+        code.init( m_runtime.jit().getCodeInfo() );
+
+        X86Compiler cc( &code );
+        cc.addFunc( FuncSignature1< u8, const void* >( CallConv::kIdHost ) );
+
+        X86Gp in = cc.newUIntPtr( "in" );
+        cc.setArg( 0, in );
+
+        X86Gp v = cc.newU64( "v" );
+        X86Gp r = cc.newU8( "r" );
+        Label equal = cc.newLabel();
+        Label end = cc.newLabel();
+
+        cc.mov( v, x86::qword_ptr( in, 0 ) );
+        cc.cmp( v, x86::qword_ptr( in, 8 ) );
+        cc.je( equal );
+        cc.mov( r, 0 );
+        cc.jmp( end );
+        cc.bind( equal );
+        cc.mov( r, 1 );
+        cc.bind( end );
+        cc.ret( r );
+
+        cc.endFunc();
+        cc.finalize();
+
+        return (Kernel)m_runtime.add( code );
+    }
+
+    std::unique_ptr< libcjel_rt::CallableUnit > compile( const std::string& name,
+        const std::function< Instruction::Ptr( const Value::Ptr&, const Value::Ptr& ) >& op )
+    {
+        auto t = libstdhl::Memory::make< BitType >( 64 );
+        auto r_t = libstdhl::Memory::make< BitType >( 1 );
+
+        return std::unique_ptr< libcjel_rt::CallableUnit >( new libcjel_rt::CallableUnit(
+            libcjel_rt_test::binary_pair( name, t, r_t, op ), m_runtime ) );
+    }
+
+    void call( const libcjel_rt::CallableUnit& callable )
+    {
+        call( callable.as< u8( const void* ) >() );
+    }
+
+    void call( Kernel kernel )
+    {
+        for( u64 i = 0; i < SIZE; i++ )
+        {
+            m_res[ i ] = kernel( &m_pairs[ 2 * i ] );
+        }
+    }
+
+    void batch( const libcjel_rt::CallableUnit& callable )
+    {
+        callable.execute(
+            SIZE, m_res.data(), sizeof( u8 ), { { m_pairs.data(), 2 * sizeof( u64 ) } } );
+    }
+
+    libcjel_rt::Runtime m_runtime;
+
+    std::vector< u64 > m_pairs;
+    std::vector< u8 > m_res;
+
+    Kernel m_branch;
+
+    std::unique_ptr< libcjel_rt::CallableUnit > m_equ;
+    std::unique_ptr< libcjel_rt::CallableUnit > m_neq;
+    std::unique_ptr< libcjel_rt::CallableUnit > m_lnot;
+};
+
+BENCHMARK_F( CompareFixture, equ_branch, 10, 100 )
+{
+    call( m_branch );
+}
+
+BENCHMARK_F( CompareFixture, equ_call, 10, 100 )
+{
+    call( *m_equ );
+}
+
+BENCHMARK_F( CompareFixture, neq_call, 10, 100 )
+{
+    call( *m_neq );
+}
+
+BENCHMARK_F( CompareFixture, lnot_call, 10, 100 )
+{
+    call( *m_lnot );
+}
+
+BENCHMARK_F( CompareFixture, equ_batch, 10, 100 )
+{
+    batch( *m_equ );
+}
+
+BENCHMARK_F( CompareFixture, neq_batch, 10, 100 )
+{
+    batch( *m_neq );
+}
+
+BENCHMARK_F( CompareFixture, lnot_batch, 10, 100 )
+{
+    batch( *m_lnot );
+}
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
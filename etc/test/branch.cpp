@@ -0,0 +1,199 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+
+#include "main.h"
+
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Intrinsic>
+#include <libcjel-ir/Scope>
+#include <libcjel-ir/Statement>
+#include <libcjel-ir/Structure>
+
+#include <libstdhl/Memory>
+
+using namespace libcjel_ir;
+using namespace libcjel_rt_test;
+
+static const auto T = libstdhl::Memory::make< BitType >( 16 );
+
+static StructureType::Ptr pair_type( const std::string& name )
+{
+    const std::vector< StructureElement > structure_args = { { T, "v" }, { T, "w" } };
+    auto structure = libstdhl::Memory::make< Structure >( name, structure_args );
+    return libstdhl::Memory::make< StructureType >( structure );
+}
+
+/**
+   intrinsic 'if( arg.v == arg.w ) { res.v := 1 } else { res.v := 2 }'
+*/
+static Intrinsic::Ptr select( BranchStatement::Ptr& branch )
+{
+    auto s_t = pair_type( "pair" );
+    auto r_t = pair_type( "result" );
+
+    auto x0 = libstdhl::Memory::make< BitConstant >( 8, 0 );
+    auto x1 = libstdhl::Memory::make< BitConstant >( 8, 1 );
+
+    const std::vector< Type::Ptr > f_t_i = { s_t };
+    const std::vector< Type::Ptr > f_t_o = { r_t };
+    auto f_t = libstdhl::Memory::make< RelationType >( f_t_o, f_t_i );
+
+    auto f = libstdhl::Memory::make< Intrinsic >( "select", f_t );
+    auto f_i = f->in( "arg", s_t );
+    auto f_o = f->out( "res", r_t );
+
+    auto scope = libstdhl::Memory::make< SequentialScope >();
+    f->setContext( scope );
+
+    branch = libstdhl::Memory::make< BranchStatement >();
+    branch->setParent( scope );
+    scope->add( branch );
+
+    auto v_ptr = branch->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x0 ) );
+    auto v = branch->add( libstdhl::Memory::make< LoadInstruction >( v_ptr ) );
+    auto w_ptr = branch->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x1 ) );
+    auto w = branch->add( libstdhl::Memory::make< LoadInstruction >( w_ptr ) );
+    branch->add( libstdhl::Memory::make< EquInstruction >( v, w ) );
+
+    for( u64 value : { 1, 2 } )
+    {
+        auto arm = libstdhl::Memory::make< ParallelScope >();
+        arm->setParent( branch );
+        branch->addScope( arm );
+
+        auto stmt = libstdhl::Memory::make< TrivialStatement >();
+        stmt->setParent( arm );
+        arm->add( stmt );
+
+        auto r_ptr = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_o, x0 ) );
+        auto c = libstdhl::Memory::make< BitConstant >( T, value );
+        stmt->add( libstdhl::Memory::make< StoreInstruction >( c, r_ptr ) );
+    }
+
+    return f;
+}
+
+/**
+   executes 'f' for 'v' and 'w' and checks the stored result
+*/
+static void expect_select( Intrinsic::Ptr& f, u64 v, u64 w, libcjel_rt::Runtime& runtime )
+{
+    const auto& s_t = f->inputs()[ 0 ]->ptr_type();
+    const auto& r_t = f->outputs()[ 0 ]->ptr_type();
+
+    const std::vector< Constant > args = { BitConstant( T, v ), BitConstant( T, w ) };
+    auto a = libstdhl::Memory::make< StructureConstant >( s_t, args );
+
+    const std::vector< Constant > res = { BitConstant( T, v == w ? 1 : 2 ), BitConstant( T, 0 ) };
+    auto e = StructureConstant( r_t, res );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( r_t );
+    auto i = CallInstruction( f, { a, m } );
+
+    EXPECT_TRUE( libcjel_rt::Instruction::execute( i, runtime ) == e );
+}
+
+TEST( libcjel_rt__branch, predicated_branches_select_the_stored_value )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    BranchStatement::Ptr branch;
+    auto f = select( branch );
+
+    expect_select( f, 3, 3, runtime );
+    expect_select( f, 3, 4, runtime );
+
+    // if-converted branches have no jumps to count
+    EXPECT_EQ( ( *runtime.branchCounts( branch.get() ) )[ 1 ], 0 );
+}
+
+TEST( libcjel_rt__branch, branches_count_their_executions )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+    runtime.setIfConversionBudget( 0 );
+
+    BranchStatement::Ptr branch;
+    auto f = select( branch );
+
+    expect_select( f, 3, 3, runtime );
+    expect_select( f, 3, 4, runtime );
+    expect_select( f, 5, 4, runtime );
+
+    EXPECT_EQ( ( *runtime.branchCounts( branch.get() ) )[ 0 ], 1 );
+    EXPECT_EQ( ( *runtime.branchCounts( branch.get() ) )[ 1 ], 3 );
+}
+
+TEST( libcjel_rt__branch, cold_scopes_compute_the_same_result )
+{
+    for( u64 taken : { 0, 100 } )
+    {
+        libcjel_rt::Runtime runtime( 1024, 0 );
+        runtime.setIfConversionBudget( 0 );
+
+        BranchStatement::Ptr branch;
+        auto f = select( branch );
+
+        // recorded counts place the first or the second scope out of line,
+        // they are held here as no code increments them yet
+        auto counts = runtime.branchCounts( branch.get() );
+        ( *counts )[ 0 ] = taken;
+        ( *counts )[ 1 ] = 100;
+
+        expect_select( f, 3, 3, runtime );
+        expect_select( f, 3, 4, runtime );
+
+        EXPECT_EQ( ( *counts )[ 0 ], taken + 1 );
+        EXPECT_EQ( ( *counts )[ 1 ], 102 );
+    }
+}
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
@@ -0,0 +1,143 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+#include "builder.h"
+
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Scope>
+#include <libcjel-ir/Statement>
+#include <libcjel-ir/Structure>
+
+#include <libstdhl/Memory>
+
+using namespace libcjel_ir;
+
+Intrinsic::Ptr libcjel_rt_test::add_pair( const Type::Ptr& type )
+{
+    return binary_pair( "add_pair", type, type, []( const Value::Ptr& v, const Value::Ptr& w ) {
+        return libstdhl::Memory::make< AddUnsignedInstruction >( v, w );
+    } );
+}
+
+Intrinsic::Ptr libcjel_rt_test::binary_pair( const std::string& name,
+    const Type::Ptr& type,
+    const Type::Ptr& result,
+    const std::function< Instruction::Ptr( const Value::Ptr&, const Value::Ptr& ) >& op )
+{
+    const std::vector< StructureElement > structure_args = { { type, "v" }, { type, "w" } };
+    auto structure = libstdhl::Memory::make< Structure >( "pair", structure_args );
+    auto s_t = libstdhl::Memory::make< StructureType >( structure );
+
+    auto x0 = libstdhl::Memory::make< BitConstant >( 8, 0 );
+    auto x1 = libstdhl::Memory::make< BitConstant >( 8, 1 );
+
+    const std::vector< Type::Ptr > f_t_i = { s_t };
+    const std::vector< Type::Ptr > f_t_o = { result };
+    auto f_t = libstdhl::Memory::make< RelationType >( f_t_o, f_t_i );
+
+    auto f = libstdhl::Memory::make< Intrinsic >( name, f_t );
+    auto f_i = f->in( "arg", s_t );
+    auto f_o = f->out( "res", result );
+
+    auto scope = libstdhl::Memory::make< ParallelScope >();
+    f->setContext( scope );
+
+    auto stmt = libstdhl::Memory::make< TrivialStatement >();
+    stmt->setParent( scope );
+    scope->add( stmt );
+
+    auto v_ptr = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x0 ) );
+    auto v_ld = stmt->add( libstdhl::Memory::make< LoadInstruction >( v_ptr ) );
+    auto w_ptr = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x1 ) );
+    auto w_ld = stmt->add( libstdhl::Memory::make< LoadInstruction >( w_ptr ) );
+
+    auto r = stmt->add( op( v_ld, w_ld ) );
+    stmt->add( libstdhl::Memory::make< StoreInstruction >( r, f_o ) );
+
+    return f;
+}
+
+Intrinsic::Ptr libcjel_rt_test::forward( const std::string& name, const Intrinsic::Ptr& f )
+{
+    const auto& s_t = f->inputs()[ 0 ]->ptr_type();
+    const auto& r_t = f->outputs()[ 0 ]->ptr_type();
+
+    auto g = libstdhl::Memory::make< Intrinsic >( name, f->ptr_type() );
+    auto g_i = g->in( "arg", s_t );
+    auto g_o = g->out( "res", r_t );
+
+    auto scope = libstdhl::Memory::make< ParallelScope >();
+    g->setContext( scope );
+
+    auto stmt = libstdhl::Memory::make< TrivialStatement >();
+    stmt->setParent( scope );
+    scope->add( stmt );
+
+    const std::vector< Value::Ptr > args = { g_i, g_o };
+    stmt->add( libstdhl::Memory::make< CallInstruction >( f, args ) );
+
+    return g;
+}
+
+StructureConstant::Ptr libcjel_rt_test::pair( const Intrinsic::Ptr& f, u64 v, u64 w )
+{
+    const auto e_t = std::static_pointer_cast< BitType >( f->outputs()[ 0 ]->ptr_type() );
+    return pair( f, e_t, v, w );
+}
+
+StructureConstant::Ptr libcjel_rt_test::pair(
+    const Intrinsic::Ptr& f, const BitType::Ptr& type, u64 v, u64 w )
+{
+    const auto& s_t = f->inputs()[ 0 ]->ptr_type();
+
+    const std::vector< Constant > args = { BitConstant( type, v ), BitConstant( type, w ) };
+    return libstdhl::Memory::make< StructureConstant >( s_t, args );
+}
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
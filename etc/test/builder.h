@@ -0,0 +1,102 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+#ifndef _LIBCJEL_RT_TEST_BUILDER_H_
+#define _LIBCJEL_RT_TEST_BUILDER_H_
+
+#include <libcjel-rt/libcjel-rt>
+
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Intrinsic>
+
+#include <functional>
+
+namespace libcjel_rt_test
+{
+    /**
+       intrinsic 'res := arg.v + arg.w' over a structure of two 'type' elements
+    */
+    libcjel_ir::Intrinsic::Ptr add_pair( const libcjel_ir::Type::Ptr& type );
+
+    /**
+       intrinsic 'res := op( arg.v, arg.w )' of type 'result' over a structure
+       of two 'type' elements, the operands of 'op' are loads and therefore
+       never folded
+    */
+    libcjel_ir::Intrinsic::Ptr binary_pair( const std::string& name,
+        const libcjel_ir::Type::Ptr& type,
+        const libcjel_ir::Type::Ptr& result,
+        const std::function< libcjel_ir::Instruction::Ptr(
+            const libcjel_ir::Value::Ptr&, const libcjel_ir::Value::Ptr& ) >& op );
+
+    /**
+       intrinsic 'name' which only calls 'f' with its own parameters
+    */
+    libcjel_ir::Intrinsic::Ptr forward(
+        const std::string& name, const libcjel_ir::Intrinsic::Ptr& f );
+
+    /**
+       structure constant '{ v, w }' matching the input of 'f' of 'add_pair'
+    */
+    libcjel_ir::StructureConstant::Ptr pair( const libcjel_ir::Intrinsic::Ptr& f, u64 v, u64 w );
+
+    /**
+       structure constant '{ v, w }' of 'type' elements matching the input of
+       'f' of 'binary_pair'
+    */
+    libcjel_ir::StructureConstant::Ptr pair( const libcjel_ir::Intrinsic::Ptr& f,
+        const libcjel_ir::BitType::Ptr& type,
+        u64 v,
+        u64 w );
+}
+
+#endif  // _LIBCJEL_RT_TEST_BUILDER_H_
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
@@ -0,0 +1,200 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+#include "main.h"
+
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Intrinsic>
+
+#include <libstdhl/Memory>
+
+using namespace libcjel_ir;
+using namespace libcjel_rt_test;
+
+using Key = libcjel_rt::CodeCache::Key;
+
+TEST( libcjel_rt__cache, same_shape_is_compiled_once )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+    auto& cache = runtime.cache();
+
+    auto t = libstdhl::Memory::make< BitType >( 16 );
+    auto f = add_pair( t );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( t );
+    auto i0 = CallInstruction( f, { pair( f, 0x1234, 0x00ff ), m } );
+    auto i1 = CallInstruction( f, { pair( f, 0x1234, 0xff00 ), m } );
+
+    const auto misses = cache.misses();
+    const auto hits = cache.hits();
+
+    auto r0 = libcjel_rt::Instruction::execute( i0, runtime );
+    auto r1 = libcjel_rt::Instruction::execute( i1, runtime );
+
+    EXPECT_TRUE( r0 == BitConstant( t, 0x1333 ) );
+    EXPECT_TRUE( r1 == BitConstant( t, 0x1134 ) );
+
+    EXPECT_EQ( cache.misses(), misses + 1 );
+    EXPECT_EQ( cache.hits(), hits + 1 );
+}
+
+TEST( libcjel_rt__cache, different_bit_width_is_a_different_shape )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+    auto& cache = runtime.cache();
+
+    auto t8 = libstdhl::Memory::make< BitType >( 8 );
+    auto t32 = libstdhl::Memory::make< BitType >( 32 );
+
+    auto f8 = add_pair( t8 );
+    auto f32 = add_pair( t32 );
+
+    auto m8 = libstdhl::Memory::make< AllocInstruction >( t8 );
+    auto m32 = libstdhl::Memory::make< AllocInstruction >( t32 );
+
+    auto i0 = CallInstruction( f8, { pair( f8, 0x0f, 0x0f ), m8 } );
+    auto i1 = CallInstruction( f32, { pair( f32, 0x0f, 0x0f ), m32 } );
+
+    libcjel_rt::Instruction::execute( i0, runtime );
+
+    const auto misses = cache.misses();
+    libcjel_rt::Instruction::execute( i1, runtime );
+
+    EXPECT_EQ( cache.misses(), misses + 1 );
+}
+
+TEST( libcjel_rt__cache, equal_hashes_of_different_shapes_do_not_alias )
+{
+    libcjel_rt::Runtime runtime;
+    libcjel_rt::CodeCache cache( runtime, 2 );
+
+    int code = 0;
+    cache.insert( Key( 1, "a" ), &code, {} );
+
+    EXPECT_TRUE( cache.lookup( Key( 1, "b" ) ) == nullptr );
+    EXPECT_EQ( cache.lookup( Key( 1, "a" ) )->entry(), &code );
+}
+
+TEST( libcjel_rt__cache, callee_bodies_are_memoized_until_evicted )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+    libcjel_rt::CodeCache cache( runtime, 1 );
+
+    auto t = libstdhl::Memory::make< BitType >( 16 );
+    auto f = add_pair( t );
+    auto g = add_pair( t );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( t );
+    auto i0 = CallInstruction( f, { pair( f, 1, 2 ), m } );
+    auto i1 = CallInstruction( f, { pair( f, 3, 4 ), m } );
+    auto i2 = CallInstruction( g, { pair( g, 1, 2 ), m } );
+
+    {
+        const auto k0 = cache.key( i0 );
+        const auto k1 = cache.key( i1 );
+        EXPECT_TRUE( k0 == k1 );
+        EXPECT_EQ( cache.bodies(), 1 );
+
+        // an equal body of another callable is memoized on its own
+        const auto k2 = cache.key( i2 );
+        EXPECT_TRUE( k0 == k2 );
+        EXPECT_EQ( cache.bodies(), 2 );
+
+        cache.insert( k0, nullptr, {} );
+    }
+
+    // evicting the only key of 'f' drops both bodies, neither is referenced
+    cache.insert( Key( 1, "1" ), nullptr, {} );
+    EXPECT_EQ( cache.evictions(), 1 );
+    EXPECT_EQ( cache.bodies(), 0 );
+}
+
+TEST( libcjel_rt__cache, capacity_evicts_least_recently_used )
+{
+    libcjel_rt::Runtime runtime;
+    libcjel_rt::CodeCache cache( runtime, 2 );
+
+    cache.insert( Key( 1, "1" ), nullptr, {} );
+    cache.insert( Key( 2, "2" ), nullptr, {} );
+    cache.lookup( Key( 1, "1" ) );
+    cache.insert( Key( 3, "3" ), nullptr, {} );
+
+    EXPECT_EQ( cache.size(), 2 );
+    EXPECT_EQ( cache.evictions(), 1 );
+
+    EXPECT_TRUE( cache.lookup( Key( 1, "1" ) ) != nullptr );
+    EXPECT_TRUE( cache.lookup( Key( 2, "2" ) ) == nullptr );
+    EXPECT_TRUE( cache.lookup( Key( 3, "3" ) ) != nullptr );
+}
+
+TEST( libcjel_rt__cache, replaced_code_stays_alive_for_running_callers )
+{
+    libcjel_rt::Runtime runtime;
+    libcjel_rt::CodeCache cache( runtime, 2 );
+
+    int previous = 0;
+    int next = 0;
+
+    auto running = cache.insert( Key( 1, "1" ), &previous, {}, true );
+    cache.replace( Key( 1, "1" ), &next, {} );
+
+    EXPECT_EQ( cache.size(), 1 );
+    EXPECT_EQ( cache.replacements(), 1 );
+
+    EXPECT_EQ( running->entry(), &previous );
+    EXPECT_EQ( cache.lookup( Key( 1, "1" ) )->entry(), &next );
+    EXPECT_FALSE( cache.lookup( Key( 1, "1" ) )->instrumented() );
+
+    EXPECT_TRUE( running->retire() );
+    EXPECT_FALSE( running->retire() );
+}
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
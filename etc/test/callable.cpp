@@ -0,0 +1,326 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+#include "main.h"
+
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Intrinsic>
+#include <libcjel-ir/Scope>
+#include <libcjel-ir/Statement>
+#include <libcjel-ir/Structure>
+
+#include <libstdhl/Memory>
+
+using namespace libcjel_ir;
+using namespace libcjel_rt_test;
+
+/**
+   intrinsic 'match' which compares both elements of its pair input of 'type'
+   and returns '{ v == w, ~v ^ w }'
+*/
+static Intrinsic::Ptr match_pair( const Type::Ptr& type )
+{
+    const std::vector< StructureElement > pair_args = { { type, "v" }, { type, "w" } };
+    auto pair = libstdhl::Memory::make< Structure >( "pair", pair_args );
+    auto p_t = libstdhl::Memory::make< StructureType >( pair );
+
+    auto b_t = libstdhl::Memory::make< BitType >( 1 );
+    const std::vector< StructureElement > result_args = { { b_t, "equal" }, { type, "diff" } };
+    auto result = libstdhl::Memory::make< Structure >( "result", result_args );
+    auto r_t = libstdhl::Memory::make< StructureType >( result );
+
+    auto x0 = libstdhl::Memory::make< BitConstant >( 8, 0 );
+    auto x1 = libstdhl::Memory::make< BitConstant >( 8, 1 );
+
+    const std::vector< Type::Ptr > f_t_i = { p_t };
+    const std::vector< Type::Ptr > f_t_o = { r_t };
+    auto f_t = libstdhl::Memory::make< RelationType >( f_t_o, f_t_i );
+
+    auto f = libstdhl::Memory::make< Intrinsic >( "match", f_t );
+    auto f_i = f->in( "arg", p_t );
+    auto f_o = f->out( "res", r_t );
+
+    auto scope = libstdhl::Memory::make< ParallelScope >();
+    f->setContext( scope );
+
+    auto stmt = libstdhl::Memory::make< TrivialStatement >();
+    stmt->setParent( scope );
+    scope->add( stmt );
+
+    auto v_ptr = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x0 ) );
+    auto v_ld = stmt->add( libstdhl::Memory::make< LoadInstruction >( v_ptr ) );
+    auto w_ptr = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x1 ) );
+    auto w_ld = stmt->add( libstdhl::Memory::make< LoadInstruction >( w_ptr ) );
+
+    auto equal = stmt->add( libstdhl::Memory::make< EquInstruction >( v_ld, w_ld ) );
+    auto v_not = stmt->add( libstdhl::Memory::make< NotInstruction >( v_ld ) );
+    auto diff = stmt->add( libstdhl::Memory::make< XorInstruction >( v_not, w_ld ) );
+
+    auto e_ptr = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_o, x0 ) );
+    stmt->add( libstdhl::Memory::make< StoreInstruction >( equal, e_ptr ) );
+    auto d_ptr = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_o, x1 ) );
+    stmt->add( libstdhl::Memory::make< StoreInstruction >( diff, d_ptr ) );
+
+    return f;
+}
+
+TEST( libcjel_rt__callable, typed_entry_points_are_called_natively )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    auto f = add_pair( libstdhl::Memory::make< BitType >( 16 ) );
+    libcjel_rt::CallableUnit callable( f, runtime );
+
+    auto add = callable.as< u16( const void* ) >();
+    ASSERT_NE( add, nullptr );
+
+    const u16 arg[ 2 ] = { 0x1234, 0x0101 };
+    EXPECT_EQ( add( arg ), 0x1335 );
+
+    // copies share the compiled code
+    libcjel_rt::CallableUnit copy = callable;
+    EXPECT_EQ( copy.entry(), callable.entry() );
+}
+
+TEST( libcjel_rt__callable, mismatching_signatures_are_rejected )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    auto f = add_pair( libstdhl::Memory::make< BitType >( 16 ) );
+    libcjel_rt::CallableUnit callable( f, runtime );
+
+    EXPECT_EQ( callable.as< u32( const void* ) >(), nullptr );
+    EXPECT_EQ( callable.as< u16( u16, u16 ) >(), nullptr );
+    EXPECT_EQ( callable.as< u16() >(), nullptr );
+    EXPECT_EQ( callable.as< void( void*, const void* ) >(), nullptr );
+}
+
+TEST( libcjel_rt__callable, bit_results_are_returned_in_a_register )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    auto t = libstdhl::Memory::make< BitType >( 32 );
+    auto f = binary_pair( "equ", t, libstdhl::Memory::make< BitType >( 1 ),
+        []( const Value::Ptr& v, const Value::Ptr& w ) {
+            return libstdhl::Memory::make< EquInstruction >( v, w );
+        } );
+    libcjel_rt::CallableUnit callable( f, runtime );
+
+    // a 'u1' takes one byte
+    EXPECT_EQ( callable.as< u16( const void* ) >(), nullptr );
+
+    auto equ = callable.as< u8( const void* ) >();
+    ASSERT_NE( equ, nullptr );
+
+    const u32 equal[ 2 ] = { 0xcafe, 0xcafe };
+    const u32 different[ 2 ] = { 0xcafe, 0xbeef };
+    EXPECT_EQ( equ( equal ), 1 );
+    EXPECT_EQ( equ( different ), 0 );
+}
+
+TEST( libcjel_rt__callable, structure_inputs_are_passed_by_pointer )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    auto f = add_pair( libstdhl::Memory::make< BitType >( 64 ) );
+    libcjel_rt::CallableUnit callable( f, runtime );
+
+    EXPECT_EQ( callable.as< u64( u64 ) >(), nullptr );
+
+    auto add = callable.as< u64( const void* ) >();
+    ASSERT_NE( add, nullptr );
+
+    const u64 arg[ 2 ] = { 0x0123456789abcdef, 0x1111111111111111 };
+    EXPECT_EQ( add( arg ), 0x12345678abcdef00 );
+}
+
+TEST( libcjel_rt__callable, results_of_other_sizes_are_written_through_out )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    // the result '{ u1, u16 }' takes three bytes
+    auto f = match_pair( libstdhl::Memory::make< BitType >( 16 ) );
+    libcjel_rt::CallableUnit callable( f, runtime );
+
+    EXPECT_EQ( callable.as< u32( const void* ) >(), nullptr );
+
+    auto match = callable.as< void( void*, const void* ) >();
+    ASSERT_NE( match, nullptr );
+
+    const u16 arg[ 2 ] = { 0x1234, 0x00ff };
+    u8 out[ 3 ] = { 0xff, 0xff, 0xff };
+    match( out, arg );
+
+    EXPECT_EQ( out[ 0 ], 0 );
+    EXPECT_EQ( out[ 1 ], 0x34 );
+    EXPECT_EQ( out[ 2 ], 0xed );
+}
+
+TEST( libcjel_rt__callable, odd_width_structures_are_packed_at_their_byte_size )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    // the input '{ u12, u12 }' is read as two 'u16' and the result
+    // '{ u1, u12 }' is written as one 'u8' followed by one 'u16'
+    {
+        auto f = match_pair( libstdhl::Memory::make< BitType >( 12 ) );
+        libcjel_rt::CallableUnit callable( f, runtime );
+
+        auto match = callable.as< void( void*, const void* ) >();
+        ASSERT_NE( match, nullptr );
+
+        const u16 arg[ 2 ] = { 0x0abc, 0x0123 };
+        u8 out[ 3 ] = { 0xff, 0xff, 0xff };
+        match( out, arg );
+
+        const u16 diff = ( ~0x0abc ^ 0x0123 ) & 0x0fff;
+        EXPECT_EQ( out[ 0 ], 0 );
+        EXPECT_EQ( out[ 1 ], diff & 0xff );
+        EXPECT_EQ( out[ 2 ], diff >> 8 );
+    }
+
+    // the result '{ u1, u2 }' takes two bytes and is returned in a register
+    {
+        auto f = match_pair( libstdhl::Memory::make< BitType >( 2 ) );
+        libcjel_rt::CallableUnit callable( f, runtime );
+
+        auto match = callable.as< u16( const void* ) >();
+        ASSERT_NE( match, nullptr );
+
+        const u8 arg[ 2 ] = { 0x2, 0x2 };
+        EXPECT_EQ( match( arg ), 0x0301 );
+    }
+}
+
+TEST( libcjel_rt__callable, arrays_are_evaluated_in_one_batch )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    auto f = add_pair( libstdhl::Memory::make< BitType >( 16 ) );
+    libcjel_rt::CallableUnit callable( f, runtime );
+
+    const u64 count = 1000;
+    std::vector< u16 > pairs( 2 * count );
+    for( u64 i = 0; i < count; i++ )
+    {
+        pairs[ 2 * i ] = i;
+        pairs[ 2 * i + 1 ] = 3 * i;
+    }
+
+    // every second result is written, the others stay untouched
+    std::vector< u16 > results( 2 * count, 0xffff );
+    callable.execute( count, results.data(), 2 * sizeof( u16 ), { { pairs.data(), 4 } } );
+
+    for( u64 i = 0; i < count; i++ )
+    {
+        EXPECT_EQ( results[ 2 * i ], (u16)( 4 * i ) );
+        EXPECT_EQ( results[ 2 * i + 1 ], 0xffff );
+    }
+
+    callable.execute( 0, results.data(), 2 * sizeof( u16 ), { { nullptr, 4 } } );
+    EXPECT_EQ( results[ 2 ], 4 );
+}
+
+TEST( libcjel_rt__callable, dense_arrays_are_evaluated_lane_wise )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    auto f = add_pair( libstdhl::Memory::make< BitType >( 8 ) );
+    libcjel_rt::CallableUnit callable( f, runtime );
+
+    // not a multiple of the lanes, so the last elements take the scalar loop
+    const u64 count = 1003;
+    std::vector< u8 > pairs( 2 * count );
+    for( u64 i = 0; i < count; i++ )
+    {
+        pairs[ 2 * i ] = i;
+        pairs[ 2 * i + 1 ] = 7 * i;
+    }
+
+    std::vector< u8 > results( count );
+    callable.execute( count, results.data(), sizeof( u8 ), { { pairs.data(), 2 } } );
+
+    for( u64 i = 0; i < count; i++ )
+    {
+        EXPECT_EQ( results[ i ], (u8)( 8 * i ) );
+    }
+}
+
+TEST( libcjel_rt__callable, lane_masks_of_comparisons_are_stored_as_bits )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    auto f = match_pair( libstdhl::Memory::make< BitType >( 8 ) );
+    libcjel_rt::CallableUnit callable( f, runtime );
+
+    const u64 count = 333;
+    std::vector< u8 > pairs( 2 * count );
+    for( u64 i = 0; i < count; i++ )
+    {
+        pairs[ 2 * i ] = i;
+        pairs[ 2 * i + 1 ] = i % 3 ? i : 5 * i;
+    }
+
+    // the results are encoded as '{ u8 equal, u8 diff }'
+    std::vector< u8 > results( 2 * count );
+    callable.execute( count, results.data(), 2, { { pairs.data(), 2 } } );
+
+    for( u64 i = 0; i < count; i++ )
+    {
+        const u8 v = pairs[ 2 * i ];
+        const u8 w = pairs[ 2 * i + 1 ];
+
+        EXPECT_EQ( results[ 2 * i ], v == w ? 1 : 0 );
+        EXPECT_EQ( results[ 2 * i + 1 ], (u8)( ~v ^ w ) );
+    }
+}
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
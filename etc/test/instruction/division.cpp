@@ -0,0 +1,225 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+
+#include "main.h"
+
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Intrinsic>
+
+#include <libstdhl/Memory>
+
+using namespace libcjel_ir;
+using Operation = libcjel_rt::NativeEvaluator::Operation;
+
+/**
+   intrinsic 'res := arg.v / divisor' or 'res := arg.v % divisor' where a
+   non-'constant' divisor is loaded from 'arg.w'
+*/
+static Intrinsic::Ptr divide( u16 bitsize, Operation operation, u64 divisor, u1 constant )
+{
+    auto t = libstdhl::Memory::make< BitType >( bitsize );
+
+    return libcjel_rt_test::binary_pair(
+        "divide", t, t, [&]( const Value::Ptr& v, const Value::Ptr& w ) -> Instruction::Ptr {
+            const Value::Ptr d =
+                constant ? libstdhl::Memory::make< BitConstant >( t, divisor ) : w;
+
+            if( operation == Operation::DIV_SIGNED )
+            {
+                return libstdhl::Memory::make< DivSignedInstruction >( v, d );
+            }
+
+            return libstdhl::Memory::make< ModUnsignedInstruction >( v, d );
+        } );
+}
+
+/**
+   checks the compiled 'f' against the native evaluator for all 'values'
+*/
+static void expect_divide(
+    u16 bitsize, Operation operation, u64 divisor, const std::vector< u64 >& values )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    const u64 mask = libcjel_rt::NativeEvaluator::mask( bitsize );
+    auto f = divide( bitsize, operation, divisor, divisor != 0 );
+    auto t = std::static_pointer_cast< BitType >( f->outputs()[ 0 ]->ptr_type() );
+    auto m = libstdhl::Memory::make< AllocInstruction >( t );
+
+    for( u64 v : values )
+    {
+        const u64 w = divisor ? divisor : ( v % 9 ) + 1;
+        auto i = CallInstruction( f, { libcjel_rt_test::pair( f, v & mask, w & mask ), m } );
+
+        const u64 e = libcjel_rt::NativeEvaluator::evaluate( operation, v, w, bitsize, bitsize );
+        EXPECT_TRUE( libcjel_rt::Instruction::execute( i, runtime ) == BitConstant( t, e ) )
+            << bitsize << "-bit " << v << " by " << w;
+    }
+}
+
+static const std::vector< u64 > VALUES = { 0, 1, 2, 5, 99, 0x7f, 0x80, 0xff, 0x1fff, 0x7fffffff,
+    0x80000000, 0xffffffff, 0x123456789abcdef0, 0x7fffffffffffffff, 0x8000000000000000,
+    0xffffffffffffffff };
+
+TEST( libcjel_rt__instruction_division, signed_division_by_constants )
+{
+    for( u16 bitsize : { 8, 13, 32, 64 } )
+    {
+        const u64 mask = libcjel_rt::NativeEvaluator::mask( bitsize );
+
+        for( u64 divisor : { (u64)1, (u64)3, (u64)7, (u64)16, mask, mask - 6, mask >> 1 } )
+        {
+            expect_divide( bitsize, Operation::DIV_SIGNED, divisor, VALUES );
+        }
+    }
+}
+
+TEST( libcjel_rt__instruction_division, unsigned_modulo_by_constants )
+{
+    for( u16 bitsize : { 8, 13, 32, 64 } )
+    {
+        const u64 mask = libcjel_rt::NativeEvaluator::mask( bitsize );
+
+        for( u64 divisor : { (u64)1, (u64)3, (u64)10, (u64)64, mask, mask >> 1, mask - 1 } )
+        {
+            expect_divide( bitsize, Operation::MOD_UNSIGNED, divisor, VALUES );
+        }
+    }
+}
+
+/**
+   checks 'f' for all 'values' and the loaded or 'constant' 'divisor' against
+   'expected', the first 'threshold' calls are interpreted
+*/
+static void expect_divide_by( u16 bitsize,
+    Operation operation,
+    u64 divisor,
+    u1 constant,
+    const std::vector< u64 >& values,
+    const std::function< u64( u64 ) >& expected,
+    u64 threshold = 0 )
+{
+    libcjel_rt::Runtime runtime( 1024, threshold );
+
+    const u64 mask = libcjel_rt::NativeEvaluator::mask( bitsize );
+    auto f = divide( bitsize, operation, divisor & mask, constant );
+    auto t = std::static_pointer_cast< BitType >( f->outputs()[ 0 ]->ptr_type() );
+    auto m = libstdhl::Memory::make< AllocInstruction >( t );
+
+    for( u64 v : values )
+    {
+        auto i = CallInstruction(
+            f, { libcjel_rt_test::pair( f, v & mask, divisor & mask ), m } );
+
+        EXPECT_TRUE( libcjel_rt::Instruction::execute( i, runtime ) ==
+                     BitConstant( t, expected( v & mask ) & mask ) )
+            << bitsize << "-bit " << v << " by " << divisor;
+    }
+
+    if( threshold )
+    {
+        EXPECT_GT( runtime.interpreter().interpretations(), 0 );
+    }
+    else
+    {
+        EXPECT_EQ( runtime.interpreter().interpretations(), 0 );
+    }
+}
+
+TEST( libcjel_rt__instruction_division, division_by_variables )
+{
+    for( u16 bitsize : { 8, 13, 32, 33, 64 } )
+    {
+        expect_divide( bitsize, Operation::DIV_SIGNED, 0, VALUES );
+        expect_divide( bitsize, Operation::MOD_UNSIGNED, 0, VALUES );
+    }
+}
+
+
+TEST( libcjel_rt__instruction_division, division_by_zero_yields_zero )
+{
+    // the interpreter tier with the default threshold evaluates the first
+    // calls natively, neither tier raises a divide error
+    for( u16 bitsize : { 8, 13, 32, 33, 64 } )
+    {
+        for( u1 constant : { true, false } )
+        {
+            for( auto operation : { Operation::DIV_SIGNED, Operation::MOD_UNSIGNED } )
+            {
+                for( u64 threshold : { 0, 8 } )
+                {
+                    expect_divide_by(
+                        bitsize, operation, 0, constant, VALUES, []( u64 ) { return 0; },
+                        threshold );
+                }
+            }
+        }
+    }
+}
+
+TEST( libcjel_rt__instruction_division, minimum_by_minus_one_wraps )
+{
+    for( u16 bitsize : { 8, 13, 32, 33, 64 } )
+    {
+        const u64 mask = libcjel_rt::NativeEvaluator::mask( bitsize );
+
+        for( u1 constant : { true, false } )
+        {
+            expect_divide_by( bitsize, Operation::DIV_SIGNED, mask, constant, VALUES,
+                [bitsize]( u64 v ) {
+                    return libcjel_rt::NativeEvaluator::evaluate(
+                        Operation::DIV_SIGNED, v, (u64)-1, bitsize, bitsize );
+                } );
+        }
+    }
+}
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
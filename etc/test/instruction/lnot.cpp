@@ -51,6 +51,7 @@
 #include <libstdhl/Memory>
 
 using namespace libcjel_ir;
+using namespace libcjel_rt_test;
 
 TEST( libcjel_rt__instruction_lnot, LnotInstruction_false_64 )
 {
@@ -104,6 +105,58 @@ TEST( libcjel_rt__instruction_lnot, LnotInstruction_8_false )
     ASSERT_TRUE( r == BitConstant( r_t, 0 ) );
 }
 
+TEST( libcjel_rt__instruction_lnot, LnotInstruction_non_constant_8 )
+{
+    // the interpreter tier is disabled and the operands are loads, so the
+    // negation is lowered by the asmjit pass and not folded
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    auto t = libstdhl::Memory::make< BitType >( 8 );
+    auto r_t = libstdhl::Memory::make< BitType >( 1 );
+
+    auto f = binary_pair( "lnot_pair", t, r_t, []( const Value::Ptr& v, const Value::Ptr& ) {
+        return libstdhl::Memory::make< LnotInstruction >( v );
+    } );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( r_t );
+
+    {
+        auto i = CallInstruction( f, { pair( f, t, 0, 0 ), m } );
+        EXPECT_TRUE( libcjel_rt::Instruction::execute( i, runtime ) == BitConstant( r_t, 1 ) );
+    }
+
+    {
+        auto i = CallInstruction( f, { pair( f, t, 0x80, 0 ), m } );
+        EXPECT_TRUE( libcjel_rt::Instruction::execute( i, runtime ) == BitConstant( r_t, 0 ) );
+    }
+}
+
+TEST( libcjel_rt__instruction_lnot, LnotInstruction_non_constant_64 )
+{
+    // the interpreter tier is disabled and the operands are loads, so the
+    // negation is lowered by the asmjit pass and not folded
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    auto t = libstdhl::Memory::make< BitType >( 64 );
+    auto r_t = libstdhl::Memory::make< BitType >( 1 );
+
+    auto f = binary_pair( "lnot_pair", t, r_t, []( const Value::Ptr& v, const Value::Ptr& ) {
+        return libstdhl::Memory::make< LnotInstruction >( v );
+    } );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( r_t );
+
+    {
+        auto i = CallInstruction( f, { pair( f, t, 0, 0 ), m } );
+        EXPECT_TRUE( libcjel_rt::Instruction::execute( i, runtime ) == BitConstant( r_t, 1 ) );
+    }
+
+    {
+        auto i = CallInstruction( f, { pair( f, t, 0xdeadbeef00000000, 0 ), m } );
+        EXPECT_TRUE( libcjel_rt::Instruction::execute( i, runtime ) == BitConstant( r_t, 0 ) );
+    }
+}
+
 //
 //  Local variables:
 //  mode: c++
@@ -0,0 +1,115 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+#include "main.h"
+
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+
+#include <libstdhl/Memory>
+
+using namespace libcjel_ir;
+
+TEST( libcjel_rt__instruction_native, XorInstruction )
+{
+    auto a = libstdhl::Memory::make< BitConstant >( 8, 0x3c );
+    auto b = libstdhl::Memory::make< BitConstant >( 8, 0x0f );
+
+    auto i = XorInstruction( a, b );
+    auto r = libcjel_rt::Instruction::execute( i );
+
+    EXPECT_TRUE( r == BitConstant( 8, 0x33 ) );
+}
+
+TEST( libcjel_rt__instruction_native, DivSignedInstruction_truncates_toward_zero )
+{
+    auto a = libstdhl::Memory::make< BitConstant >( 8, 0xfa );  // -6
+    auto b = libstdhl::Memory::make< BitConstant >( 8, 0x04 );
+
+    auto i = DivSignedInstruction( a, b );
+    auto r = libcjel_rt::Instruction::execute( i );
+
+    EXPECT_TRUE( r == BitConstant( 8, 0xff ) );  // -1
+}
+
+TEST( libcjel_rt__instruction_native, ModUnsignedInstruction )
+{
+    auto a = libstdhl::Memory::make< BitConstant >( 8, 0x17 );
+    auto b = libstdhl::Memory::make< BitConstant >( 8, 0x05 );
+
+    auto i = ModUnsignedInstruction( a, b );
+    auto r = libcjel_rt::Instruction::execute( i );
+
+    EXPECT_TRUE( r == BitConstant( 8, 0x03 ) );
+}
+
+TEST( libcjel_rt__instruction_native, AddUnsignedInstruction_wraps_at_bitsize )
+{
+    auto a = libstdhl::Memory::make< BitConstant >( 5, 0x1f );
+    auto b = libstdhl::Memory::make< BitConstant >( 5, 0x02 );
+
+    auto i = AddUnsignedInstruction( a, b );
+    auto r = libcjel_rt::Instruction::execute( i );
+
+    EXPECT_TRUE( r == BitConstant( 5, 0x01 ) );
+}
+
+TEST( libcjel_rt__instruction_native, foldable )
+{
+    auto a = libstdhl::Memory::make< BitConstant >( 8, 0x01 );
+    auto b = libstdhl::Memory::make< BitConstant >( 8, 0x02 );
+
+    auto i = AndInstruction( a, b );
+    EXPECT_TRUE( libcjel_rt::NativeEvaluator::foldable( i ) );
+    EXPECT_TRUE( libcjel_rt::NativeEvaluator::operation( i )
+                 == libcjel_rt::NativeEvaluator::Operation::AND );
+}
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
@@ -51,6 +51,7 @@
 #include <libstdhl/Memory>
 
 using namespace libcjel_ir;
+using namespace libcjel_rt_test;
 
 TEST( libcjel_rt__instruction_neq, NeqInstruction_true )
 {
@@ -122,6 +123,68 @@ TEST( libcjel_rt__instruction_neq, NeqInstruction_false_zero_64 )
     EXPECT_TRUE( r == BitConstant( 1, false ) );
 }
 
+TEST( libcjel_rt__instruction_neq, NeqInstruction_non_constant_8 )
+{
+    // the interpreter tier is disabled and the operands are loads, so the
+    // comparison is lowered by the asmjit pass and not folded
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    auto t = libstdhl::Memory::make< BitType >( 8 );
+    auto r_t = libstdhl::Memory::make< BitType >( 1 );
+
+    auto f = binary_pair( "neq_pair", t, r_t, []( const Value::Ptr& v, const Value::Ptr& w ) {
+        return libstdhl::Memory::make< NeqInstruction >( v, w );
+    } );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( r_t );
+
+    {
+        auto i = CallInstruction( f, { pair( f, t, 123, 123 ), m } );
+        EXPECT_TRUE( libcjel_rt::Instruction::execute( i, runtime ) == BitConstant( r_t, 0 ) );
+    }
+
+    {
+        auto i = CallInstruction( f, { pair( f, t, 0x0f, 0xf0 ), m } );
+        EXPECT_TRUE( libcjel_rt::Instruction::execute( i, runtime ) == BitConstant( r_t, 1 ) );
+    }
+
+    {
+        auto i = CallInstruction( f, { pair( f, t, 0, 0 ), m } );
+        EXPECT_TRUE( libcjel_rt::Instruction::execute( i, runtime ) == BitConstant( r_t, 0 ) );
+    }
+
+    {
+        auto i = CallInstruction( f, { pair( f, t, 0, 123 ), m } );
+        EXPECT_TRUE( libcjel_rt::Instruction::execute( i, runtime ) == BitConstant( r_t, 1 ) );
+    }
+}
+
+TEST( libcjel_rt__instruction_neq, NeqInstruction_non_constant_64 )
+{
+    // the interpreter tier is disabled and the operands are loads, so the
+    // comparison is lowered by the asmjit pass and not folded
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    auto t = libstdhl::Memory::make< BitType >( 64 );
+    auto r_t = libstdhl::Memory::make< BitType >( 1 );
+
+    auto f = binary_pair( "neq_pair", t, r_t, []( const Value::Ptr& v, const Value::Ptr& w ) {
+        return libstdhl::Memory::make< NeqInstruction >( v, w );
+    } );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( r_t );
+
+    {
+        auto i = CallInstruction( f, { pair( f, t, 0xdeadbeefcafe, 0xdeadbeefcafe ), m } );
+        EXPECT_TRUE( libcjel_rt::Instruction::execute( i, runtime ) == BitConstant( r_t, 0 ) );
+    }
+
+    {
+        auto i = CallInstruction( f, { pair( f, t, 0xdeadbeefcafe, 0xcafe ), m } );
+        EXPECT_TRUE( libcjel_rt::Instruction::execute( i, runtime ) == BitConstant( r_t, 1 ) );
+    }
+}
+
 //
 //  Local variables:
 //  mode: c++
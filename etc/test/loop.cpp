@@ -0,0 +1,190 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+
+#include "main.h"
+
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Intrinsic>
+#include <libcjel-ir/Scope>
+#include <libcjel-ir/Statement>
+#include <libcjel-ir/Structure>
+
+#include <libstdhl/Memory>
+
+using namespace libcjel_ir;
+using namespace libcjel_rt_test;
+
+static const auto T = libstdhl::Memory::make< BitType >( 16 );
+
+static StructureType::Ptr pair_type( const std::string& name )
+{
+    const std::vector< StructureElement > structure_args = { { T, "v" }, { T, "w" } };
+    auto structure = libstdhl::Memory::make< Structure >( name, structure_args );
+    return libstdhl::Memory::make< StructureType >( structure );
+}
+
+/**
+   intrinsic 'while( res.i != arg.w ) { res.acc += arg.v; res.i += 1 }' with
+   a counted loop over the output
+*/
+static Intrinsic::Ptr multiply( LoopStatement::Ptr& loop )
+{
+    auto s_t = pair_type( "pair" );
+    auto r_t = pair_type( "state" );
+
+    auto x0 = libstdhl::Memory::make< BitConstant >( 8, 0 );
+    auto x1 = libstdhl::Memory::make< BitConstant >( 8, 1 );
+    auto one = libstdhl::Memory::make< BitConstant >( 16, 1 );
+
+    const std::vector< Type::Ptr > f_t_i = { s_t };
+    const std::vector< Type::Ptr > f_t_o = { r_t };
+    auto f_t = libstdhl::Memory::make< RelationType >( f_t_o, f_t_i );
+
+    auto f = libstdhl::Memory::make< Intrinsic >( "multiply", f_t );
+    auto f_i = f->in( "arg", s_t );
+    auto f_o = f->out( "res", r_t );
+
+    auto scope = libstdhl::Memory::make< SequentialScope >();
+    f->setContext( scope );
+
+    auto stmt = libstdhl::Memory::make< TrivialStatement >();
+    stmt->setParent( scope );
+    scope->add( stmt );
+
+    auto w_ptr = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x1 ) );
+    auto w = stmt->add( libstdhl::Memory::make< LoadInstruction >( w_ptr ) );
+
+    loop = libstdhl::Memory::make< LoopStatement >();
+    loop->setParent( scope );
+    scope->add( loop );
+
+    auto i_ptr = loop->add( libstdhl::Memory::make< ExtractInstruction >( f_o, x0 ) );
+    auto i = loop->add( libstdhl::Memory::make< LoadInstruction >( i_ptr ) );
+    loop->add( libstdhl::Memory::make< NeqInstruction >( i, w ) );
+
+    auto body = libstdhl::Memory::make< ParallelScope >();
+    body->setParent( loop );
+    loop->addScope( body );
+
+    auto step = libstdhl::Memory::make< TrivialStatement >();
+    step->setParent( body );
+    body->add( step );
+
+    auto v_ptr = step->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x0 ) );
+    auto v = step->add( libstdhl::Memory::make< LoadInstruction >( v_ptr ) );
+    auto acc_ptr = step->add( libstdhl::Memory::make< ExtractInstruction >( f_o, x1 ) );
+    auto acc = step->add( libstdhl::Memory::make< LoadInstruction >( acc_ptr ) );
+    auto sum = step->add( libstdhl::Memory::make< AddUnsignedInstruction >( acc, v ) );
+    step->add( libstdhl::Memory::make< StoreInstruction >( sum, acc_ptr ) );
+
+    auto n_ptr = step->add( libstdhl::Memory::make< ExtractInstruction >( f_o, x0 ) );
+    auto n = step->add( libstdhl::Memory::make< LoadInstruction >( n_ptr ) );
+    auto next = step->add( libstdhl::Memory::make< AddUnsignedInstruction >( n, one ) );
+    step->add( libstdhl::Memory::make< StoreInstruction >( next, n_ptr ) );
+
+    return f;
+}
+
+TEST( libcjel_rt__loop, unrolled_loops_compute_the_same_result )
+{
+    libcjel_rt::Runtime unrolled( 1024, 0 );
+    libcjel_rt::Runtime plain( 1024, 0 );
+    plain.setLoopUnroll( 0 );
+
+    LoopStatement::Ptr loop;
+    auto f = multiply( loop );
+    const auto& s_t = f->inputs()[ 0 ]->ptr_type();
+    const auto& r_t = f->outputs()[ 0 ]->ptr_type();
+
+    const std::vector< Constant > args = { BitConstant( T, 7 ), BitConstant( T, 10 ) };
+    auto a = libstdhl::Memory::make< StructureConstant >( s_t, args );
+
+    const std::vector< Constant > res = { BitConstant( T, 10 ), BitConstant( T, 70 ) };
+    auto e = StructureConstant( r_t, res );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( r_t );
+    auto i = CallInstruction( f, { a, m } );
+
+    auto x = libcjel_rt::Instruction::execute( i, unrolled );
+    auto y = libcjel_rt::Instruction::execute( i, plain );
+
+    EXPECT_TRUE( x == e );
+    EXPECT_TRUE( y == e );
+
+    // two unrolled iterations of four bodies and two remaining iterations
+    EXPECT_EQ( *unrolled.backEdges( loop.get() ), 4 );
+    EXPECT_EQ( *plain.backEdges( loop.get() ), 10 );
+}
+
+TEST( libcjel_rt__loop, empty_loops_are_skipped )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    LoopStatement::Ptr loop;
+    auto f = multiply( loop );
+    const auto& s_t = f->inputs()[ 0 ]->ptr_type();
+    const auto& r_t = f->outputs()[ 0 ]->ptr_type();
+
+    const std::vector< Constant > args = { BitConstant( T, 7 ), BitConstant( T, 0 ) };
+    auto a = libstdhl::Memory::make< StructureConstant >( s_t, args );
+
+    const std::vector< Constant > res = { BitConstant( T, 0 ), BitConstant( T, 0 ) };
+    auto e = StructureConstant( r_t, res );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( r_t );
+    auto i = CallInstruction( f, { a, m } );
+
+    EXPECT_TRUE( libcjel_rt::Instruction::execute( i, runtime ) == e );
+    EXPECT_EQ( *runtime.backEdges( loop.get() ), 0 );
+}
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
@@ -46,6 +46,8 @@
 
 #include <libcjel-rt/libcjel-rt>
 
+#include "builder.h"
+
 #endif  // _LIBCJEL_RT_TEST_MAIN_H_
 
 //
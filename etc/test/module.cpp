@@ -0,0 +1,155 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+
+#include "main.h"
+
+#include <libcjel-rt/transform/CjelIRToAsmJitPass>
+
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Intrinsic>
+#include <libcjel-ir/Module>
+
+#include <libstdhl/Memory>
+
+using namespace libcjel_ir;
+using namespace libcjel_rt_test;
+
+using Pass = libcjel_rt::CjelIRToAsmJitPass;
+
+TEST( libcjel_rt__module, symbols_of_a_module_are_callable )
+{
+    libcjel_rt::Runtime runtime;
+
+    auto t = libstdhl::Memory::make< BitType >( 8 );
+    auto f = add_pair( t );
+
+    auto m = libstdhl::Memory::make< Module >( "module" );
+    m->add( f );
+
+    libpass::PassResult pr;
+    pr.setResult< Pass >( libstdhl::Memory::make< Pass::Data >( m, runtime ) );
+
+    Pass pass;
+    ASSERT_TRUE( pass.run( pr ) );
+
+    const auto data = pr.result< Pass >();
+    EXPECT_EQ( data->symbols().size(), 1 );
+    EXPECT_EQ( data->symbol( "undefined" ), nullptr );
+
+    void* entry = data->symbol( "add_pair" );
+    ASSERT_NE( entry, nullptr );
+
+    u8 in[ 2 ] = { 0x11, 0x22 };
+    u8 out = 0;
+
+    typedef void ( *CallableType )( void*, void* );
+    ( (CallableType)entry )( in, &out );
+
+    EXPECT_EQ( out, 0x33 );
+    EXPECT_EQ( runtime.additions(), 1 );
+}
+
+TEST( libcjel_rt__module, forwarding_callables_share_the_callee_entry )
+{
+    libcjel_rt::Runtime runtime;
+
+    auto t = libstdhl::Memory::make< BitType >( 8 );
+    auto f = add_pair( t );
+    auto g = forward( "g", f );
+    auto h = forward( "h", g );
+
+    auto m = libstdhl::Memory::make< Module >( "module" );
+    m->add( h );
+    m->add( g );
+    m->add( f );
+
+    libpass::PassResult pr;
+    pr.setResult< Pass >( libstdhl::Memory::make< Pass::Data >( m, runtime ) );
+
+    Pass pass;
+    ASSERT_TRUE( pass.run( pr ) );
+
+    const auto data = pr.result< Pass >();
+    EXPECT_EQ( data->symbol( "g" ), data->symbol( "add_pair" ) );
+    EXPECT_EQ( data->symbol( "h" ), data->symbol( "add_pair" ) );
+
+    u8 in[ 2 ] = { 0x01, 0x02 };
+    u8 out = 0;
+
+    typedef void ( *CallableType )( void*, void* );
+    ( (CallableType)data->symbol( "h" ) )( in, &out );
+
+    EXPECT_EQ( out, 0x03 );
+    EXPECT_EQ( runtime.additions(), 1 );
+}
+
+TEST( libcjel_rt__module, code_is_released_with_the_result )
+{
+    libcjel_rt::Runtime runtime;
+
+    auto t = libstdhl::Memory::make< BitType >( 8 );
+
+    auto m = libstdhl::Memory::make< Module >( "module" );
+    m->add( add_pair( t ) );
+
+    {
+        libpass::PassResult pr;
+        pr.setResult< Pass >( libstdhl::Memory::make< Pass::Data >( m, runtime ) );
+
+        Pass pass;
+        ASSERT_TRUE( pass.run( pr ) );
+        EXPECT_EQ( runtime.functions(), 1 );
+    }
+
+    EXPECT_EQ( runtime.functions(), 0 );
+}
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
@@ -0,0 +1,117 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+
+#include "main.h"
+
+#include <libcjel-rt/transform/CjelIRToAsmJitPass>
+
+#include <libcjel-ir/Constant>
+
+#include <libstdhl/Memory>
+
+using namespace libcjel_ir;
+
+using Context = libcjel_rt::CjelIRToAsmJitPass::Context;
+
+TEST( libcjel_rt__numbering, values_are_numbered_densely_in_first_seen_order )
+{
+    Context::Numbering numbering;
+
+    std::vector< BitConstant::Ptr > values;
+    for( u64 i = 0; i < 1000; i++ )
+    {
+        values.emplace_back( libstdhl::Memory::make< BitConstant >( 16, i ) );
+    }
+
+    for( u32 i = 0; i < values.size(); i++ )
+    {
+        EXPECT_EQ( numbering.find( values[ i ].get() ), Context::Numbering::NONE );
+        EXPECT_EQ( numbering.number( values[ i ].get() ), i );
+    }
+
+    EXPECT_EQ( numbering.size(), values.size() );
+
+    for( u32 i = 0; i < values.size(); i++ )
+    {
+        EXPECT_EQ( numbering.find( values[ i ].get() ), i );
+        EXPECT_EQ( numbering.number( values[ i ].get() ), i );
+    }
+}
+
+TEST( libcjel_rt__numbering, cleared_tables_keep_their_numbering )
+{
+    Context::Numbering numbering;
+    Context::ValueTable< u64 > table( numbering );
+
+    auto a = libstdhl::Memory::make< BitConstant >( 8, 1 );
+    auto b = libstdhl::Memory::make< BitConstant >( 8, 2 );
+
+    EXPECT_FALSE( table.has( a.get() ) );
+
+    u64& entry = table[ a.get() ];
+    entry = 42;
+    table[ b.get() ] = 7;
+
+    EXPECT_TRUE( table.has( a.get() ) );
+    EXPECT_EQ( table[ a.get() ], 42 );
+
+    table.erase( b.get() );
+    EXPECT_FALSE( table.has( b.get() ) );
+    EXPECT_EQ( table[ b.get() ], 0 );
+
+    table.clear();
+    EXPECT_FALSE( table.has( a.get() ) );
+    EXPECT_FALSE( table.has( b.get() ) );
+    EXPECT_EQ( table[ a.get() ], 0 );
+    EXPECT_EQ( numbering.size(), 2 );
+}
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
@@ -0,0 +1,184 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+
+#include "main.h"
+
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Intrinsic>
+#include <libcjel-ir/Scope>
+#include <libcjel-ir/Statement>
+#include <libcjel-ir/Structure>
+
+#include <libstdhl/Memory>
+
+#include <atomic>
+
+using namespace libcjel_ir;
+
+/**
+   intrinsic 'res.v := arg.v + arg.w; res.w := arg.v ^ arg.w' with both
+   statements in one parallel scope
+*/
+static Intrinsic::Ptr sum_xor( void )
+{
+    auto t = libstdhl::Memory::make< BitType >( 64 );
+    const std::vector< StructureElement > structure_args = { { t, "v" }, { t, "w" } };
+    auto structure = libstdhl::Memory::make< Structure >( "pair", structure_args );
+    auto s_t = libstdhl::Memory::make< StructureType >( structure );
+
+    auto x0 = libstdhl::Memory::make< BitConstant >( 8, 0 );
+    auto x1 = libstdhl::Memory::make< BitConstant >( 8, 1 );
+
+    const std::vector< Type::Ptr > f_t_i = { s_t };
+    const std::vector< Type::Ptr > f_t_o = { s_t };
+    auto f_t = libstdhl::Memory::make< RelationType >( f_t_o, f_t_i );
+
+    auto f = libstdhl::Memory::make< Intrinsic >( "sum_xor", f_t );
+    auto f_i = f->in( "arg", s_t );
+    auto f_o = f->out( "res", s_t );
+
+    auto scope = libstdhl::Memory::make< ParallelScope >();
+    f->setContext( scope );
+
+    for( u32 i = 0; i < 2; i++ )
+    {
+        auto stmt = libstdhl::Memory::make< TrivialStatement >();
+        stmt->setParent( scope );
+        scope->add( stmt );
+
+        auto v_ptr = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x0 ) );
+        auto v_ld = stmt->add( libstdhl::Memory::make< LoadInstruction >( v_ptr ) );
+        auto w_ptr = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x1 ) );
+        auto w_ld = stmt->add( libstdhl::Memory::make< LoadInstruction >( w_ptr ) );
+
+        Value::Ptr r;
+        if( i == 0 )
+        {
+            r = stmt->add( libstdhl::Memory::make< AddUnsignedInstruction >( v_ld, w_ld ) );
+        }
+        else
+        {
+            r = stmt->add( libstdhl::Memory::make< XorInstruction >( v_ld, w_ld ) );
+        }
+
+        auto dst = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_o, i ? x1 : x0 ) );
+        stmt->add( libstdhl::Memory::make< StoreInstruction >( r, dst ) );
+    }
+
+    return f;
+}
+
+static std::atomic< u64 > s_count( 0 );
+
+static void count( void* frame )
+{
+    s_count += *static_cast< u64* >( frame );
+}
+
+static void nested( void* frame )
+{
+    auto& pool = *static_cast< libcjel_rt::ThreadPool* >( frame );
+
+    static u64 one = 1;
+    std::vector< libcjel_rt::ThreadPool::Task > tasks( 8, { &count, &one } );
+    pool.run( tasks.data(), tasks.size() );
+}
+
+TEST( libcjel_rt__parallel, nested_forks_are_joined )
+{
+    libcjel_rt::ThreadPool pool( 3 );
+    s_count = 0;
+
+    std::vector< libcjel_rt::ThreadPool::Task > tasks( 16, { &nested, &pool } );
+    for( u32 n = 0; n < 32; n++ )
+    {
+        pool.run( tasks.data(), tasks.size() );
+    }
+
+    EXPECT_EQ( s_count, 32 * 16 * 8 );
+    EXPECT_EQ( pool.executed(), 32 * 16 * 9 );
+}
+
+TEST( libcjel_rt__parallel, forked_statements_compute_the_same_result )
+{
+    libcjel_rt::Runtime forked( 1024, 0 );
+    libcjel_rt::Runtime sequential( 1024, 0 );
+    forked.setParallelGrain( 1 );
+    sequential.setParallelGrain( 0 );
+
+    auto f = sum_xor();
+    const auto& s_t = f->inputs()[ 0 ]->ptr_type();
+    auto t = libstdhl::Memory::make< BitType >( 64 );
+
+    const std::vector< Constant > args = { BitConstant( t, 0xf0f0 ), BitConstant( t, 0x0ff0 ) };
+    auto a = libstdhl::Memory::make< StructureConstant >( s_t, args );
+
+    const std::vector< Constant > res = { BitConstant( t, 0x100e0 ), BitConstant( t, 0xff00 ) };
+    auto e = StructureConstant( s_t, res );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( s_t );
+    auto i = CallInstruction( f, { a, m } );
+
+    auto x = libcjel_rt::Instruction::execute( i, forked );
+    auto y = libcjel_rt::Instruction::execute( i, sequential );
+
+    EXPECT_TRUE( x == e );
+    EXPECT_TRUE( y == e );
+
+    if( forked.pool().workers() > 0 )
+    {
+        EXPECT_EQ( forked.pool().executed(), 2 );
+    }
+    EXPECT_EQ( sequential.pool().executed(), 0 );
+}
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
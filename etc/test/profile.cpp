@@ -0,0 +1,115 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+
+#include "main.h"
+
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Intrinsic>
+
+#include <libstdhl/Memory>
+
+using namespace libcjel_ir;
+using namespace libcjel_rt_test;
+
+TEST( libcjel_rt__profile, hot_callables_are_recompiled_without_instrumentation )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+    runtime.setRecompileThreshold( 3 );
+    auto& cache = runtime.cache();
+
+    auto t = libstdhl::Memory::make< BitType >( 16 );
+    auto f = add_pair( t );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( t );
+
+    for( u64 v = 0; v < 5; v++ )
+    {
+        auto i = CallInstruction( f, { pair( f, v, 0x0100 ), m } );
+        auto r = libcjel_rt::Instruction::execute( i, runtime );
+
+        EXPECT_TRUE( r == BitConstant( t, v + 0x0100 ) );
+
+        if( v == 1 )
+        {
+            EXPECT_EQ( *runtime.invocations( f.get() ), 2 );
+        }
+    }
+
+    // the third invocation triggers the recompilation, the profile guided
+    // code does not count anymore and the counter went away with the
+    // instrumented code
+    EXPECT_EQ( *runtime.invocations( f.get() ), 0 );
+    EXPECT_EQ( cache.replacements(), 1 );
+
+    auto i = CallInstruction( f, { pair( f, 0, 0 ), m } );
+    EXPECT_FALSE( cache.lookup( cache.key( i ) )->instrumented() );
+}
+
+TEST( libcjel_rt__profile, disabled_instrumentation_records_nothing )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+    runtime.setRecompileThreshold( 0 );
+
+    auto t = libstdhl::Memory::make< BitType >( 16 );
+    auto f = add_pair( t );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( t );
+    auto i = CallInstruction( f, { pair( f, 1, 2 ), m } );
+
+    EXPECT_TRUE( libcjel_rt::Instruction::execute( i, runtime ) == BitConstant( t, 3 ) );
+    EXPECT_TRUE( libcjel_rt::Instruction::execute( i, runtime ) == BitConstant( t, 3 ) );
+
+    EXPECT_EQ( *runtime.invocations( f.get() ), 0 );
+    EXPECT_EQ( runtime.cache().replacements(), 0 );
+}
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
@@ -0,0 +1,155 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+#include "main.h"
+
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Intrinsic>
+
+#include <libstdhl/Memory>
+
+using namespace libcjel_ir;
+using namespace libcjel_rt_test;
+
+TEST( libcjel_rt__runtime, code_is_kept_for_the_runtime_lifetime )
+{
+    libcjel_rt::Runtime runtime;
+
+    auto t = libstdhl::Memory::make< BitType >( 8 );
+    auto f = add_pair( t );
+
+    auto a = pair( f, 0x11, 0x22 );
+    auto m = libstdhl::Memory::make< AllocInstruction >( t );
+    auto i = CallInstruction( f, { a, m } );
+
+    for( u32 n = 0; n < 16; n++ )
+    {
+        auto r = libcjel_rt::Instruction::execute( i, runtime );
+        EXPECT_TRUE( r == BitConstant( t, 0x33 ) );
+    }
+
+    EXPECT_EQ( runtime.additions(), 1 );
+    EXPECT_EQ( runtime.functions(), 1 );
+    EXPECT_GE( runtime.allocatedBytes(), runtime.usedBytes() );
+}
+
+TEST( libcjel_rt__runtime, dropped_code_is_released )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    auto t = libstdhl::Memory::make< BitType >( 8 );
+    auto f = add_pair( t );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( t );
+    auto i = CallInstruction( f, { pair( f, 0x0f, 0x01 ), m } );
+
+    libcjel_rt::Instruction::execute( i, runtime );
+    EXPECT_EQ( runtime.functions(), 1 );
+
+    runtime.cache().clear();
+    EXPECT_EQ( runtime.functions(), 0 );
+}
+
+TEST( libcjel_rt__runtime, nested_calls_share_one_function )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    auto t = libstdhl::Memory::make< BitType >( 8 );
+    auto f = add_pair( t );
+    auto g = forward( "g", f );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( t );
+    auto i = CallInstruction( g, { pair( f, 0x20, 0x02 ), m } );
+
+    auto r = libcjel_rt::Instruction::execute( i, runtime );
+
+    EXPECT_TRUE( r == BitConstant( t, 0x22 ) );
+    EXPECT_EQ( runtime.additions(), 1 );
+}
+
+TEST( libcjel_rt__runtime, inlined_calls_compute_the_same_result )
+{
+    libcjel_rt::Runtime inlined( 1024, 0 );
+    libcjel_rt::Runtime called( 1024, 0 );
+    called.setInlineBudget( 0 );
+
+    EXPECT_GT( inlined.inlineBudget(), 0 );
+
+    auto t = libstdhl::Memory::make< BitType >( 16 );
+    auto f = add_pair( t );
+    auto g = forward( "g", f );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( t );
+    auto i = CallInstruction( g, { pair( f, 0x1234, 0x0101 ), m } );
+
+    auto a = libcjel_rt::Instruction::execute( i, inlined );
+    auto b = libcjel_rt::Instruction::execute( i, called );
+
+    EXPECT_TRUE( a == BitConstant( t, 0x1335 ) );
+    EXPECT_TRUE( a == b );
+    EXPECT_LE( inlined.usedBytes(), called.usedBytes() );
+}
+
+TEST( libcjel_rt__runtime, constant_operators_are_not_compiled )
+{
+    libcjel_rt::Runtime runtime;
+
+    auto a = libstdhl::Memory::make< BitConstant >( 8, 0x0f );
+    auto i = NotInstruction( a );
+
+    auto r = libcjel_rt::Instruction::execute( i, runtime );
+
+    EXPECT_TRUE( r == BitConstant( 8, 0xf0 ) );
+    EXPECT_EQ( runtime.additions(), 0 );
+    EXPECT_EQ( runtime.cache().size(), 0 );
+}
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
@@ -0,0 +1,300 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+
+#include "main.h"
+
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Intrinsic>
+#include <libcjel-ir/Scope>
+#include <libcjel-ir/Statement>
+#include <libcjel-ir/Structure>
+
+#include <libstdhl/Memory>
+
+using namespace libcjel_ir;
+using namespace libcjel_rt_test;
+
+static const std::vector< u16 > BITSIZES = { 64, 64, 64, 64, 32, 16, 8 };
+
+/**
+   intrinsic 'res := arg' over a structure of 39 bytes, which is copied with
+   vector moves and a tail of every smaller width
+*/
+static Intrinsic::Ptr copy_struct( void )
+{
+    std::vector< StructureElement > structure_args;
+    for( u32 i = 0; i < BITSIZES.size(); i++ )
+    {
+        structure_args.push_back(
+            { libstdhl::Memory::make< BitType >( BITSIZES[ i ] ), "e" + std::to_string( i ) } );
+    }
+    auto structure = libstdhl::Memory::make< Structure >( "wide", structure_args );
+    auto s_t = libstdhl::Memory::make< StructureType >( structure );
+
+    const std::vector< Type::Ptr > f_t_i = { s_t };
+    const std::vector< Type::Ptr > f_t_o = { s_t };
+    auto f_t = libstdhl::Memory::make< RelationType >( f_t_o, f_t_i );
+
+    auto f = libstdhl::Memory::make< Intrinsic >( "copy_struct", f_t );
+    auto f_i = f->in( "arg", s_t );
+    auto f_o = f->out( "res", s_t );
+
+    auto scope = libstdhl::Memory::make< ParallelScope >();
+    f->setContext( scope );
+
+    auto stmt = libstdhl::Memory::make< TrivialStatement >();
+    stmt->setParent( scope );
+    scope->add( stmt );
+
+    for( u32 i = 0; i < BITSIZES.size(); i++ )
+    {
+        auto x = libstdhl::Memory::make< BitConstant >( 8, i );
+
+        auto src = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x ) );
+        auto ld = stmt->add( libstdhl::Memory::make< LoadInstruction >( src ) );
+        auto dst = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_o, x ) );
+        stmt->add( libstdhl::Memory::make< StoreInstruction >( ld, dst ) );
+    }
+
+    return f;
+}
+
+TEST( libcjel_rt__structure, wide_structure_results_are_copied )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    auto f = copy_struct();
+    const auto& s_t = f->inputs()[ 0 ]->ptr_type();
+
+    std::vector< Constant > elements;
+    for( u32 i = 0; i < BITSIZES.size(); i++ )
+    {
+        const u64 mask = BITSIZES[ i ] < 64 ? ( (u64)1 << BITSIZES[ i ] ) - 1 : ~(u64)0;
+        elements.emplace_back( BitConstant(
+            libstdhl::Memory::make< BitType >( BITSIZES[ i ] ),
+            ( 0x0123456789abcdef + i ) & mask ) );
+    }
+    auto a = libstdhl::Memory::make< StructureConstant >( s_t, elements );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( s_t );
+    auto i = CallInstruction( f, { a, m } );
+
+    auto r = libcjel_rt::Instruction::execute( i, runtime );
+
+    EXPECT_TRUE( r == *a );
+}
+
+/**
+   intrinsic 'res := f( { v, w } )' calling 'f' of 'add_pair' with a constant
+*/
+static Intrinsic::Ptr constant_pair( const Intrinsic::Ptr& f, u64 v, u64 w )
+{
+    const auto& s_t = f->inputs()[ 0 ]->ptr_type();
+    const auto& r_t = f->outputs()[ 0 ]->ptr_type();
+
+    auto g = libstdhl::Memory::make< Intrinsic >( "constant_pair", f->ptr_type() );
+    g->in( "arg", s_t );
+    auto g_o = g->out( "res", r_t );
+
+    auto scope = libstdhl::Memory::make< ParallelScope >();
+    g->setContext( scope );
+
+    auto stmt = libstdhl::Memory::make< TrivialStatement >();
+    stmt->setParent( scope );
+    scope->add( stmt );
+
+    const std::vector< Value::Ptr > args = { pair( f, v, w ), g_o };
+    stmt->add( libstdhl::Memory::make< CallInstruction >( f, args ) );
+
+    return g;
+}
+
+TEST( libcjel_rt__structure, constant_structures_are_read_from_the_pool )
+{
+    for( u64 budget : { 0, 1024 } )
+    {
+        libcjel_rt::Runtime runtime( 1024, 0 );
+        runtime.setInlineBudget( budget );
+
+        auto t = libstdhl::Memory::make< BitType >( 32 );
+        auto f = add_pair( t );
+        auto g = constant_pair( f, 0x12345678, 0x01010101 );
+
+        auto m = libstdhl::Memory::make< AllocInstruction >( t );
+        auto i = CallInstruction( g, { pair( g, 0, 0 ), m } );
+
+        // the pooled constant is not consumed by the first invocation
+        for( u32 c = 0; c < 3; c++ )
+        {
+            auto r = libcjel_rt::Instruction::execute( i, runtime );
+            EXPECT_TRUE( r == BitConstant( t, 0x13355779 ) );
+        }
+    }
+}
+
+TEST( libcjel_rt__structure, scalar_results_keep_unstored_elements_zero )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    auto t = libstdhl::Memory::make< BitType >( 16 );
+    const std::vector< StructureElement > structure_args = { { t, "v" }, { t, "w" } };
+    auto structure = libstdhl::Memory::make< Structure >( "pair", structure_args );
+    auto s_t = libstdhl::Memory::make< StructureType >( structure );
+
+    auto x0 = libstdhl::Memory::make< BitConstant >( 8, 0 );
+    auto x1 = libstdhl::Memory::make< BitConstant >( 8, 1 );
+
+    // intrinsic 'res.w := arg.v; res.w := res.w + arg.v', its result is held
+    // in registers and 'res.v' is never stored
+    const std::vector< Type::Ptr > f_t_i = { s_t };
+    auto f_t = libstdhl::Memory::make< RelationType >( f_t_i, f_t_i );
+
+    auto f = libstdhl::Memory::make< Intrinsic >( "double_v", f_t );
+    auto f_i = f->in( "arg", s_t );
+    auto f_o = f->out( "res", s_t );
+
+    auto scope = libstdhl::Memory::make< ParallelScope >();
+    f->setContext( scope );
+
+    auto stmt = libstdhl::Memory::make< TrivialStatement >();
+    stmt->setParent( scope );
+    scope->add( stmt );
+
+    auto v_ptr = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x0 ) );
+    auto v = stmt->add( libstdhl::Memory::make< LoadInstruction >( v_ptr ) );
+    auto w_ptr = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_o, x1 ) );
+    stmt->add( libstdhl::Memory::make< StoreInstruction >( v, w_ptr ) );
+    auto w = stmt->add( libstdhl::Memory::make< LoadInstruction >( w_ptr ) );
+    auto sum = stmt->add( libstdhl::Memory::make< AddUnsignedInstruction >( w, v ) );
+    stmt->add( libstdhl::Memory::make< StoreInstruction >( sum, w_ptr ) );
+
+    const std::vector< Constant > args = { BitConstant( t, 0x1234 ), BitConstant( t, 0x5678 ) };
+    auto a = libstdhl::Memory::make< StructureConstant >( s_t, args );
+
+    const std::vector< Constant > results = { BitConstant( t, 0 ), BitConstant( t, 0x2468 ) };
+    auto expected = libstdhl::Memory::make< StructureConstant >( s_t, results );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( s_t );
+    auto i = CallInstruction( f, { a, m } );
+
+    EXPECT_TRUE( libcjel_rt::Instruction::execute( i, runtime ) == *expected );
+}
+
+
+/**
+   intrinsic 'res.v := arg.w; res.w := arg.v' over a structure of two 'type'
+   elements
+*/
+static Intrinsic::Ptr swap_pair( const Type::Ptr& type )
+{
+    const std::vector< StructureElement > structure_args = { { type, "v" }, { type, "w" } };
+    auto structure = libstdhl::Memory::make< Structure >( "pair", structure_args );
+    auto s_t = libstdhl::Memory::make< StructureType >( structure );
+
+    const std::vector< Type::Ptr > f_t_i = { s_t };
+    auto f_t = libstdhl::Memory::make< RelationType >( f_t_i, f_t_i );
+
+    auto f = libstdhl::Memory::make< Intrinsic >( "swap_pair", f_t );
+    auto f_i = f->in( "arg", s_t );
+    auto f_o = f->out( "res", s_t );
+
+    auto scope = libstdhl::Memory::make< ParallelScope >();
+    f->setContext( scope );
+
+    auto stmt = libstdhl::Memory::make< TrivialStatement >();
+    stmt->setParent( scope );
+    scope->add( stmt );
+
+    for( u32 i = 0; i < 2; i++ )
+    {
+        auto x = libstdhl::Memory::make< BitConstant >( 8, i );
+        auto y = libstdhl::Memory::make< BitConstant >( 8, 1 - i );
+
+        auto src = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x ) );
+        auto ld = stmt->add( libstdhl::Memory::make< LoadInstruction >( src ) );
+        auto dst = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_o, y ) );
+        stmt->add( libstdhl::Memory::make< StoreInstruction >( ld, dst ) );
+    }
+
+    return f;
+}
+
+TEST( libcjel_rt__structure, odd_width_elements_are_packed_at_their_byte_size )
+{
+    // a 12-bit element takes two bytes and a 2-bit element one byte, in the
+    // asmjit tier as well as in the interpreter tier
+    for( u16 bitsize : { 12, 2 } )
+    {
+        for( u64 threshold : { 0, 8 } )
+        {
+            libcjel_rt::Runtime runtime( 1024, threshold );
+
+            auto t = libstdhl::Memory::make< BitType >( bitsize );
+            auto f = swap_pair( t );
+            const auto& s_t = f->inputs()[ 0 ]->ptr_type();
+
+            const u64 v = bitsize == 12 ? 0xabc : 0x1;
+            const u64 w = bitsize == 12 ? 0x123 : 0x2;
+
+            const std::vector< Constant > results = { BitConstant( t, w ), BitConstant( t, v ) };
+            auto expected = libstdhl::Memory::make< StructureConstant >( s_t, results );
+
+            auto m = libstdhl::Memory::make< AllocInstruction >( s_t );
+            auto i = CallInstruction( f, { pair( f, t, v, w ), m } );
+
+            auto r = libcjel_rt::Instruction::execute( i, runtime );
+            EXPECT_TRUE( r == *expected ) << bitsize << "-bit, threshold " << threshold;
+            EXPECT_EQ( runtime.interpreter().interpretations(), threshold ? 1 : 0 );
+        }
+    }
+}
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
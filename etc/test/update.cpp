@@ -0,0 +1,323 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+
+#include "main.h"
+
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Intrinsic>
+#include <libcjel-ir/Scope>
+#include <libcjel-ir/Statement>
+#include <libcjel-ir/Structure>
+
+#include <libstdhl/Memory>
+
+#include <thread>
+
+using namespace libcjel_ir;
+using namespace libcjel_rt_test;
+
+/**
+   intrinsic 'res := arg.v; res := arg.w' with both statements in one
+   parallel scope
+*/
+static Intrinsic::Ptr store_twice( const Intrinsic::Ptr& f )
+{
+    const auto& s_t = f->inputs()[ 0 ]->ptr_type();
+    const auto& r_t = f->outputs()[ 0 ]->ptr_type();
+
+    auto g = libstdhl::Memory::make< Intrinsic >( "store_twice", f->ptr_type() );
+    auto g_i = g->in( "arg", s_t );
+    auto g_o = g->out( "res", r_t );
+
+    auto scope = libstdhl::Memory::make< ParallelScope >();
+    g->setContext( scope );
+
+    for( u32 i = 0; i < 2; i++ )
+    {
+        auto stmt = libstdhl::Memory::make< TrivialStatement >();
+        stmt->setParent( scope );
+        scope->add( stmt );
+
+        auto x = libstdhl::Memory::make< BitConstant >( 8, i );
+        auto ptr = stmt->add( libstdhl::Memory::make< ExtractInstruction >( g_i, x ) );
+        auto ld = stmt->add( libstdhl::Memory::make< LoadInstruction >( ptr ) );
+        stmt->add( libstdhl::Memory::make< StoreInstruction >( ld, g_o ) );
+    }
+
+    return g;
+}
+
+/**
+   intrinsic 'par { if( arg.v == arg.v ) seq { res.v := arg.v; res.v := res.v + arg.w } }'
+   with the same sequential scope on both branches
+*/
+static Intrinsic::Ptr accumulate( const Type::Ptr& type )
+{
+    const std::vector< StructureElement > structure_args = { { type, "v" }, { type, "w" } };
+    auto structure = libstdhl::Memory::make< Structure >( "pair", structure_args );
+    auto s_t = libstdhl::Memory::make< StructureType >( structure );
+
+    auto x0 = libstdhl::Memory::make< BitConstant >( 8, 0 );
+    auto x1 = libstdhl::Memory::make< BitConstant >( 8, 1 );
+
+    const std::vector< Type::Ptr > f_t_i = { s_t };
+    const std::vector< Type::Ptr > f_t_o = { s_t };
+    auto f_t = libstdhl::Memory::make< RelationType >( f_t_o, f_t_i );
+
+    auto f = libstdhl::Memory::make< Intrinsic >( "accumulate", f_t );
+    auto f_i = f->in( "arg", s_t );
+    auto f_o = f->out( "res", s_t );
+
+    auto scope = libstdhl::Memory::make< ParallelScope >();
+    f->setContext( scope );
+
+    auto branch = libstdhl::Memory::make< BranchStatement >();
+    branch->setParent( scope );
+    scope->add( branch );
+
+    auto v_ptr = branch->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x0 ) );
+    auto v = branch->add( libstdhl::Memory::make< LoadInstruction >( v_ptr ) );
+    branch->add( libstdhl::Memory::make< EquInstruction >( v, v ) );
+
+    for( u32 arm = 0; arm < 2; arm++ )
+    {
+        auto block = libstdhl::Memory::make< SequentialScope >();
+        block->setParent( branch );
+        branch->addScope( block );
+
+        auto first = libstdhl::Memory::make< TrivialStatement >();
+        first->setParent( block );
+        block->add( first );
+
+        auto a_ptr = first->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x0 ) );
+        auto a = first->add( libstdhl::Memory::make< LoadInstruction >( a_ptr ) );
+        auto r_ptr = first->add( libstdhl::Memory::make< ExtractInstruction >( f_o, x0 ) );
+        first->add( libstdhl::Memory::make< StoreInstruction >( a, r_ptr ) );
+
+        auto second = libstdhl::Memory::make< TrivialStatement >();
+        second->setParent( block );
+        block->add( second );
+
+        auto b_ptr = second->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x1 ) );
+        auto b = second->add( libstdhl::Memory::make< LoadInstruction >( b_ptr ) );
+        auto s_ptr = second->add( libstdhl::Memory::make< ExtractInstruction >( f_o, x0 ) );
+        auto s = second->add( libstdhl::Memory::make< LoadInstruction >( s_ptr ) );
+        auto r = second->add( libstdhl::Memory::make< AddUnsignedInstruction >( s, b ) );
+        second->add( libstdhl::Memory::make< StoreInstruction >( r, s_ptr ) );
+    }
+
+    return f;
+}
+
+TEST( libcjel_rt__update, concurrent_inserts_detect_conflicts )
+{
+    libcjel_rt::UpdateSet set( 64 );
+    u64 memory[ 32 ] = { 0 };
+
+    std::vector< std::thread > threads;
+    for( u32 t = 0; t < 4; t++ )
+    {
+        threads.emplace_back( [&set, &memory, t]() {
+            for( u32 i = 0; i < 32; i++ )
+            {
+                // every thread writes its own value to the last location
+                set.insert( &memory[ i ], i == 31 ? t : i, sizeof( u64 ) );
+            }
+        } );
+    }
+    for( auto& thread : threads )
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ( set.size(), 32 );
+    EXPECT_EQ( set.conflicts().size(), 3 );
+    EXPECT_FALSE( set.apply() );
+    EXPECT_EQ( memory[ 1 ], 0 );
+
+    set.clear();
+    EXPECT_TRUE( set.insert( &memory[ 1 ], 0x1ff, 1 ) );
+    EXPECT_TRUE( set.insert( &memory[ 1 ], 0xff, 1 ) );
+    EXPECT_TRUE( set.apply() );
+    EXPECT_EQ( memory[ 1 ], 0xff );
+}
+
+TEST( libcjel_rt__update, merged_sets_detect_conflicts )
+{
+    libcjel_rt::UpdateSet inner( 16 );
+    libcjel_rt::UpdateSet outer( 16 );
+    u64 memory[ 2 ] = { 0 };
+
+    EXPECT_TRUE( inner.insert( &memory[ 0 ], 1, sizeof( u64 ) ) );
+    EXPECT_TRUE( outer.insert( &memory[ 1 ], 2, sizeof( u64 ) ) );
+    EXPECT_TRUE( inner.merge( outer ) );
+    EXPECT_TRUE( outer.apply() );
+    EXPECT_EQ( memory[ 0 ], 1 );
+    EXPECT_EQ( memory[ 1 ], 2 );
+
+    EXPECT_TRUE( outer.insert( &memory[ 0 ], 3, sizeof( u64 ) ) );
+    EXPECT_FALSE( inner.merge( outer ) );
+    EXPECT_EQ( outer.conflicts().size(), 1 );
+}
+
+TEST( libcjel_rt__update, full_sets_keep_all_updates )
+{
+    libcjel_rt::UpdateSet set( 8 );
+    u64 memory[ 64 ] = { 0 };
+
+    for( u32 i = 0; i < 64; i++ )
+    {
+        EXPECT_TRUE( set.insert( &memory[ i ], i + 1, sizeof( u64 ) ) );
+    }
+
+    EXPECT_EQ( set.capacity(), 8 );
+    EXPECT_EQ( set.size(), 64 );
+
+    EXPECT_TRUE( set.insert( &memory[ 63 ], 64, sizeof( u64 ) ) );
+    EXPECT_FALSE( set.insert( &memory[ 63 ], 0, sizeof( u64 ) ) );
+    EXPECT_EQ( set.conflicts().size(), 1 );
+
+    set.clear();
+    for( u32 i = 0; i < 64; i++ )
+    {
+        EXPECT_TRUE( set.insert( &memory[ i ], i + 1, sizeof( u64 ) ) );
+    }
+    EXPECT_TRUE( set.apply() );
+
+    for( u32 i = 0; i < 64; i++ )
+    {
+        EXPECT_EQ( memory[ i ], i + 1 );
+    }
+}
+
+TEST( libcjel_rt__update, sequential_layers_are_read_by_nested_scopes )
+{
+    libcjel_rt::UpdateSet parallel( 16 );
+    libcjel_rt::UpdateSet layer( 16 );
+    libcjel_rt::UpdateSet inner( 16 );
+    u64 memory[ 2 ] = { 0 };
+
+    layer.setSequential( true );
+    layer.setOuter( &parallel );
+    EXPECT_TRUE( layer.outer() == nullptr );
+
+    EXPECT_TRUE( layer.insert( &memory[ 0 ], 1, sizeof( u64 ) ) );
+    EXPECT_TRUE( layer.insert( &memory[ 0 ], 2, sizeof( u64 ) ) );
+    EXPECT_TRUE( layer.conflicts().empty() );
+    EXPECT_EQ( layer.read( &memory[ 0 ], sizeof( u64 ), 0 ), 2 );
+
+    // a parallel scope in the layer reads the layer but not its own updates
+    inner.setOuter( &layer );
+    EXPECT_TRUE( inner.outer() == &layer );
+    EXPECT_TRUE( inner.insert( &memory[ 0 ], 3, sizeof( u64 ) ) );
+    EXPECT_EQ( inner.read( &memory[ 0 ], sizeof( u64 ), 0 ), 2 );
+    EXPECT_EQ( inner.read( &memory[ 1 ], sizeof( u64 ), 4 ), 4 );
+
+    EXPECT_TRUE( inner.merge( layer ) );
+    EXPECT_EQ( layer.read( &memory[ 0 ], sizeof( u64 ), 0 ), 3 );
+
+    EXPECT_TRUE( layer.merge( parallel ) );
+    EXPECT_TRUE( parallel.apply() );
+    EXPECT_EQ( memory[ 0 ], 3 );
+}
+
+TEST( libcjel_rt__update, sequential_scopes_see_their_own_stores )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+    runtime.setParallelUpdates( true );
+
+    auto t = libstdhl::Memory::make< BitType >( 16 );
+    auto f = accumulate( t );
+
+    const auto& s_t = f->inputs()[ 0 ]->ptr_type();
+    const std::vector< Constant > args = { BitConstant( t, 0x1200 ), BitConstant( t, 0x0034 ) };
+    auto a = libstdhl::Memory::make< StructureConstant >( s_t, args );
+
+    const std::vector< Constant > res = { BitConstant( t, 0x1234 ), BitConstant( t, 0 ) };
+    auto e = StructureConstant( s_t, res );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( s_t );
+    auto i = CallInstruction( f, { a, m } );
+
+    EXPECT_TRUE( libcjel_rt::Instruction::execute( i, runtime ) == e );
+    EXPECT_EQ( runtime.conflicts(), 0 );
+}
+
+TEST( libcjel_rt__update, parallel_stores_are_checked_for_conflicts )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+    runtime.setParallelUpdates( true );
+
+    auto t = libstdhl::Memory::make< BitType >( 16 );
+    auto f = add_pair( t );
+    auto g = store_twice( f );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( t );
+
+    auto consistent = CallInstruction( g, { pair( f, 0x1234, 0x1234 ), m } );
+    auto r = libcjel_rt::Instruction::execute( consistent, runtime );
+
+    EXPECT_TRUE( r == BitConstant( t, 0x1234 ) );
+    EXPECT_EQ( runtime.conflicts(), 0 );
+
+    auto conflicting = CallInstruction( g, { pair( f, 0x1234, 0x4321 ), m } );
+    r = libcjel_rt::Instruction::execute( conflicting, runtime );
+
+    EXPECT_TRUE( r == BitConstant( t, 0 ) );
+    EXPECT_EQ( runtime.conflicts(), 1 );
+
+    const auto locations = runtime.takeConflicts();
+    EXPECT_EQ( locations.size(), 1 );
+    EXPECT_TRUE( runtime.takeConflicts().empty() );
+}
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
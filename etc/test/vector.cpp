@@ -0,0 +1,230 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+
+#include "main.h"
+
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Intrinsic>
+#include <libcjel-ir/Scope>
+#include <libcjel-ir/Statement>
+#include <libcjel-ir/Structure>
+
+#include <libstdhl/Memory>
+
+#include <asmjit/asmjit.h>
+
+#include <cstring>
+
+using namespace libcjel_ir;
+
+enum class Lanewise
+{
+    AND,
+    OR,
+    XOR,
+    NOT,
+    ADD
+};
+
+/**
+   intrinsic 'res.r := arg.a <op> arg.b' over two values of the 'vector' type
+*/
+static Intrinsic::Ptr lanewise( const Type::Ptr& vector, Lanewise op )
+{
+    const std::vector< StructureElement > input_args = { { vector, "a" }, { vector, "b" } };
+    auto input = libstdhl::Memory::make< Structure >( "operands", input_args );
+    auto i_t = libstdhl::Memory::make< StructureType >( input );
+
+    const std::vector< StructureElement > output_args = { { vector, "r" } };
+    auto output = libstdhl::Memory::make< Structure >( "result", output_args );
+    auto o_t = libstdhl::Memory::make< StructureType >( output );
+
+    auto x0 = libstdhl::Memory::make< BitConstant >( 8, 0 );
+    auto x1 = libstdhl::Memory::make< BitConstant >( 8, 1 );
+
+    const std::vector< Type::Ptr > f_t_i = { i_t };
+    const std::vector< Type::Ptr > f_t_o = { o_t };
+    auto f_t = libstdhl::Memory::make< RelationType >( f_t_o, f_t_i );
+
+    auto f = libstdhl::Memory::make< Intrinsic >( "lanewise", f_t );
+    auto f_i = f->in( "arg", i_t );
+    auto f_o = f->out( "res", o_t );
+
+    auto scope = libstdhl::Memory::make< ParallelScope >();
+    f->setContext( scope );
+
+    auto stmt = libstdhl::Memory::make< TrivialStatement >();
+    stmt->setParent( scope );
+    scope->add( stmt );
+
+    auto a_ptr = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x0 ) );
+    auto a = stmt->add( libstdhl::Memory::make< LoadInstruction >( a_ptr ) );
+    auto b_ptr = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x1 ) );
+    auto b = stmt->add( libstdhl::Memory::make< LoadInstruction >( b_ptr ) );
+
+    Value::Ptr r;
+    switch( op )
+    {
+        case Lanewise::AND:
+        {
+            r = stmt->add( libstdhl::Memory::make< AndInstruction >( a, b ) );
+            break;
+        }
+        case Lanewise::OR:
+        {
+            r = stmt->add( libstdhl::Memory::make< OrInstruction >( a, b ) );
+            break;
+        }
+        case Lanewise::XOR:
+        {
+            r = stmt->add( libstdhl::Memory::make< XorInstruction >( a, b ) );
+            break;
+        }
+        case Lanewise::NOT:
+        {
+            r = stmt->add( libstdhl::Memory::make< NotInstruction >( a ) );
+            break;
+        }
+        case Lanewise::ADD:
+        {
+            r = stmt->add( libstdhl::Memory::make< AddUnsignedInstruction >( a, b ) );
+            break;
+        }
+    }
+
+    auto r_ptr = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_o, x0 ) );
+    stmt->add( libstdhl::Memory::make< StoreInstruction >( r, r_ptr ) );
+
+    return f;
+}
+
+/**
+   checks the compiled 'op' on 'lanes' elements of 'bitsize' bits lane by
+   lane against the same operation on the host
+*/
+static void expect_lanewise( u16 bitsize, u32 lanes, Lanewise op )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    auto element = libstdhl::Memory::make< BitType >( bitsize );
+    auto vector = libstdhl::Memory::make< VectorType >( element, lanes );
+
+    libcjel_rt::CallableUnit callable( lanewise( vector, op ), runtime );
+    auto kernel = callable.as< void( void*, const void* ) >();
+    ASSERT_TRUE( kernel != nullptr );
+
+    const u32 lane_size = bitsize / 8;
+    const u32 byte_size = lane_size * lanes;
+
+    std::vector< u8 > operands( 2 * byte_size );
+    for( u32 i = 0; i < operands.size(); i++ )
+    {
+        // lanes with carries into their upper bytes and with overflows
+        operands[ i ] = (u8)( i * 0x9d + 0x35 );
+    }
+
+    std::vector< u8 > result( byte_size, 0 );
+    kernel( result.data(), operands.data() );
+
+    std::vector< u8 > expected( byte_size, 0 );
+    for( u32 lane = 0; lane < lanes; lane++ )
+    {
+        u64 x = 0;
+        u64 y = 0;
+        memcpy( &x, &operands[ lane * lane_size ], lane_size );
+        memcpy( &y, &operands[ byte_size + lane * lane_size ], lane_size );
+
+        const u64 r = op == Lanewise::AND
+                          ? x & y
+                          : op == Lanewise::OR
+                                ? x | y
+                                : op == Lanewise::XOR ? x ^ y : op == Lanewise::NOT ? ~x : x + y;
+
+        memcpy( &expected[ lane * lane_size ], &r, lane_size );
+    }
+
+    EXPECT_TRUE( result == expected ) << bitsize << "-bit x " << lanes << " lanes, op "
+                                      << static_cast< int >( op );
+}
+
+static const std::vector< Lanewise > OPERATIONS = {
+    Lanewise::AND, Lanewise::OR, Lanewise::XOR, Lanewise::NOT, Lanewise::ADD };
+
+TEST( libcjel_rt__vector, xmm_lanes_use_legacy_sse_forms )
+{
+    // 16 byte vectors are held in XMM registers and lowered without VEX
+    for( u16 bitsize : { 8, 16, 32, 64 } )
+    {
+        for( auto op : OPERATIONS )
+        {
+            expect_lanewise( bitsize, 128 / bitsize, op );
+        }
+    }
+}
+
+TEST( libcjel_rt__vector, ymm_lanes_use_vex_forms )
+{
+    // 32 byte vectors are only held in YMM registers on AVX2 hosts
+    if( not asmjit::CpuInfo::getHost().hasFeature( asmjit::CpuInfo::kX86FeatureAVX2 ) )
+    {
+        return;
+    }
+
+    for( u16 bitsize : { 8, 16, 32, 64 } )
+    {
+        for( auto op : OPERATIONS )
+        {
+            expect_lanewise( bitsize, 256 / bitsize, op );
+        }
+    }
+}
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
@@ -0,0 +1,237 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+
+#include "main.h"
+
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Intrinsic>
+#include <libcjel-ir/Scope>
+#include <libcjel-ir/Statement>
+#include <libcjel-ir/Structure>
+
+#include <libstdhl/Memory>
+
+using namespace libcjel_ir;
+
+/**
+   intrinsic 'res := lnot( arg.v + arg.w )' over a structure of two 'type'
+   elements, the result is only zero if the carry of the lower limb reaches
+   the upper one
+*/
+static Intrinsic::Ptr lnot_sum( const Type::Ptr& type )
+{
+    const std::vector< StructureElement > structure_args = { { type, "v" }, { type, "w" } };
+    auto structure = libstdhl::Memory::make< Structure >( "wide_pair", structure_args );
+    auto s_t = libstdhl::Memory::make< StructureType >( structure );
+    auto r_t = libstdhl::Memory::make< BitType >( 1 );
+
+    auto x0 = libstdhl::Memory::make< BitConstant >( 8, 0 );
+    auto x1 = libstdhl::Memory::make< BitConstant >( 8, 1 );
+
+    const std::vector< Type::Ptr > f_t_i = { s_t };
+    const std::vector< Type::Ptr > f_t_o = { r_t };
+    auto f_t = libstdhl::Memory::make< RelationType >( f_t_o, f_t_i );
+
+    auto f = libstdhl::Memory::make< Intrinsic >( "lnot_sum", f_t );
+    auto f_i = f->in( "arg", s_t );
+    auto f_o = f->out( "res", r_t );
+
+    auto scope = libstdhl::Memory::make< ParallelScope >();
+    f->setContext( scope );
+
+    auto stmt = libstdhl::Memory::make< TrivialStatement >();
+    stmt->setParent( scope );
+    scope->add( stmt );
+
+    auto v_ptr = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x0 ) );
+    auto v_ld = stmt->add( libstdhl::Memory::make< LoadInstruction >( v_ptr ) );
+    auto w_ptr = stmt->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x1 ) );
+    auto w_ld = stmt->add( libstdhl::Memory::make< LoadInstruction >( w_ptr ) );
+
+    auto sum = stmt->add( libstdhl::Memory::make< AddUnsignedInstruction >( v_ld, w_ld ) );
+    auto r = stmt->add( libstdhl::Memory::make< LnotInstruction >( sum ) );
+    stmt->add( libstdhl::Memory::make< StoreInstruction >( r, f_o ) );
+
+    return f;
+}
+
+static Constant lnot_sum( const Intrinsic::Ptr& f, u64 v, u64 w, libcjel_rt::Runtime& runtime )
+{
+    const auto& s_t = f->inputs()[ 0 ]->ptr_type();
+    const auto e_t = std::static_pointer_cast< BitType >( s_t->ptr_results()[ 0 ] );
+
+    const std::vector< Constant > args = { BitConstant( e_t, v ), BitConstant( e_t, w ) };
+    auto a = libstdhl::Memory::make< StructureConstant >( s_t, args );
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( f->outputs()[ 0 ]->ptr_type() );
+    auto i = CallInstruction( f, { a, m } );
+
+    return libcjel_rt::Instruction::execute( i, runtime );
+}
+
+TEST( libcjel_rt__wide, add_propagates_the_carry_across_limbs )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    for( u16 bitsize : { 65, 128, 256 } )
+    {
+        auto f = lnot_sum( libstdhl::Memory::make< BitType >( bitsize ) );
+
+        EXPECT_TRUE( lnot_sum( f, 0, 0, runtime ) == BitConstant( 1, 1 ) );
+        EXPECT_TRUE( lnot_sum( f, ~(u64)0, 1, runtime ) == BitConstant( 1, 0 ) );
+        EXPECT_TRUE( lnot_sum( f, 3, 5, runtime ) == BitConstant( 1, 0 ) );
+    }
+}
+
+TEST( libcjel_rt__wide, operators_over_wide_constants )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    auto t = libstdhl::Memory::make< BitType >( 128 );
+
+    auto a = libstdhl::Memory::make< BitConstant >( t, 0xf0f0 );
+    auto b = libstdhl::Memory::make< BitConstant >( t, 0x0ff0 );
+
+    auto add = AddUnsignedInstruction( a, b );
+    EXPECT_TRUE( libcjel_rt::Instruction::execute( add, runtime ) == BitConstant( t, 0x100e0 ) );
+
+    auto and_ = AndInstruction( a, b );
+    EXPECT_TRUE( libcjel_rt::Instruction::execute( and_, runtime ) == BitConstant( t, 0x00f0 ) );
+
+    auto xor_ = XorInstruction( a, b );
+    EXPECT_TRUE( libcjel_rt::Instruction::execute( xor_, runtime ) == BitConstant( t, 0xff00 ) );
+
+    auto equ = EquInstruction( a, b );
+    EXPECT_TRUE( libcjel_rt::Instruction::execute( equ, runtime ) == BitConstant( 1, 0 ) );
+
+    auto neq = NeqInstruction( a, b );
+    EXPECT_TRUE( libcjel_rt::Instruction::execute( neq, runtime ) == BitConstant( 1, 1 ) );
+
+    auto r_t = libstdhl::Memory::make< BitType >( 16 );
+    auto trunc = TruncationInstruction( a, r_t );
+    EXPECT_TRUE( libcjel_rt::Instruction::execute( trunc, runtime ) == BitConstant( r_t, 0xf0f0 ) );
+}
+
+/**
+   intrinsic 'if( arg.v == arg.w ) { res := arg.v + arg.v } else { res := arg.v
+   + arg.w }', the sums of both scopes are placed in the same stack slot
+*/
+static Intrinsic::Ptr select_sum( const Type::Ptr& type )
+{
+    const std::vector< StructureElement > structure_args = { { type, "v" }, { type, "w" } };
+    auto structure = libstdhl::Memory::make< Structure >( "wide_pair", structure_args );
+    auto s_t = libstdhl::Memory::make< StructureType >( structure );
+
+    auto x0 = libstdhl::Memory::make< BitConstant >( 8, 0 );
+    auto x1 = libstdhl::Memory::make< BitConstant >( 8, 1 );
+
+    const std::vector< Type::Ptr > f_t_i = { s_t };
+    const std::vector< Type::Ptr > f_t_o = { type };
+    auto f_t = libstdhl::Memory::make< RelationType >( f_t_o, f_t_i );
+
+    auto f = libstdhl::Memory::make< Intrinsic >( "select_sum", f_t );
+    auto f_i = f->in( "arg", s_t );
+    auto f_o = f->out( "res", type );
+
+    auto scope = libstdhl::Memory::make< SequentialScope >();
+    f->setContext( scope );
+
+    auto branch = libstdhl::Memory::make< BranchStatement >();
+    branch->setParent( scope );
+    scope->add( branch );
+
+    auto v_ptr = branch->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x0 ) );
+    auto v = branch->add( libstdhl::Memory::make< LoadInstruction >( v_ptr ) );
+    auto w_ptr = branch->add( libstdhl::Memory::make< ExtractInstruction >( f_i, x1 ) );
+    auto w = branch->add( libstdhl::Memory::make< LoadInstruction >( w_ptr ) );
+    branch->add( libstdhl::Memory::make< EquInstruction >( v, w ) );
+
+    for( auto operand : { v, w } )
+    {
+        auto arm = libstdhl::Memory::make< ParallelScope >();
+        arm->setParent( branch );
+        branch->addScope( arm );
+
+        auto stmt = libstdhl::Memory::make< TrivialStatement >();
+        stmt->setParent( arm );
+        arm->add( stmt );
+
+        auto sum = stmt->add( libstdhl::Memory::make< AddUnsignedInstruction >( v, operand ) );
+        stmt->add( libstdhl::Memory::make< StoreInstruction >( sum, f_o ) );
+    }
+
+    return f;
+}
+
+TEST( libcjel_rt__wide, scopes_share_the_stack_slots_of_their_values )
+{
+    libcjel_rt::Runtime runtime( 1024, 0 );
+
+    auto t = libstdhl::Memory::make< BitType >( 128 );
+    auto f = select_sum( t );
+    const auto& s_t = f->inputs()[ 0 ]->ptr_type();
+
+    auto m = libstdhl::Memory::make< AllocInstruction >( t );
+
+    for( u64 w : { 3, 5 } )
+    {
+        const std::vector< Constant > args = { BitConstant( t, 3 ), BitConstant( t, w ) };
+        auto a = libstdhl::Memory::make< StructureConstant >( s_t, args );
+
+        auto i = CallInstruction( f, { a, m } );
+        auto r = libcjel_rt::Instruction::execute( i, runtime );
+
+        EXPECT_TRUE( r == BitConstant( t, 3 + w ) );
+    }
+}
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
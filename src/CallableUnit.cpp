@@ -41,8 +41,185 @@
 
 #include "CallableUnit.h"
 
+#include <libcjel-rt/Runtime>
+#include <libcjel-rt/transform/CjelIRToAsmJitPass>
+
+#include <libcjel-ir/CallableUnit>
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Type>
+
+#include <libstdhl/Memory>
+
+#include <cassert>
+#include <cstdio>
+
 using namespace libcjel_rt;
 
+/**
+   zero constant of 'type' which stands for an argument of the entry point
+*/
+static libcjel_ir::Value::Ptr placeholder( const libcjel_ir::Type::Ptr& type )
+{
+    if( type->isStructure() )
+    {
+        std::vector< libcjel_ir::Constant > elements;
+        for( const auto& element : type->ptr_results() )
+        {
+            const std::vector< u8 > zeros( CjelIRToAsmJitPass::byte_size( *element ) );
+            elements.emplace_back( CjelIRToAsmJitPass::decode( element, zeros.data() ) );
+        }
+
+        return libstdhl::Memory::make< libcjel_ir::StructureConstant >(
+            std::static_pointer_cast< libcjel_ir::StructureType >( type ), elements );
+    }
+
+    return libstdhl::Memory::make< libcjel_ir::BitConstant >(
+        std::static_pointer_cast< libcjel_ir::BitType >( type ), 0 );
+}
+
+CallableUnit::CallableUnit( const std::shared_ptr< libcjel_ir::CallableUnit >& value )
+: CallableUnit( value, Runtime::instance() )
+{
+}
+
+CallableUnit::CallableUnit(
+    const std::shared_ptr< libcjel_ir::CallableUnit >& value, Runtime& runtime )
+: m_value( value )
+, m_code()
+, m_batch()
+{
+    // the entry point of a call with placeholder inputs takes the inputs as
+    // its arguments and returns the value of the allocated output
+    std::vector< libcjel_ir::Value::Ptr > operands;
+    for( const auto& input : value->inputs() )
+    {
+        operands.emplace_back( placeholder( input->ptr_type() ) );
+    }
+    for( const auto& output : value->outputs() )
+    {
+        operands.emplace_back(
+            libstdhl::Memory::make< libcjel_ir::AllocInstruction >( output->ptr_type() ) );
+    }
+
+    auto call = libstdhl::Memory::make< libcjel_ir::CallInstruction >( value, operands );
+
+    CjelIRToAsmJitPass x;
+    CjelIRToAsmJitPass::Context c( runtime );
+    c.setInstrumented( false );
+
+    void* entry = x.compile( *call, c );
+    m_code = std::make_shared< CodeCache::Code >( runtime, entry, c.functions() );
+
+    if( value->outputs().size() == 1 )
+    {
+        CjelIRToAsmJitPass::Context b( runtime );
+        b.setInstrumented( false );
+
+        void* batch = x.compile_batch( *call, b );
+        m_batch = std::make_shared< CodeCache::Code >( runtime, batch, b.functions() );
+    }
+}
+
+const std::shared_ptr< libcjel_ir::CallableUnit >& CallableUnit::value( void ) const
+{
+    return m_value;
+}
+
+void* CallableUnit::entry( void ) const
+{
+    return m_code->entry();
+}
+
+void* CallableUnit::entry( const std::vector< Parameter >& parameters ) const
+{
+    const auto mismatch = [&]( const char* reason ) -> void* {
+        fprintf(
+            stderr,
+            "signature does not match callable '%s': %s\n",
+            m_value->name().c_str(),
+            reason );
+        return nullptr;
+    };
+
+    if( m_value->outputs().size() != 1 )
+    {
+        return mismatch( "exactly one output is supported" );
+    }
+
+    const auto& result = m_value->outputs()[ 0 ]->type();
+    const u32 size = CjelIRToAsmJitPass::byte_size( result );
+    u32 argument = 1;
+
+    if( CjelIRToAsmJitPass::returned_in_register( result ) )
+    {
+        const Parameter& returned = parameters[ 0 ];
+
+        if( returned.pointer or returned.size != size or
+            ( result.isBit() and not returned.integral ) )
+        {
+            return mismatch( "result type" );
+        }
+    }
+    else
+    {
+        if( parameters[ 0 ].size != 0 or parameters.size() < 2 or not parameters[ 1 ].pointer )
+        {
+            return mismatch( "result is written through a leading 'out' pointer" );
+        }
+        argument++;
+    }
+
+    if( parameters.size() - argument != m_value->inputs().size() )
+    {
+        return mismatch( "number of arguments" );
+    }
+
+    for( const auto& input : m_value->inputs() )
+    {
+        const Parameter& parameter = parameters[ argument++ ];
+        const auto& type = input->type();
+
+        if( CjelIRToAsmJitPass::passed_in_register( type ) )
+        {
+            if( not parameter.integral or parameter.size != CjelIRToAsmJitPass::byte_size( type ) )
+            {
+                return mismatch( "bit inputs are passed as integral values of their byte size" );
+            }
+        }
+        else if( not parameter.pointer )
+        {
+            return mismatch( "structure and wide inputs are passed as pointers" );
+        }
+    }
+
+    return entry();
+}
+
+void CallableUnit::execute(
+    u64 count, void* output, u64 stride, const std::vector< Stream >& inputs ) const
+{
+    if( not m_batch or inputs.size() != m_value->inputs().size() )
+    {
+        fprintf(
+            stderr,
+            "unsupported batch of callable '%s' with %lu inputs!\n",
+            m_value->name().c_str(),
+            inputs.size() );
+        assert( 0 );
+        return;
+    }
+
+    // output stream first, the layout matches the streams of the pass
+    std::vector< Stream > streams;
+    streams.reserve( inputs.size() + 1 );
+    streams.emplace_back( Stream{ output, stride } );
+    streams.insert( streams.end(), inputs.begin(), inputs.end() );
+
+    auto batch = reinterpret_cast< void ( * )( u64, const void* ) >( m_batch->entry() );
+    batch( count, streams.data() );
+}
+
 //
 //  Local variables:
 //  mode: c++
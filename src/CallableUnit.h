@@ -40,15 +40,33 @@
 //
 
 /**
-   @brief    TODO
+   @brief    handle of a natively compiled callable
 
-   TODO
+   The handle owns the code of one intrinsic or function, compiled without
+   instrumentation, and shares it between its copies. The last copy releases
+   the code in the JIT runtime. 'as' returns the entry point as a raw function
+   pointer of the C++ signature 'R( Args... )' after checking it against the
+   IR signature, so applications call the code without marshalling:
+
+   - every input is one argument, bit values of up to one word are passed as
+     integral values of their byte size and all other values as pointers to
+     their encoding
+   - a result of 1, 2, 4 or 8 bytes is returned as a value of that size, and
+     otherwise the signature is 'void( void* out, Args... )' and the result
+     is written to 'out'
+
+   'execute' evaluates a callable with one output over whole arrays of
+   encoded inputs in one call, the loop over the elements is compiled code.
 */
 
 #ifndef _LIBCJEL_RT_CALLABLE_UNIT_H_
 #define _LIBCJEL_RT_CALLABLE_UNIT_H_
 
 #include <libcjel-rt/CjelRT>
+#include <libcjel-rt/CodeCache>
+
+#include <type_traits>
+#include <vector>
 
 namespace libcjel_ir
 {
@@ -58,8 +76,97 @@ namespace libcjel_ir
 
 namespace libcjel_rt
 {
+    class Runtime;
+
     class CallableUnit : public CjelRT
     {
+      public:
+        CallableUnit( const std::shared_ptr< libcjel_ir::CallableUnit >& value );
+
+        CallableUnit(
+            const std::shared_ptr< libcjel_ir::CallableUnit >& value, Runtime& runtime );
+
+        const std::shared_ptr< libcjel_ir::CallableUnit >& value( void ) const;
+
+        void* entry( void ) const;
+
+        /**
+           entry point as 'Signature', or a null pointer if the signature
+           does not match the one of the callable
+        */
+        template < typename Signature >
+        Signature* as( void ) const
+        {
+            return reinterpret_cast< Signature* >( entry( Traits< Signature >::parameters() ) );
+        }
+
+        /**
+           array of encoded values, the element 'i' is at 'base + i * stride',
+           which describes arrays of structures as well as structures of
+           arrays
+        */
+        struct Stream
+        {
+            const void* base;
+            u64 stride;
+        };
+
+        /**
+           evaluates the callable for 'count' elements of the 'inputs' and
+           writes the results to 'output' at a distance of 'stride' bytes
+        */
+        void execute(
+            u64 count, void* output, u64 stride, const std::vector< Stream >& inputs ) const;
+
+      private:
+        /**
+           C++ parameter or result type, 'size' is zero for 'void'
+        */
+        struct Parameter
+        {
+            u1 pointer;
+            u1 integral;
+            u32 size;
+        };
+
+        template < typename T >
+        static Parameter parameter( void )
+        {
+            static_assert(
+                std::is_void< T >::value or std::is_pointer< T >::value or
+                    std::is_integral< T >::value or std::is_trivially_copyable< T >::value,
+                "parameters are passed as values or pointers" );
+
+            using Stored = typename std::conditional< std::is_void< T >::value, u8, T >::type;
+
+            return Parameter{ std::is_pointer< T >::value,
+                std::is_integral< T >::value,
+                std::is_void< T >::value ? 0u : static_cast< u32 >( sizeof( Stored ) ) };
+        }
+
+        template < typename Signature >
+        struct Traits;
+
+        template < typename Result, typename... Arguments >
+        struct Traits< Result( Arguments... ) >
+        {
+            static_assert(
+                not std::is_pointer< Result >::value, "results are returned by value or 'out'" );
+
+            /**
+               result followed by all arguments
+            */
+            static std::vector< Parameter > parameters( void )
+            {
+                return { parameter< Result >(), parameter< Arguments >()... };
+            }
+        };
+
+        void* entry( const std::vector< Parameter >& parameters ) const;
+
+        std::shared_ptr< libcjel_ir::CallableUnit > m_value;
+        CodeCache::Code::Ptr m_code;
+        CodeCache::Code::Ptr m_batch;
     };
 }
 
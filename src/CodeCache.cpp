@@ -0,0 +1,504 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+#include "CodeCache.h"
+
+#include <libcjel-rt/Runtime>
+
+#include <libcjel-ir/CallableUnit>
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Type>
+#include <libcjel-ir/Value>
+
+#include <cassert>
+#include <unordered_set>
+
+using namespace libcjel_rt;
+
+//
+// CodeCache::Code
+//
+
+CodeCache::Code::Code( Runtime& runtime,
+    void* entry,
+    const std::vector< void* >& functions,
+    u1 instrumented,
+    const std::vector< std::shared_ptr< void > >& counters )
+: m_runtime( runtime )
+, m_entry( entry )
+, m_functions( functions )
+, m_counters( counters )
+, m_instrumented( instrumented )
+, m_retired( false )
+{
+}
+
+CodeCache::Code::~Code( void )
+{
+    for( auto function : m_functions )
+    {
+        m_runtime.release( function );
+    }
+
+    if( not m_counters.empty() )
+    {
+        m_counters.clear();
+        m_runtime.prune();
+    }
+}
+
+void* CodeCache::Code::entry( void ) const
+{
+    return m_entry;
+}
+
+u1 CodeCache::Code::instrumented( void ) const
+{
+    return m_instrumented;
+}
+
+u1 CodeCache::Code::retire( void )
+{
+    return m_instrumented and not m_retired.exchange( true );
+}
+
+//
+// CodeCache::Key
+//
+
+CodeCache::Key::Key( u64 hash, const std::string& shape, const std::vector< Body >& bodies )
+: m_hash( hash )
+, m_shape( shape )
+, m_bodies( bodies )
+{
+}
+
+u64 CodeCache::Key::hash( void ) const
+{
+    return m_hash;
+}
+
+u1 CodeCache::Key::operator==( const Key& other ) const
+{
+    if( m_hash != other.m_hash or m_shape != other.m_shape
+        or m_bodies.size() != other.m_bodies.size() )
+    {
+        return false;
+    }
+
+    for( std::size_t i = 0; i < m_bodies.size(); i++ )
+    {
+        // memoized bodies of the same callee are shared, so a hit only
+        // compares the full shapes of structurally equal callees
+        if( m_bodies[ i ] != other.m_bodies[ i ]
+            and m_bodies[ i ]->text != other.m_bodies[ i ]->text )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//
+// CodeCache
+//
+
+CodeCache::CodeCache( Runtime& runtime, std::size_t capacity )
+: m_runtime( runtime )
+, m_capacity( capacity )
+, m_hits( 0 )
+, m_misses( 0 )
+, m_evictions( 0 )
+, m_replacements( 0 )
+{
+    assert( m_capacity > 0 );
+}
+
+CodeCache::~CodeCache( void )
+{
+    clear();
+}
+
+Runtime& CodeCache::runtime( void )
+{
+    return m_runtime;
+}
+
+CodeCache::Code::Ptr CodeCache::lookup( const Key& key )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    auto result = m_entries.find( key );
+    if( result == m_entries.end() )
+    {
+        m_misses++;
+        return nullptr;
+    }
+
+    m_hits++;
+    m_lru.splice( m_lru.begin(), m_lru, result->second );
+    return result->second->second;
+}
+
+CodeCache::Code::Ptr CodeCache::insert( const Key& key,
+    void* entry,
+    const std::vector< void* >& functions,
+    u1 instrumented,
+    const std::vector< std::shared_ptr< void > >& counters )
+{
+    auto code = std::make_shared< Code >( m_runtime, entry, functions, instrumented, counters );
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    auto result = m_entries.find( key );
+    if( result != m_entries.end() )
+    {
+        // a concurrent execution already cached this shape, the fresh code is
+        // released as soon as the caller drops it
+        return result->second->second;
+    }
+
+    m_lru.emplace_front( key, code );
+    m_entries.emplace( key, m_lru.begin() );
+
+    while( m_lru.size() > m_capacity )
+    {
+        evict();
+    }
+
+    return code;
+}
+
+CodeCache::Code::Ptr CodeCache::replace(
+    const Key& key, void* entry, const std::vector< void* >& functions )
+{
+    auto code = std::make_shared< Code >( m_runtime, entry, functions );
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    auto result = m_entries.find( key );
+    if( result != m_entries.end() )
+    {
+        result->second->second = code;
+        m_lru.splice( m_lru.begin(), m_lru, result->second );
+    }
+    else
+    {
+        // the previous code was evicted in the meantime
+        m_lru.emplace_front( key, code );
+        m_entries.emplace( key, m_lru.begin() );
+
+        while( m_lru.size() > m_capacity )
+        {
+            evict();
+        }
+    }
+
+    m_replacements++;
+    return code;
+}
+
+void CodeCache::clear( void )
+{
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+
+        m_entries.clear();
+        m_lru.clear();
+    }
+
+    std::lock_guard< std::mutex > lock( m_bodies_lock );
+    m_bodies.clear();
+}
+
+std::size_t CodeCache::size( void )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+    return m_lru.size();
+}
+
+std::size_t CodeCache::capacity( void ) const
+{
+    return m_capacity;
+}
+
+void CodeCache::setCapacity( std::size_t capacity )
+{
+    assert( capacity > 0 );
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    m_capacity = capacity;
+
+    while( m_lru.size() > m_capacity )
+    {
+        evict();
+    }
+}
+
+u64 CodeCache::hits( void ) const
+{
+    return m_hits;
+}
+
+u64 CodeCache::misses( void ) const
+{
+    return m_misses;
+}
+
+u64 CodeCache::evictions( void ) const
+{
+    return m_evictions;
+}
+
+u64 CodeCache::replacements( void ) const
+{
+    return m_replacements;
+}
+
+std::size_t CodeCache::bodies( void )
+{
+    std::lock_guard< std::mutex > lock( m_bodies_lock );
+    return m_bodies.size();
+}
+
+void CodeCache::evict( void )
+{
+    assert( not m_lru.empty() );
+
+    // code which is still executed by someone else stays alive until the
+    // last reference to it is dropped
+    m_entries.erase( m_lru.back().first );
+    m_lru.pop_back();
+    m_evictions++;
+
+    prune();
+}
+
+void CodeCache::prune( void )
+{
+    std::lock_guard< std::mutex > lock( m_bodies_lock );
+
+    // a body only held by the memo belongs to no cached key, it is computed
+    // again for the next key of its callable
+    for( auto it = m_bodies.begin(); it != m_bodies.end(); )
+    {
+        if( it->second.second.use_count() == 1 or it->second.first.expired() )
+        {
+            it = m_bodies.erase( it );
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+//
+// structural key
+//
+
+static inline u64 combine( u64 seed, u64 value )
+{
+    return seed ^ ( value + 0x9e3779b97f4a7c15 + ( seed << 6 ) + ( seed >> 2 ) );
+}
+
+static inline void put( std::string& shape, u64 value )
+{
+    shape.append( reinterpret_cast< const char* >( &value ), sizeof( value ) );
+}
+
+static inline void put( std::string& shape, const std::string& text )
+{
+    put( shape, text.size() );
+    shape.append( text );
+}
+
+static inline void put( std::string& shape, const libcjel_ir::Type& type )
+{
+    put( shape, type.description() );
+}
+
+static void put_callable(
+    std::string& shape,
+    libcjel_ir::Value& callable,
+    std::unordered_set< libcjel_ir::Value* >& visiting )
+{
+    using namespace libcjel_ir;
+
+    put( shape, callable.id() );
+    put( shape, callable.type() );
+
+    if( not visiting.emplace( &callable ).second )
+    {
+        // recursive call, the body is already part of the shape
+        return;
+    }
+
+    std::unordered_map< Value*, u64 > ordinal;
+
+    callable.iterate( Traversal::PREORDER, [&]( Value& node ) {
+        ordinal.emplace( &node, ordinal.size() );
+        put( shape, node.id() );
+
+        if( isa< Reference >( node ) or isa< Constant >( node ) )
+        {
+            put( shape, node.type() );
+        }
+
+        if( not isa< libcjel_ir::Instruction >( node ) )
+        {
+            return;
+        }
+
+        put( shape, node.type() );
+
+        const auto& operands = static_cast< libcjel_ir::Instruction& >( node ).operands();
+        put( shape, operands.size() );
+
+        for( auto operand : operands )
+        {
+            put( shape, operand->id() );
+
+            if( isa< Constant >( operand ) )
+            {
+                // constants inside a body are encoded as immediates
+                put( shape, operand->type() );
+                put( shape, operand->name() );
+            }
+            else if( isa< libcjel_ir::CallableUnit >( operand ) )
+            {
+                put_callable( shape, *operand, visiting );
+            }
+            else
+            {
+                auto result = ordinal.find( operand.get() );
+                if( result != ordinal.end() )
+                {
+                    put( shape, result->second );
+                }
+                else
+                {
+                    put( shape, operand->type() );
+                }
+            }
+        }
+    } );
+
+    visiting.erase( &callable );
+}
+
+CodeCache::Key::Body CodeCache::body( const std::shared_ptr< libcjel_ir::Value >& callable )
+{
+    {
+        std::lock_guard< std::mutex > lock( m_bodies_lock );
+
+        auto result = m_bodies.find( callable.get() );
+        if( result != m_bodies.end() and result->second.first.lock() == callable )
+        {
+            return result->second.second;
+        }
+    }
+
+    std::unordered_set< libcjel_ir::Value* > visiting;
+    auto shape = std::make_shared< Key::Shape >();
+    put_callable( shape->text, *callable, visiting );
+    shape->hash = std::hash< std::string >()( shape->text );
+
+    std::lock_guard< std::mutex > lock( m_bodies_lock );
+
+    // a freed callee may hand its address to a new one, the weak reference
+    // tells them apart
+    auto& entry = m_bodies[ callable.get() ];
+    if( entry.first.lock() != callable )
+    {
+        entry = { callable, shape };
+    }
+
+    return entry.second;
+}
+
+CodeCache::Key CodeCache::key( libcjel_ir::Instruction& value )
+{
+    using namespace libcjel_ir;
+
+    std::string shape;
+    std::vector< Key::Body > bodies;
+
+    put( shape, value.id() );
+    put( shape, value.type() );
+    put( shape, value.operands().size() );
+
+    for( auto operand : value.operands() )
+    {
+        put( shape, operand->id() );
+
+        if( isa< libcjel_ir::CallableUnit >( operand ) )
+        {
+            bodies.emplace_back( body( operand ) );
+        }
+        else
+        {
+            put( shape, operand->type() );
+        }
+    }
+
+    u64 hash = std::hash< std::string >()( shape );
+    for( const auto& body : bodies )
+    {
+        hash = combine( hash, body->hash );
+    }
+
+    return Key( hash, shape, bodies );
+}
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
@@ -0,0 +1,256 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+/**
+   @brief    process-wide cache of JIT compiled callables
+
+   Instructions are keyed by their structural shape (opcode, operand types,
+   bit widths and callee body), so repeated executions of the same shape skip
+   the lowering, the register allocation and the runtime registration and only
+   pay for the native call. The shape of a callee body is computed once and
+   memoized for as long as the callee is alive.
+*/
+
+#ifndef _LIBCJEL_RT_CODE_CACHE_H_
+#define _LIBCJEL_RT_CODE_CACHE_H_
+
+#include <libcjel-rt/CjelRT>
+
+#include <libstdhl/Type>
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace libcjel_ir
+{
+    class Value;
+    class Instruction;
+}
+
+namespace libcjel_rt
+{
+    class Runtime;
+
+    class CodeCache : public CjelRT
+    {
+      public:
+        class Code
+        {
+          public:
+            using Ptr = std::shared_ptr< Code >;
+
+            /**
+               'counters' are the profile counters incremented by the
+               'functions', they live at least as long as the code
+            */
+            Code(
+                Runtime& runtime,
+                void* entry,
+                const std::vector< void* >& functions,
+                u1 instrumented = false,
+                const std::vector< std::shared_ptr< void > >& counters = {} );
+
+            ~Code( void );
+
+            void* entry( void ) const;
+
+            /**
+               true if the code increments the profile counters of the runtime
+            */
+            u1 instrumented( void ) const;
+
+            /**
+               claims the recompilation of instrumented code, returns true for
+               exactly one caller
+            */
+            u1 retire( void );
+
+          private:
+            Runtime& m_runtime;
+            void* m_entry;
+            std::vector< void* > m_functions;
+            std::vector< std::shared_ptr< void > > m_counters;
+            u1 m_instrumented;
+            std::atomic< u1 > m_retired;
+        };
+
+        /**
+           structural key of an executable instruction, the hash only selects
+           the bucket and the shapes are compared on every lookup
+        */
+        class Key
+        {
+          public:
+            struct Shape
+            {
+                u64 hash;
+                std::string text;
+            };
+
+            using Body = std::shared_ptr< const Shape >;
+
+            Key( u64 hash, const std::string& shape, const std::vector< Body >& bodies = {} );
+
+            u64 hash( void ) const;
+
+            u1 operator==( const Key& other ) const;
+
+            struct Hash
+            {
+                std::size_t operator()( const Key& key ) const
+                {
+                    return key.hash();
+                }
+            };
+
+          private:
+            u64 m_hash;
+            std::string m_shape;
+            std::vector< Body > m_bodies;
+        };
+
+        CodeCache( Runtime& runtime, std::size_t capacity = 1024 );
+
+        ~CodeCache( void );
+
+        Runtime& runtime( void );
+
+        /**
+           returns the cached code for 'key' or a null pointer on a miss
+        */
+        Code::Ptr lookup( const Key& key );
+
+        /**
+           takes ownership of the 'functions' already added to the runtime
+           and returns the cached code for 'key', which is an earlier inserted
+           one if a concurrent compilation of the same shape won the race
+        */
+        Code::Ptr insert(
+            const Key& key,
+            void* entry,
+            const std::vector< void* >& functions,
+            u1 instrumented = false,
+            const std::vector< std::shared_ptr< void > >& counters = {} );
+
+        /**
+           atomically replaces the cached code for 'key' by the 'functions'
+           already added to the runtime, executions of the previous code keep
+           it alive until they return
+        */
+        Code::Ptr replace( const Key& key, void* entry, const std::vector< void* >& functions );
+
+        void clear( void );
+
+        std::size_t size( void );
+
+        std::size_t capacity( void ) const;
+
+        void setCapacity( std::size_t capacity );
+
+        u64 hits( void ) const;
+
+        u64 misses( void ) const;
+
+        u64 evictions( void ) const;
+
+        u64 replacements( void ) const;
+
+        /**
+           number of callables whose body shape is memoized for keys
+        */
+        std::size_t bodies( void );
+
+        /**
+           structural key of an executable instruction, constant operands
+           contribute only by their type because they are passed as inputs
+           to the compiled code
+        */
+        Key key( libcjel_ir::Instruction& value );
+
+      private:
+        void evict( void );
+
+        /**
+           drops the memoized bodies which no cached key refers to anymore
+        */
+        void prune( void );
+
+        Key::Body body( const std::shared_ptr< libcjel_ir::Value >& callable );
+
+      private:
+        Runtime& m_runtime;
+
+        std::mutex m_mutex;
+        std::size_t m_capacity;
+
+        std::list< std::pair< Key, Code::Ptr > > m_lru;
+        std::unordered_map< Key, std::list< std::pair< Key, Code::Ptr > >::iterator, Key::Hash >
+            m_entries;
+
+        std::mutex m_bodies_lock;
+        std::unordered_map< libcjel_ir::Value*,
+            std::pair< std::weak_ptr< libcjel_ir::Value >, Key::Body > >
+            m_bodies;
+
+        std::atomic< u64 > m_hits;
+        std::atomic< u64 > m_misses;
+        std::atomic< u64 > m_evictions;
+        std::atomic< u64 > m_replacements;
+    };
+}
+
+#endif  // _LIBCJEL_RT_CODE_CACHE_H_
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
@@ -41,6 +41,8 @@
 
 #include "Instruction.h"
 
+#include <libcjel-rt/Runtime>
+#include <libcjel-rt/execute/NativeEvaluator>
 #include <libcjel-rt/transform/CjelIRToAsmJitPass>
 
 #include <libcjel-ir/Constant>
@@ -55,26 +57,79 @@ using namespace libcjel_ir;
 
 libcjel_ir::Constant libcjel_rt::Instruction::execute( libcjel_ir::Instruction& value )
 {
-    fprintf( stderr, "%s:%i: %s\n", __FILE__, __LINE__, __FUNCTION__ );
+    return execute( value, libcjel_rt::Runtime::instance() );
+}
 
-    libcjel_rt::CjelIRToAsmJitPass::Context c;
-    libcjel_rt::CjelIRToAsmJitPass x;
+libcjel_ir::Constant libcjel_rt::Instruction::execute(
+    libcjel_ir::Instruction& value, libcjel_rt::Runtime& runtime )
+{
+    if( not isa< CallInstruction >( value ) and not isa< OperatorInstruction >( value ) )
+    {
+        fprintf( stderr, "%s:%i: unimplemented instruction to be executed\n", __FILE__, __LINE__ );
+
+        assert( 0 );
+        return VoidConstant();
+    }
 
-    if( isa< CallInstruction >( value ) )
+    if( libcjel_rt::NativeEvaluator::foldable( value ) )
     {
-        return x.execute( static_cast< CallInstruction& >( value ), c );
+        return libcjel_rt::NativeEvaluator::execute( static_cast< OperatorInstruction& >( value ) );
     }
-    else if( isa< OperatorInstruction >( value ) )
+
+    auto& cache = runtime.cache();
+    const auto key = cache.key( value );
+
+    if( isa< CallInstruction >( value ) and not runtime.parallelUpdates() and
+        runtime.interpreter().cold( key.hash(), static_cast< CallInstruction& >( value ) ) )
     {
-        return x.execute( static_cast< OperatorInstruction& >( value ), c );
+        return runtime.interpreter().execute( static_cast< CallInstruction& >( value ) );
     }
-    else
+
+    libcjel_rt::CjelIRToAsmJitPass x;
+
+    auto code = cache.lookup( key );
+
+    if( not code )
     {
-        fprintf( stderr, "%s:%i: unimplemented instruction to be executed\n", __FILE__, __LINE__ );
+        fprintf( stderr, "%s:%i: %s\n", __FILE__, __LINE__, __FUNCTION__ );
 
-        assert( 0 );
-        return VoidConstant();
+        libcjel_rt::CjelIRToAsmJitPass::Context c( runtime );
+        void* entry = nullptr;
+
+        if( isa< CallInstruction >( value ) )
+        {
+            entry = x.compile( static_cast< CallInstruction& >( value ), c );
+        }
+        else
+        {
+            c.setInstrumented( false );
+            entry = x.compile( static_cast< OperatorInstruction& >( value ), c );
+        }
+
+        code = cache.insert( key, entry, c.functions(), c.isInstrumented(), c.counters() );
     }
+
+    const auto result = x.invoke( code->entry(), value );
+
+    if( code->instrumented() )
+    {
+        auto& call = static_cast< CallInstruction& >( value );
+        const u64 invocations = *runtime.invocations( call.callee().get() );
+
+        if( invocations >= runtime.recompileThreshold() and code->retire() )
+        {
+            // the instrumented code keeps serving concurrent executions until
+            // the profile guided code replaces it in the cache
+            libcjel_rt::CjelIRToAsmJitPass::Context c( runtime );
+            c.setInstrumented( false );
+            c.setProfile( invocations );
+
+            void* entry = x.compile( call, c );
+            cache.replace( key, entry, c.functions() );
+        }
+    }
+
+    return result;
 }
 
 //
@@ -58,10 +58,14 @@ namespace libcjel_ir
 
 namespace libcjel_rt
 {
+    class Runtime;
+
     class Instruction : public CjelRT
     {
       public:
         static libcjel_ir::Constant execute( libcjel_ir::Instruction& value );
+
+        static libcjel_ir::Constant execute( libcjel_ir::Instruction& value, Runtime& runtime );
     };
 }
 
@@ -0,0 +1,367 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+#include "Runtime.h"
+
+#include <libstdhl/Log>
+
+#include <cassert>
+
+using namespace libcjel_rt;
+
+Runtime::Runtime( std::size_t cache_capacity, u64 threshold )
+: m_jit()
+, m_functions( 0 )
+, m_additions( 0 )
+, m_inline_budget( 32 )
+, m_parallel_grain( 256 )
+, m_parallel_updates( false )
+, m_conflicts( 0 )
+, m_loop_unroll( 4 )
+, m_if_conversion_budget( 8 )
+, m_recompile_threshold( 1024 )
+, m_interpreter( threshold )
+, m_pool()
+, m_cache( *this, cache_capacity )
+{
+}
+
+Runtime::~Runtime( void )
+{
+    m_cache.clear();
+}
+
+Runtime& Runtime::instance( void )
+{
+    static Runtime runtime;
+    return runtime;
+}
+
+asmjit::JitRuntime& Runtime::jit( void )
+{
+    return m_jit;
+}
+
+CodeCache& Runtime::cache( void )
+{
+    return m_cache;
+}
+
+Interpreter& Runtime::interpreter( void )
+{
+    return m_interpreter;
+}
+
+ThreadPool& Runtime::pool( void )
+{
+    return m_pool;
+}
+
+void* Runtime::add( asmjit::CodeHolder& code )
+{
+    void* function = nullptr;
+
+    asmjit::Error err = m_jit.add( &function, &code );
+    if( err )
+    {
+        fprintf( stderr, "asmjit: %s\n", asmjit::DebugUtils::errorAsString( err ) );
+        assert( 0 );
+        return nullptr;
+    }
+
+    m_functions++;
+    m_additions++;
+    return function;
+}
+
+void Runtime::release( void* function )
+{
+    if( not function )
+    {
+        return;
+    }
+
+    asmjit::Error err = m_jit.release( function );
+    if( err )
+    {
+        fprintf( stderr, "asmjit: %s\n", asmjit::DebugUtils::errorAsString( err ) );
+        assert( 0 );
+        return;
+    }
+
+    assert( m_functions > 0 );
+    m_functions--;
+}
+
+u64 Runtime::functions( void ) const
+{
+    return m_functions;
+}
+
+u64 Runtime::additions( void ) const
+{
+    return m_additions;
+}
+
+u64 Runtime::inlineBudget( void ) const
+{
+    return m_inline_budget;
+}
+
+void Runtime::setInlineBudget( u64 budget )
+{
+    m_inline_budget = budget;
+}
+
+u64 Runtime::parallelGrain( void ) const
+{
+    return m_parallel_grain;
+}
+
+void Runtime::setParallelGrain( u64 grain )
+{
+    m_parallel_grain = grain;
+}
+
+u64 Runtime::loopUnroll( void ) const
+{
+    return m_loop_unroll;
+}
+
+void Runtime::setLoopUnroll( u64 factor )
+{
+    m_loop_unroll = factor;
+}
+
+u64 Runtime::ifConversionBudget( void ) const
+{
+    return m_if_conversion_budget;
+}
+
+void Runtime::setIfConversionBudget( u64 budget )
+{
+    m_if_conversion_budget = budget;
+}
+
+u64 Runtime::recompileThreshold( void ) const
+{
+    return m_recompile_threshold;
+}
+
+void Runtime::setRecompileThreshold( u64 threshold )
+{
+    m_recompile_threshold = threshold;
+}
+
+static Runtime::Counter counter(
+    std::unordered_map< const void*, std::weak_ptr< std::atomic< u64 > > >& counters,
+    const void* key )
+{
+    auto& entry = counters[ key ];
+
+    auto result = entry.lock();
+    if( not result )
+    {
+        result = std::make_shared< std::atomic< u64 > >( 0 );
+        entry = result;
+    }
+
+    return result;
+}
+
+Runtime::Counter Runtime::invocations( const void* callable )
+{
+    std::lock_guard< std::mutex > guard( m_counter_lock );
+    return counter( m_invocations, callable );
+}
+
+Runtime::Counter Runtime::loopEntries( const void* loop )
+{
+    std::lock_guard< std::mutex > guard( m_counter_lock );
+    return counter( m_loop_entries, loop );
+}
+
+Runtime::Counter Runtime::backEdges( const void* loop )
+{
+    std::lock_guard< std::mutex > guard( m_counter_lock );
+    return counter( m_back_edges, loop );
+}
+
+Runtime::BranchCounter Runtime::branchCounts( const void* branch )
+{
+    std::lock_guard< std::mutex > guard( m_counter_lock );
+
+    auto& entry = m_branch_counts[ branch ];
+
+    auto counts = entry.lock();
+    if( not counts )
+    {
+        counts = std::make_shared< std::array< std::atomic< u64 >, 2 > >();
+        counts->at( 0 ) = 0;
+        counts->at( 1 ) = 0;
+        entry = counts;
+    }
+
+    return counts;
+}
+
+template < typename Counters >
+static void erase_expired( Counters& counters )
+{
+    for( auto it = counters.begin(); it != counters.end(); )
+    {
+        if( it->second.expired() )
+        {
+            it = counters.erase( it );
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void Runtime::prune( void )
+{
+    std::lock_guard< std::mutex > guard( m_counter_lock );
+
+    // the address of a freed IR node may be taken by a new one, which
+    // starts with fresh counters once the code of the old one is gone
+    erase_expired( m_invocations );
+    erase_expired( m_loop_entries );
+    erase_expired( m_back_edges );
+    erase_expired( m_branch_counts );
+}
+
+u1 Runtime::parallelUpdates( void ) const
+{
+    return m_parallel_updates;
+}
+
+void Runtime::setParallelUpdates( u1 enabled )
+{
+    m_parallel_updates = enabled;
+}
+
+UpdateSet* Runtime::acquire( std::size_t capacity )
+{
+    {
+        std::lock_guard< std::mutex > guard( m_update_lock );
+
+        for( auto it = m_update_sets.begin(); it != m_update_sets.end(); ++it )
+        {
+            if( ( *it )->capacity() >= capacity )
+            {
+                UpdateSet* set = it->release();
+                m_update_sets.erase( it );
+                return set;
+            }
+        }
+    }
+
+    return new UpdateSet( capacity );
+}
+
+u1 Runtime::commit( UpdateSet* set, UpdateSet* outer )
+{
+    assert( set );
+
+    const u1 consistent = set->conflicts().empty();
+
+    if( not consistent )
+    {
+        m_conflicts += set->conflicts().size();
+    }
+    else if( outer )
+    {
+        // conflicts with the enclosing scope are reported by its commit
+        set->merge( *outer );
+    }
+    else
+    {
+        set->apply();
+    }
+
+    std::lock_guard< std::mutex > guard( m_update_lock );
+
+    m_conflict_locations.insert(
+        m_conflict_locations.end(), set->conflicts().begin(), set->conflicts().end() );
+
+    set->clear();
+    m_update_sets.emplace_back( set );
+
+    return consistent;
+}
+
+u64 Runtime::conflicts( void ) const
+{
+    return m_conflicts;
+}
+
+std::vector< void* > Runtime::takeConflicts( void )
+{
+    std::lock_guard< std::mutex > guard( m_update_lock );
+
+    std::vector< void* > locations;
+    locations.swap( m_conflict_locations );
+    return locations;
+}
+
+std::size_t Runtime::usedBytes( void ) const
+{
+    return m_jit.getMemMgr()->getUsedBytes();
+}
+
+std::size_t Runtime::allocatedBytes( void ) const
+{
+    return m_jit.getMemMgr()->getAllocatedBytes();
+}
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
@@ -0,0 +1,285 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+/**
+   @brief    long-lived executable-memory manager of compiled code
+
+   A runtime owns one JitRuntime for its whole lifetime. All compiled
+   functions are registered at it, so its virtual memory manager packs many
+   small functions into shared executable blocks instead of mapping fresh
+   pages per evaluation. Functions are handed back through
+   JitRuntime::release as soon as the last code handle referencing them is
+   dropped.
+
+   Cold calls are served by the interpreter tier of the runtime and only
+   compiled once they turn hot.
+*/
+
+#ifndef _LIBCJEL_RT_RUNTIME_H_
+#define _LIBCJEL_RT_RUNTIME_H_
+
+#include <libcjel-rt/CjelRT>
+#include <libcjel-rt/CodeCache>
+#include <libcjel-rt/execute/Interpreter>
+#include <libcjel-rt/execute/ThreadPool>
+#include <libcjel-rt/execute/UpdateSet>
+
+#include <libstdhl/Type>
+
+#include <asmjit/asmjit.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace libcjel_rt
+{
+    class Runtime : public CjelRT
+    {
+      public:
+        /**
+           'threshold' is the number of interpreted invocations of a callable
+           before it is promoted to compiled code, see 'Interpreter'
+        */
+        Runtime( std::size_t cache_capacity = 1024, u64 threshold = 8 );
+
+        ~Runtime( void );
+
+        /**
+           default runtime used by 'Instruction::execute'
+        */
+        static Runtime& instance( void );
+
+        asmjit::JitRuntime& jit( void );
+
+        CodeCache& cache( void );
+
+        Interpreter& interpreter( void );
+
+        ThreadPool& pool( void );
+
+        /**
+           relocates the finalized code of 'code' into the executable memory
+           of this runtime and returns its entry point
+        */
+        void* add( asmjit::CodeHolder& code );
+
+        void release( void* function );
+
+        /**
+           number of functions currently living in executable memory
+        */
+        u64 functions( void ) const;
+
+        /**
+           total number of functions ever added to this runtime
+        */
+        u64 additions( void ) const;
+
+        /**
+           maximum number of instructions of an intrinsic body which gets
+           inlined at its call sites, '0' disables inlining
+        */
+        u64 inlineBudget( void ) const;
+
+        void setInlineBudget( u64 budget );
+
+        /**
+           minimum number of instructions of a statement of a parallel scope
+           before it is forked as a job to the thread pool, '0' compiles all
+           parallel scopes sequentially
+        */
+        u64 parallelGrain( void ) const;
+
+        void setParallelGrain( u64 grain );
+
+        /**
+           number of loop bodies per iteration of unrolled counted loops,
+           '0' and '1' disable unrolling
+        */
+        u64 loopUnroll( void ) const;
+
+        void setLoopUnroll( u64 factor );
+
+        /**
+           maximum number of instructions of a scope of a branch statement
+           which is compiled to conditional moves instead of jumps, '0'
+           disables if-conversion
+        */
+        u64 ifConversionBudget( void ) const;
+
+        void setIfConversionBudget( u64 budget );
+
+        /**
+           number of invocations of instrumented compiled code of a callable
+           before it is compiled again using the recorded counters and
+           without instrumentation, '0' disables the instrumentation
+        */
+        u64 recompileThreshold( void ) const;
+
+        void setRecompileThreshold( u64 threshold );
+
+        /**
+           profile counters are owned by the code which increments them, a
+           counter is shared by all code of the same IR node and dropped
+           with the last one of it, see 'prune'
+        */
+        using Counter = std::shared_ptr< std::atomic< u64 > >;
+
+        using BranchCounter = std::shared_ptr< std::array< std::atomic< u64 >, 2 > >;
+
+        /**
+           counter of the invocations of the compiled callable 'callable',
+           including its inlined instances, see 'backEdges' for
+           synchronization
+        */
+        Counter invocations( const void* callable );
+
+        /**
+           counter of the executions of the compiled loop 'loop', its average
+           trip count is the ratio of its back-edges to its entries
+        */
+        Counter loopEntries( const void* loop );
+
+        /**
+           counter of the taken back-edges of the compiled loop 'loop', the
+           compiled code increments it without synchronization, so it is
+           approximate while a loop runs in forked statements
+        */
+        Counter backEdges( const void* loop );
+
+        /**
+           counters of the compiled branch statement 'branch', the first one
+           counts the executions of its first scope and the second one all
+           executions of the statement, see 'backEdges' for synchronization
+        */
+        BranchCounter branchCounts( const void* branch );
+
+        /**
+           forgets the counters which no code refers to anymore, called
+           whenever compiled code is released
+        */
+        void prune( void );
+
+        /**
+           true if the stores of parallel scopes are collected in update sets
+           and applied at the end of the scope, calls are compiled right away
+           in this mode as the interpreter tier stores in place
+        */
+        u1 parallelUpdates( void ) const;
+
+        void setParallelUpdates( u1 enabled );
+
+        /**
+           cleared update set of at least 'capacity' locations for one
+           execution of a parallel scope
+        */
+        UpdateSet* acquire( std::size_t capacity );
+
+        /**
+           merges 'set' into 'outer' or applies it to memory if there is no
+           enclosing set and releases it, returns false and records the
+           locations if the updates of 'set' conflict
+        */
+        u1 commit( UpdateSet* set, UpdateSet* outer );
+
+        /**
+           total number of conflicting updates reported by 'commit'
+        */
+        u64 conflicts( void ) const;
+
+        /**
+           locations of the conflicting updates reported by 'commit' since
+           the previous call
+        */
+        std::vector< void* > takeConflicts( void );
+
+        std::size_t usedBytes( void ) const;
+
+        std::size_t allocatedBytes( void ) const;
+
+      private:
+        asmjit::JitRuntime m_jit;
+
+        std::atomic< u64 > m_functions;
+        std::atomic< u64 > m_additions;
+        std::atomic< u64 > m_inline_budget;
+        std::atomic< u64 > m_parallel_grain;
+        std::atomic< u1 > m_parallel_updates;
+        std::atomic< u64 > m_conflicts;
+        std::atomic< u64 > m_loop_unroll;
+        std::atomic< u64 > m_if_conversion_budget;
+        std::atomic< u64 > m_recompile_threshold;
+
+        std::mutex m_counter_lock;
+        std::unordered_map< const void*, std::weak_ptr< std::atomic< u64 > > > m_invocations;
+        std::unordered_map< const void*, std::weak_ptr< std::atomic< u64 > > > m_loop_entries;
+        std::unordered_map< const void*, std::weak_ptr< std::atomic< u64 > > > m_back_edges;
+        std::unordered_map< const void*, std::weak_ptr< std::array< std::atomic< u64 >, 2 > > >
+            m_branch_counts;
+
+        std::mutex m_update_lock;
+        std::vector< std::unique_ptr< UpdateSet > > m_update_sets;
+        std::vector< void* > m_conflict_locations;
+
+        Interpreter m_interpreter;
+
+        ThreadPool m_pool;
+
+        CodeCache m_cache;
+    };
+}
+
+#endif  // _LIBCJEL_RT_RUNTIME_H_
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
@@ -0,0 +1,445 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+#include "Interpreter.h"
+
+#include <libcjel-rt/execute/NativeEvaluator>
+#include <libcjel-rt/transform/CjelIRToAsmJitPass>
+
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Intrinsic>
+#include <libcjel-ir/Scope>
+#include <libcjel-ir/Statement>
+#include <libcjel-ir/Type>
+#include <libcjel-ir/Value>
+
+#include <libstdhl/Log>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <memory>
+
+using namespace libcjel_ir;
+using namespace libcjel_rt;
+
+/**
+   values of one interpreted call, bit values are held as host words and all
+   pointer-like values (references, allocations, extractions) as addresses
+   into frame owned memory which is laid out as by the asmjit tier
+*/
+class Interpreter::Frame
+{
+  public:
+    u8* allocate( Value& value )
+    {
+        const u32 size = std::max( CjelIRToAsmJitPass::byte_size( value.type() ), 1u );
+
+        m_memory.emplace_back( new u8[ size ]() );
+        m_addresses[&value ] = m_memory.back().get();
+        return m_memory.back().get();
+    }
+
+    void bind( Value& value, u8* address )
+    {
+        m_addresses[&value ] = address;
+    }
+
+    void assign( Value& value, u64 word )
+    {
+        m_words[&value ] = word;
+    }
+
+    u8* address( Value& value )
+    {
+        auto result = m_addresses.find( &value );
+        if( result != m_addresses.end() )
+        {
+            return result->second;
+        }
+
+        if( not isa< Constant >( value ) )
+        {
+            fprintf(
+                stderr,
+                "%s:%i: no address for '%s'\n",
+                __FILE__,
+                __LINE__,
+                value.label().c_str() );
+            assert( 0 );
+            return nullptr;
+        }
+
+        u8* buffer = allocate( value );
+        CjelIRToAsmJitPass::encode( value, buffer );
+        return buffer;
+    }
+
+    u64 word( Value& value )
+    {
+        if( isa< BitConstant >( value ) )
+        {
+            return static_cast< BitConstant& >( value ).value().value();
+        }
+
+        auto result = m_words.find( &value );
+        if( result == m_words.end() )
+        {
+            fprintf(
+                stderr, "%s:%i: no word for '%s'\n", __FILE__, __LINE__, value.label().c_str() );
+            assert( 0 );
+            return 0;
+        }
+
+        return result->second;
+    }
+
+  private:
+    std::vector< std::unique_ptr< u8[] > > m_memory;
+    std::unordered_map< Value*, u8* > m_addresses;
+    std::unordered_map< Value*, u64 > m_words;
+};
+
+static inline u1 is_word( const Type& type )
+{
+    return type.isBit() and type.bitsize() >= 1 and type.bitsize() <= 64;
+}
+
+Interpreter::Interpreter( u64 threshold )
+: m_lock()
+, m_profiles()
+, m_threshold( threshold )
+, m_interpretations( 0 )
+, m_promotions( 0 )
+{
+}
+
+u64 Interpreter::threshold( void ) const
+{
+    return m_threshold;
+}
+
+void Interpreter::setThreshold( u64 threshold )
+{
+    m_threshold = threshold;
+}
+
+u1 Interpreter::cold( std::size_t key, CallInstruction& value )
+{
+    std::lock_guard< std::mutex > guard( m_lock );
+
+    auto result = m_profiles.find( key );
+    if( result == m_profiles.end() )
+    {
+        const Profile profile = { 0, interpretable( *value.callee() ), false };
+        result = m_profiles.emplace( key, profile ).first;
+    }
+
+    Profile& profile = result->second;
+
+    if( not profile.interpretable )
+    {
+        return false;
+    }
+
+    if( profile.invocations < m_threshold )
+    {
+        profile.invocations++;
+        return true;
+    }
+
+    if( not profile.promoted )
+    {
+        profile.promoted = true;
+        m_promotions++;
+    }
+
+    return false;
+}
+
+u64 Interpreter::invocations( std::size_t key ) const
+{
+    std::lock_guard< std::mutex > guard( m_lock );
+
+    auto result = m_profiles.find( key );
+    return result != m_profiles.end() ? result->second.invocations : 0;
+}
+
+u64 Interpreter::interpretations( void ) const
+{
+    return m_interpretations;
+}
+
+u64 Interpreter::promotions( void ) const
+{
+    return m_promotions;
+}
+
+void Interpreter::clear( void )
+{
+    std::lock_guard< std::mutex > guard( m_lock );
+    m_profiles.clear();
+}
+
+u1 Interpreter::interpretable( Value& callable )
+{
+    std::unordered_set< Value* > visiting;
+    return interpretable( callable, visiting );
+}
+
+u1 Interpreter::interpretable( Value& callable, std::unordered_set< Value* >& visiting )
+{
+    if( not isa< Intrinsic >( callable ) )
+    {
+        return false;
+    }
+
+    auto& intrinsic = static_cast< Intrinsic& >( callable );
+    if( not intrinsic.context() or not visiting.emplace( &callable ).second )
+    {
+        // no body or recursive call
+        return false;
+    }
+
+    u1 result = true;
+
+    intrinsic.context()->iterate( Traversal::PREORDER, [&]( Value& node ) {
+        if( not result )
+        {
+            return;
+        }
+
+        if( isa< Statement >( node ) and not isa< TrivialStatement >( node ) )
+        {
+            result = false;
+        }
+        else if( isa< CallInstruction >( node ) )
+        {
+            result = interpretable( *static_cast< CallInstruction& >( node ).callee(), visiting );
+        }
+        else if( isa< libcjel_ir::Instruction >( node ) )
+        {
+            result = interpretable( static_cast< libcjel_ir::Instruction& >( node ) );
+        }
+    } );
+
+    visiting.erase( &callable );
+    return result;
+}
+
+u1 Interpreter::interpretable( libcjel_ir::Instruction& value )
+{
+    if( isa< NopInstruction >( value ) or isa< AllocInstruction >( value ) )
+    {
+        return true;
+    }
+
+    if( isa< ExtractInstruction >( value ) )
+    {
+        return value.operand( 0 )->type().isStructure() and
+               isa< BitConstant >( value.operand( 1 ) );
+    }
+
+    if( isa< LoadInstruction >( value ) )
+    {
+        return is_word( value.type() );
+    }
+
+    if( isa< StoreInstruction >( value ) )
+    {
+        return is_word( value.operand( 0 )->type() );
+    }
+
+    if( NativeEvaluator::operation( value ) == NativeEvaluator::Operation::UNSUPPORTED or
+        not is_word( value.type() ) )
+    {
+        return false;
+    }
+
+    for( auto operand : value.operands() )
+    {
+        if( not is_word( operand->type() ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+Constant Interpreter::execute( CallInstruction& value )
+{
+    assert( isa< Intrinsic >( value.callee() ) );
+
+    Frame frame;
+    u8* result = nullptr;
+
+    std::vector< u8* > arguments;
+    for( u32 i = 1; i < value.operands().size(); i++ )
+    {
+        auto& operand = *value.operand( i );
+
+        if( isa< AllocInstruction >( operand ) )
+        {
+            u8* buffer = frame.allocate( operand );
+            result = result ? result : buffer;
+        }
+
+        arguments.emplace_back( frame.address( operand ) );
+    }
+
+    run( static_cast< Intrinsic& >( *value.callee() ), arguments, frame );
+    m_interpretations++;
+
+    if( not result )
+    {
+        return VoidConstant();
+    }
+
+    return CjelIRToAsmJitPass::decode( value.ptr_type(), result );
+}
+
+void Interpreter::call( CallInstruction& value, Frame& frame )
+{
+    std::vector< u8* > arguments;
+    for( u32 i = 1; i < value.operands().size(); i++ )
+    {
+        arguments.emplace_back( frame.address( *value.operand( i ) ) );
+    }
+
+    run( static_cast< Intrinsic& >( *value.callee() ), arguments, frame );
+}
+
+void Interpreter::run( Intrinsic& callable, const std::vector< u8* >& arguments, Frame& frame )
+{
+    u32 i = 0;
+
+    for( auto param : callable.inputs() )
+    {
+        frame.bind( *param, arguments[ i++ ] );
+    }
+
+    for( auto param : callable.outputs() )
+    {
+        frame.bind( *param, arguments[ i++ ] );
+    }
+
+    assert( i == arguments.size() );
+
+    callable.context()->iterate( Traversal::PREORDER, [&]( Value& node ) {
+        if( isa< libcjel_ir::Instruction >( node ) )
+        {
+            step( static_cast< libcjel_ir::Instruction& >( node ), frame );
+        }
+    } );
+}
+
+void Interpreter::step( libcjel_ir::Instruction& value, Frame& frame )
+{
+    if( isa< CallInstruction >( value ) )
+    {
+        call( static_cast< CallInstruction& >( value ), frame );
+    }
+    else if( isa< ExtractInstruction >( value ) )
+    {
+        auto base = value.operand( 0 );
+        const u64 index = static_cast< BitConstant& >( *value.operand( 1 ) ).value().value();
+
+        assert( index < base->type().results().size() );
+
+        const u32 offset = CjelIRToAsmJitPass::byte_offset( base->type(), index );
+        frame.bind( value, frame.address( *base ) + offset );
+    }
+    else if( isa< LoadInstruction >( value ) )
+    {
+        u64 word = 0;
+        memcpy(
+            &word,
+            frame.address( *value.operand( 0 ) ),
+            CjelIRToAsmJitPass::byte_size( value.type() ) );
+
+        frame.assign( value, word & NativeEvaluator::mask( value.type().bitsize() ) );
+    }
+    else if( isa< StoreInstruction >( value ) )
+    {
+        auto src = value.operand( 0 );
+        const u64 word = frame.word( *src );
+
+        memcpy(
+            frame.address( *value.operand( 1 ) ),
+            &word,
+            CjelIRToAsmJitPass::byte_size( src->type() ) );
+    }
+    else if( isa< AllocInstruction >( value ) )
+    {
+        frame.allocate( value );
+    }
+    else if( isa< NopInstruction >( value ) )
+    {
+        // nothing to do
+    }
+    else
+    {
+        const auto operation = NativeEvaluator::operation( value );
+        assert( operation != NativeEvaluator::Operation::UNSUPPORTED );
+
+        auto lhs = value.operand( 0 );
+        const u64 rhs =
+            NativeEvaluator::unary( operation ) ? 0 : frame.word( *value.operand( 1 ) );
+
+        const u64 result = NativeEvaluator::evaluate(
+            operation, frame.word( *lhs ), rhs, lhs->type().bitsize(), value.type().bitsize() );
+
+        frame.assign( value, result );
+    }
+}
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
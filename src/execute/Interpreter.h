@@ -0,0 +1,159 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+/**
+   @brief    IR-walking interpreter tier for cold callables
+
+   Calls are interpreted directly on the IR over a plain byte memory model
+   until their callable shape has been invoked 'threshold' times. After that
+   the shape is reported as hot and gets promoted to the asmjit tier, where
+   it is compiled once and served from the code cache.
+*/
+
+#ifndef _LIBCJEL_RT_INTERPRETER_H_
+#define _LIBCJEL_RT_INTERPRETER_H_
+
+#include <libcjel-rt/CjelRT>
+
+#include <libstdhl/Type>
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace libcjel_ir
+{
+    class Value;
+    class Constant;
+    class Intrinsic;
+    class Instruction;
+    class CallInstruction;
+}
+
+namespace libcjel_rt
+{
+    class Interpreter : public CjelRT
+    {
+      public:
+        Interpreter( u64 threshold );
+
+        /**
+           number of interpreted invocations of a callable shape before it is
+           promoted to the asmjit tier, '0' disables the interpreter tier
+        */
+        u64 threshold( void ) const;
+
+        void setThreshold( u64 threshold );
+
+        /**
+           accounts an invocation of 'value' whose shape is identified by
+           'key' and returns true as long as it shall stay in the interpreter
+           tier
+        */
+        u1 cold( std::size_t key, libcjel_ir::CallInstruction& value );
+
+        u64 invocations( std::size_t key ) const;
+
+        /**
+           total number of interpreted calls
+        */
+        u64 interpretations( void ) const;
+
+        /**
+           total number of callable shapes promoted to the asmjit tier
+        */
+        u64 promotions( void ) const;
+
+        void clear( void );
+
+        /**
+           true if all instructions of 'callable' are handled by the
+           interpreter, control-flow statements are left to the asmjit tier
+        */
+        static u1 interpretable( libcjel_ir::Value& callable );
+
+        libcjel_ir::Constant execute( libcjel_ir::CallInstruction& value );
+
+      private:
+        class Frame;
+
+        static u1 interpretable(
+            libcjel_ir::Value& callable, std::unordered_set< libcjel_ir::Value* >& visiting );
+
+        static u1 interpretable( libcjel_ir::Instruction& instruction );
+
+        static void call( libcjel_ir::CallInstruction& value, Frame& frame );
+
+        static void run(
+            libcjel_ir::Intrinsic& callable, const std::vector< u8* >& arguments, Frame& frame );
+
+        static void step( libcjel_ir::Instruction& value, Frame& frame );
+
+        struct Profile
+        {
+            u64 invocations;
+            u1 interpretable;
+            u1 promoted;
+        };
+
+        mutable std::mutex m_lock;
+        std::unordered_map< std::size_t, Profile > m_profiles;
+
+        std::atomic< u64 > m_threshold;
+        std::atomic< u64 > m_interpretations;
+        std::atomic< u64 > m_promotions;
+    };
+}
+
+#endif  // _LIBCJEL_RT_INTERPRETER_H_
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
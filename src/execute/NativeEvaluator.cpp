@@ -0,0 +1,293 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+#include "NativeEvaluator.h"
+
+#include <libcjel-ir/Constant>
+#include <libcjel-ir/Instruction>
+#include <libcjel-ir/Type>
+#include <libcjel-ir/Value>
+
+#include <libstdhl/Log>
+
+#include <cassert>
+
+using namespace libcjel_ir;
+using namespace libcjel_rt;
+
+NativeEvaluator::Operation NativeEvaluator::operation( Value& value )
+{
+    if( isa< AndInstruction >( value ) )
+    {
+        return Operation::AND;
+    }
+    else if( isa< OrInstruction >( value ) )
+    {
+        return Operation::OR;
+    }
+    else if( isa< XorInstruction >( value ) )
+    {
+        return Operation::XOR;
+    }
+    else if( isa< NotInstruction >( value ) )
+    {
+        return Operation::NOT;
+    }
+    else if( isa< LnotInstruction >( value ) )
+    {
+        return Operation::LNOT;
+    }
+    else if( isa< AddUnsignedInstruction >( value ) )
+    {
+        return Operation::ADD_UNSIGNED;
+    }
+    else if( isa< AddSignedInstruction >( value ) )
+    {
+        return Operation::ADD_SIGNED;
+    }
+    else if( isa< DivSignedInstruction >( value ) )
+    {
+        return Operation::DIV_SIGNED;
+    }
+    else if( isa< ModUnsignedInstruction >( value ) )
+    {
+        return Operation::MOD_UNSIGNED;
+    }
+    else if( isa< EquInstruction >( value ) )
+    {
+        return Operation::EQU;
+    }
+    else if( isa< NeqInstruction >( value ) )
+    {
+        return Operation::NEQ;
+    }
+    else if( isa< ZeroExtendInstruction >( value ) )
+    {
+        return Operation::ZERO_EXTEND;
+    }
+    else if( isa< TruncationInstruction >( value ) )
+    {
+        return Operation::TRUNCATION;
+    }
+
+    return Operation::UNSUPPORTED;
+}
+
+u1 NativeEvaluator::unary( Operation operation )
+{
+    return operation == Operation::NOT or
+           operation == Operation::LNOT or
+           operation == Operation::ZERO_EXTEND or
+           operation == Operation::TRUNCATION;
+}
+
+u1 NativeEvaluator::foldable( Value& value )
+{
+    const auto op = operation( value );
+    if( op == Operation::UNSUPPORTED or not value.type().isBit() or value.type().bitsize() > 64 )
+    {
+        return false;
+    }
+
+    const auto& instr = static_cast< libcjel_ir::Instruction& >( value );
+    const u32 arity = unary( op ) ? 1 : 2;
+
+    if( instr.operands().size() < arity )
+    {
+        return false;
+    }
+
+    for( u32 i = 0; i < arity; i++ )
+    {
+        const auto& operand = instr.operands()[ i ];
+        if( not isa< BitConstant >( operand ) or operand->type().bitsize() > 64 )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+u64 NativeEvaluator::mask( u64 bitsize )
+{
+    return bitsize >= 64 ? ~( (u64)0 ) : ( ( (u64)1 << bitsize ) - 1 );
+}
+
+static inline i64 sign_extend( u64 word, u64 bitsize )
+{
+    if( bitsize >= 64 )
+    {
+        return (i64)word;
+    }
+
+    const u64 sign = (u64)1 << ( bitsize - 1 );
+    return (i64)( ( ( word & NativeEvaluator::mask( bitsize ) ) ^ sign ) - sign );
+}
+
+u64 NativeEvaluator::evaluate(
+    Operation operation, u64 lhs, u64 rhs, u64 bitsize, u64 result_bitsize )
+{
+    lhs &= mask( bitsize );
+    rhs &= mask( bitsize );
+
+    u64 result = 0;
+
+    switch( operation )
+    {
+        case Operation::AND:
+        {
+            result = lhs & rhs;
+            break;
+        }
+        case Operation::OR:
+        {
+            result = lhs | rhs;
+            break;
+        }
+        case Operation::XOR:
+        {
+            result = lhs ^ rhs;
+            break;
+        }
+        case Operation::NOT:
+        {
+            result = ~lhs;
+            break;
+        }
+        case Operation::LNOT:
+        {
+            result = lhs == 0;
+            break;
+        }
+        case Operation::ADD_UNSIGNED:  // fall-through
+        case Operation::ADD_SIGNED:
+        {
+            // both wrap around in two's complement representation
+            result = lhs + rhs;
+            break;
+        }
+        case Operation::DIV_SIGNED:
+        {
+            const i64 dividend = sign_extend( lhs, bitsize );
+            const i64 divisor = sign_extend( rhs, bitsize );
+
+            // the asmjit tier yields zero as well instead of a divide error
+            if( divisor == 0 )
+            {
+                return 0;
+            }
+
+            // the quotient of the minimum value and '-1' wraps around
+            const u64 magnitude = ( dividend < 0 ? -(u64)dividend : (u64)dividend ) /
+                                  ( divisor < 0 ? -(u64)divisor : (u64)divisor );
+
+            result = ( ( dividend < 0 ) != ( divisor < 0 ) ) ? -magnitude : magnitude;
+            break;
+        }
+        case Operation::MOD_UNSIGNED:
+        {
+            if( rhs == 0 )
+            {
+                return 0;
+            }
+
+            result = lhs % rhs;
+            break;
+        }
+        case Operation::EQU:
+        {
+            result = lhs == rhs;
+            break;
+        }
+        case Operation::NEQ:
+        {
+            result = lhs != rhs;
+            break;
+        }
+        case Operation::ZERO_EXTEND:  // fall-through
+        case Operation::TRUNCATION:
+        {
+            result = lhs;
+            break;
+        }
+        case Operation::UNSUPPORTED:
+        {
+            assert( not" unsupported operation to evaluate " );
+            break;
+        }
+    }
+
+    return result & mask( result_bitsize );
+}
+
+u64 NativeEvaluator::evaluate( OperatorInstruction& value )
+{
+    assert( foldable( value ) );
+
+    const auto op = operation( value );
+    const auto& lhs = static_cast< BitConstant& >( *value.operands()[ 0 ] );
+
+    u64 rhs = 0;
+    if( not unary( op ) )
+    {
+        rhs = static_cast< BitConstant& >( *value.operands()[ 1 ] ).value().value();
+    }
+
+    return evaluate( op, lhs.value().value(), rhs, lhs.type().bitsize(), value.type().bitsize() );
+}
+
+libcjel_ir::Constant NativeEvaluator::execute( OperatorInstruction& value )
+{
+    return BitConstant(
+        std::static_pointer_cast< BitType >( value.ptr_type() ), evaluate( value ) );
+}
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
@@ -0,0 +1,127 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+/**
+   @brief    allocation-free native evaluation of constant operator instructions
+
+   Operator instructions whose operands are all bit constants are computed
+   directly on host words with bit-width-correct masking instead of being
+   lowered and JIT compiled.
+*/
+
+#ifndef _LIBCJEL_RT_NATIVE_EVALUATOR_H_
+#define _LIBCJEL_RT_NATIVE_EVALUATOR_H_
+
+#include <libcjel-rt/CjelRT>
+
+#include <libstdhl/Type>
+
+namespace libcjel_ir
+{
+    class Value;
+    class Constant;
+    class OperatorInstruction;
+}
+
+namespace libcjel_rt
+{
+    class NativeEvaluator : public CjelRT
+    {
+      public:
+        enum class Operation
+        {
+            UNSUPPORTED,
+            AND,
+            OR,
+            XOR,
+            NOT,
+            LNOT,
+            ADD_UNSIGNED,
+            ADD_SIGNED,
+            DIV_SIGNED,
+            MOD_UNSIGNED,
+            EQU,
+            NEQ,
+            ZERO_EXTEND,
+            TRUNCATION,
+        };
+
+        static Operation operation( libcjel_ir::Value& value );
+
+        static u1 unary( Operation operation );
+
+        /**
+           true if 'value' is an operator instruction which is supported and
+           whose operands are all bit constants of at most 64-bit
+        */
+        static u1 foldable( libcjel_ir::Value& value );
+
+        static u64 mask( u64 bitsize );
+
+        /**
+           computes 'operation' on the words 'lhs' and 'rhs' of bit-size
+           'bitsize' and returns the result masked to 'result_bitsize'
+        */
+        static u64 evaluate(
+            Operation operation, u64 lhs, u64 rhs, u64 bitsize, u64 result_bitsize );
+
+        /**
+           evaluates a constant operand instruction 'value' on the operand
+           words, 'value' has to be 'foldable'
+        */
+        static u64 evaluate( libcjel_ir::OperatorInstruction& value );
+
+        static libcjel_ir::Constant execute( libcjel_ir::OperatorInstruction& value );
+    };
+}
+
+#endif  // _LIBCJEL_RT_NATIVE_EVALUATOR_H_
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
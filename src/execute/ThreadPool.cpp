@@ -0,0 +1,249 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+
+#include "ThreadPool.h"
+
+#include <cassert>
+
+using namespace libcjel_rt;
+
+static constexpr std::size_t EXTERNAL = (std::size_t)-1;
+
+/**
+   index of the deque owned by the current thread, 'EXTERNAL' for threads
+   which are not workers of any pool
+*/
+static thread_local std::size_t s_index = EXTERNAL;
+static thread_local const void* s_pool = nullptr;
+
+ThreadPool::ThreadPool( std::size_t workers )
+: m_workers( workers )
+, m_stop( false )
+, m_queued( 0 )
+, m_next( 0 )
+, m_executed( 0 )
+, m_steals( 0 )
+{
+    for( std::size_t i = 0; i < m_workers; i++ )
+    {
+        m_queues.emplace_back( new Queue() );
+    }
+}
+
+ThreadPool::~ThreadPool( void )
+{
+    {
+        std::lock_guard< std::mutex > guard( m_lock );
+        m_stop = true;
+    }
+    m_signal.notify_all();
+
+    for( auto& thread : m_threads )
+    {
+        thread.join();
+    }
+}
+
+std::size_t ThreadPool::defaultWorkers( void )
+{
+    const std::size_t cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 0;
+}
+
+std::size_t ThreadPool::workers( void ) const
+{
+    return m_workers;
+}
+
+void ThreadPool::run( const Task* tasks, std::size_t count )
+{
+    if( m_workers == 0 or count < 2 )
+    {
+        for( std::size_t i = 0; i < count; i++ )
+        {
+            tasks[ i ].function( tasks[ i ].frame );
+        }
+        m_executed += count;
+        return;
+    }
+
+    std::call_once( m_started, [this]() { start(); } );
+
+    const std::size_t index = ( s_pool == this ) ? s_index : EXTERNAL;
+
+    Batch batch;
+    batch.pending = count;
+
+    for( std::size_t i = 0; i < count; i++ )
+    {
+        // a worker keeps its own jobs local, others are spread round-robin
+        Queue& queue = *m_queues[ index != EXTERNAL ? index : m_next++ % m_workers ];
+
+        std::lock_guard< std::mutex > guard( queue.lock );
+        queue.jobs.push_back( Job{ tasks[ i ], &batch } );
+    }
+
+    m_queued += count;
+    {
+        std::lock_guard< std::mutex > guard( m_lock );
+    }
+    m_signal.notify_all();
+
+    while( batch.pending > 0 )
+    {
+        Job job;
+        if( take( index, job ) )
+        {
+            execute( job );
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+u64 ThreadPool::executed( void ) const
+{
+    return m_executed;
+}
+
+u64 ThreadPool::steals( void ) const
+{
+    return m_steals;
+}
+
+void ThreadPool::start( void )
+{
+    for( std::size_t i = 0; i < m_workers; i++ )
+    {
+        m_threads.emplace_back( [this, i]() { work( i ); } );
+    }
+}
+
+void ThreadPool::work( std::size_t index )
+{
+    s_index = index;
+    s_pool = this;
+
+    while( true )
+    {
+        Job job;
+        if( take( index, job ) )
+        {
+            execute( job );
+            continue;
+        }
+
+        std::unique_lock< std::mutex > lock( m_lock );
+        m_signal.wait( lock, [this]() { return m_stop or m_queued > 0; } );
+
+        if( m_stop and m_queued == 0 )
+        {
+            return;
+        }
+    }
+}
+
+u1 ThreadPool::take( std::size_t index, Job& job )
+{
+    if( m_queued == 0 )
+    {
+        return false;
+    }
+
+    if( index != EXTERNAL )
+    {
+        Queue& queue = *m_queues[ index ];
+        std::lock_guard< std::mutex > guard( queue.lock );
+        if( not queue.jobs.empty() )
+        {
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+            m_queued--;
+            return true;
+        }
+    }
+
+    const std::size_t start = ( index != EXTERNAL ) ? index + 1 : 0;
+    for( std::size_t i = 0; i < m_workers; i++ )
+    {
+        const std::size_t victim = ( start + i ) % m_workers;
+        if( victim == index )
+        {
+            continue;
+        }
+
+        Queue& queue = *m_queues[ victim ];
+        std::lock_guard< std::mutex > guard( queue.lock );
+        if( not queue.jobs.empty() )
+        {
+            job = queue.jobs.front();
+            queue.jobs.pop_front();
+            m_queued--;
+            m_steals++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::execute( const Job& job )
+{
+    job.task.function( job.task.frame );
+    m_executed++;
+
+    assert( job.batch->pending > 0 );
+    job.batch->pending--;
+}
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
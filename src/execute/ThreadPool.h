@@ -0,0 +1,164 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+
+/**
+   @brief    work-stealing pool executing the forked statements of parallel scopes
+
+   Every worker owns a deque of jobs, it pops its own jobs LIFO and steals
+   from the other deques FIFO once its own one runs dry. The thread which
+   forks a batch takes part in executing it until the whole batch is joined,
+   therefore nested forks from within a job cannot deadlock the pool.
+   Workers are started lazily on the first fork which needs them.
+*/
+
+#ifndef _LIBCJEL_RT_THREAD_POOL_H_
+#define _LIBCJEL_RT_THREAD_POOL_H_
+
+#include <libcjel-rt/CjelRT>
+
+#include <libstdhl/Type>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace libcjel_rt
+{
+    class ThreadPool : public CjelRT
+    {
+      public:
+        /**
+           one forked job, laid out as emitted by the asmjit tier
+        */
+        struct Task
+        {
+            void ( *function )( void* );
+            void* frame;
+        };
+
+        /**
+           'workers' is the number of additional threads, '0' executes all
+           jobs on the forking thread
+        */
+        ThreadPool( std::size_t workers = defaultWorkers() );
+
+        ~ThreadPool( void );
+
+        static std::size_t defaultWorkers( void );
+
+        std::size_t workers( void ) const;
+
+        /**
+           executes all 'count' jobs of 'tasks' and returns after all of them
+           have finished
+        */
+        void run( const Task* tasks, std::size_t count );
+
+        /**
+           total number of executed jobs
+        */
+        u64 executed( void ) const;
+
+        /**
+           total number of jobs taken from the deque of another worker
+        */
+        u64 steals( void ) const;
+
+      private:
+        struct Batch
+        {
+            std::atomic< std::size_t > pending;
+        };
+
+        struct Job
+        {
+            Task task;
+            Batch* batch;
+        };
+
+        struct Queue
+        {
+            std::mutex lock;
+            std::deque< Job > jobs;
+        };
+
+        void start( void );
+
+        void work( std::size_t index );
+
+        u1 take( std::size_t index, Job& job );
+
+        void execute( const Job& job );
+
+        const std::size_t m_workers;
+
+        std::once_flag m_started;
+        std::vector< std::thread > m_threads;
+        std::vector< std::unique_ptr< Queue > > m_queues;
+
+        std::mutex m_lock;
+        std::condition_variable m_signal;
+        u1 m_stop;
+
+        std::atomic< std::size_t > m_queued;
+        std::atomic< std::size_t > m_next;
+        std::atomic< u64 > m_executed;
+        std::atomic< u64 > m_steals;
+    };
+}
+
+#endif  // _LIBCJEL_RT_THREAD_POOL_H_
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
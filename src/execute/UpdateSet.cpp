@@ -0,0 +1,346 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+
+#include "UpdateSet.h"
+
+#include <cassert>
+#include <cstring>
+#include <thread>
+
+using namespace libcjel_rt;
+
+/**
+   number of locations in one cache line, probing starts at the beginning of
+   a line and scans it as a whole before moving to the next one
+*/
+static constexpr std::size_t LINE = 64 / sizeof( u64 );
+
+UpdateSet::UpdateSet( std::size_t capacity )
+: m_mask( 0 )
+, m_locations()
+, m_values()
+, m_sizes()
+, m_size( 0 )
+, m_sequential( false )
+, m_outer( nullptr )
+{
+    std::size_t size = LINE;
+    while( size < capacity )
+    {
+        size <<= 1;
+    }
+
+    m_mask = size - 1;
+    m_locations.reset( new std::atomic< u64 >[ size ] );
+    m_values.reset( new std::atomic< u64 >[ size ] );
+    m_sizes.reset( new std::atomic< u32 >[ size ] );
+
+    clear();
+}
+
+std::size_t UpdateSet::capacity( void ) const
+{
+    return m_mask + 1;
+}
+
+std::size_t UpdateSet::size( void ) const
+{
+    return m_size;
+}
+
+static inline std::size_t first( u64 key, std::size_t mask )
+{
+    const u64 hash = key * static_cast< u64 >( 0x9e3779b97f4a7c15 );
+    return ( hash ^ ( hash >> 32 ) ) & mask & ~( LINE - 1 );
+}
+
+static inline u64 truncate( u64 value, u32 size )
+{
+    return size < sizeof( u64 ) ? value & ( ( (u64)1 << ( size * 8 ) ) - 1 ) : value;
+}
+
+u1 UpdateSet::insert( void* location, u64 value, u32 size )
+{
+    assert( location and size > 0 and size <= sizeof( u64 ) );
+
+    const u64 key = reinterpret_cast< std::uintptr_t >( location );
+    const std::size_t start = first( key, m_mask );
+
+    value = truncate( value, size );
+
+    for( std::size_t probe = 0; probe <= m_mask; probe++ )
+    {
+        const std::size_t i = ( start + probe ) & m_mask;
+
+        u64 current = m_locations[ i ].load( std::memory_order_acquire );
+        if( current == 0 )
+        {
+            if( m_locations[ i ].compare_exchange_strong( current, key ) )
+            {
+                // the size publishes the slot to concurrent inserts
+                m_values[ i ].store( value, std::memory_order_relaxed );
+                m_sizes[ i ].store( size, std::memory_order_release );
+                m_size++;
+                return true;
+            }
+        }
+
+        if( current != key )
+        {
+            continue;
+        }
+
+        u32 published = m_sizes[ i ].load( std::memory_order_acquire );
+        while( published == 0 )
+        {
+            std::this_thread::yield();
+            published = m_sizes[ i ].load( std::memory_order_acquire );
+        }
+
+        // locations are keyed by address, all their updates have one size
+        assert( published == size );
+
+        if( m_sequential )
+        {
+            // a layer is only updated by the thread executing its scope
+            m_values[ i ].store( value, std::memory_order_relaxed );
+            m_sizes[ i ].store( size, std::memory_order_release );
+            return true;
+        }
+
+        if( m_values[ i ].load( std::memory_order_relaxed ) == value )
+        {
+            // consistent updates of the same location are no conflict
+            return true;
+        }
+
+        std::lock_guard< std::mutex > guard( m_lock );
+        m_conflicts.emplace_back( location );
+        return false;
+    }
+
+    // slots are only released by 'clear', so once the table is full every
+    // location which is not in it is kept in the overflow map
+    std::lock_guard< std::mutex > guard( m_lock );
+
+    auto result = m_overflow.emplace( location, std::make_pair( value, size ) );
+    if( result.second )
+    {
+        m_size++;
+        return true;
+    }
+
+    assert( result.first->second.second == size );
+
+    if( m_sequential )
+    {
+        result.first->second = std::make_pair( value, size );
+        return true;
+    }
+
+    if( result.first->second == std::make_pair( value, size ) )
+    {
+        return true;
+    }
+
+    m_conflicts.emplace_back( location );
+    return false;
+}
+
+u1 UpdateSet::sequential( void ) const
+{
+    return m_sequential;
+}
+
+void UpdateSet::setSequential( u1 sequential )
+{
+    assert( m_size == 0 );
+    m_sequential = sequential;
+}
+
+UpdateSet* UpdateSet::outer( void ) const
+{
+    return m_outer;
+}
+
+void UpdateSet::setOuter( UpdateSet* set )
+{
+    m_outer = ( not set or set->sequential() ) ? set : set->outer();
+}
+
+u1 UpdateSet::lookup( void* location, u32 size, u64& value ) const
+{
+    const u64 key = reinterpret_cast< std::uintptr_t >( location );
+    const std::size_t start = first( key, m_mask );
+
+    for( std::size_t probe = 0; probe <= m_mask; probe++ )
+    {
+        const std::size_t i = ( start + probe ) & m_mask;
+
+        const u64 current = m_locations[ i ].load( std::memory_order_acquire );
+        if( current == 0 )
+        {
+            return false;
+        }
+
+        if( current == key )
+        {
+            assert( m_sizes[ i ].load( std::memory_order_acquire ) == size );
+
+            value = m_values[ i ].load( std::memory_order_relaxed );
+            return true;
+        }
+    }
+
+    std::lock_guard< std::mutex > guard( m_lock );
+
+    auto result = m_overflow.find( location );
+    if( result == m_overflow.end() )
+    {
+        return false;
+    }
+
+    assert( result->second.second == size );
+
+    value = result->second.first;
+    return true;
+}
+
+u64 UpdateSet::read( void* location, u32 size, u64 value ) const
+{
+    // parallel sets are never read, the statements of their scope see the
+    // state from before the scope
+    for( const UpdateSet* set = m_sequential ? this : m_outer; set; set = set->outer() )
+    {
+        u64 update = 0;
+        if( set->lookup( location, size, update ) )
+        {
+            return update;
+        }
+    }
+
+    return truncate( value, size );
+}
+
+const std::vector< void* >& UpdateSet::conflicts( void ) const
+{
+    return m_conflicts;
+}
+
+u1 UpdateSet::apply( void )
+{
+    if( not m_conflicts.empty() )
+    {
+        return false;
+    }
+
+    for( std::size_t i = 0; i <= m_mask; i++ )
+    {
+        const u32 size = m_sizes[ i ].load( std::memory_order_acquire );
+        if( size )
+        {
+            const u64 value = m_values[ i ].load( std::memory_order_relaxed );
+            void* location = reinterpret_cast< void* >( m_locations[ i ].load() );
+
+            // locations are written in the little-endian layout of the jit
+            memcpy( location, &value, size );
+        }
+    }
+
+    for( const auto& update : m_overflow )
+    {
+        memcpy( update.first, &update.second.first, update.second.second );
+    }
+
+    return true;
+}
+
+u1 UpdateSet::merge( UpdateSet& set ) const
+{
+    u1 consistent = true;
+
+    for( std::size_t i = 0; i <= m_mask; i++ )
+    {
+        const u32 size = m_sizes[ i ].load( std::memory_order_acquire );
+        if( size )
+        {
+            consistent &= set.insert(
+                reinterpret_cast< void* >( m_locations[ i ].load() ),
+                m_values[ i ].load( std::memory_order_relaxed ),
+                size );
+        }
+    }
+
+    for( const auto& update : m_overflow )
+    {
+        consistent &= set.insert( update.first, update.second.first, update.second.second );
+    }
+
+    return consistent;
+}
+
+void UpdateSet::clear( void )
+{
+    for( std::size_t i = 0; i <= m_mask; i++ )
+    {
+        m_locations[ i ].store( 0, std::memory_order_relaxed );
+        m_values[ i ].store( 0, std::memory_order_relaxed );
+        m_sizes[ i ].store( 0, std::memory_order_relaxed );
+    }
+
+    m_size = 0;
+    m_sequential = false;
+    m_outer = nullptr;
+    m_overflow.clear();
+    m_conflicts.clear();
+}
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
@@ -0,0 +1,188 @@
+//
+//  Copyright (C) 2017-2024 CASM Organization <https://casm-lang.org>
+//  All rights reserved.
+//
+//  Developed by: Philipp Paulweber et al.
+//  <https://github.com/casm-lang/libcjel-rt/graphs/contributors>
+//
+//  This file is part of libcjel-rt.
+//
+//  libcjel-rt is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  libcjel-rt is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with libcjel-rt. If not, see <http://www.gnu.org/licenses/>.
+//
+//  Additional permission under GNU GPL version 3 section 7
+//
+//  libcjel-rt is distributed under the terms of the GNU General Public License
+//  with the following clarification and special exception: Linking libcjel-rt
+//  statically or dynamically with other modules is making a combined work
+//  based on libcjel-rt. Thus, the terms and conditions of the GNU General
+//  Public License cover the whole combination. As a special exception,
+//  the copyright holders of libcjel-rt give you permission to link libcjel-rt
+//  with independent modules to produce an executable, regardless of the
+//  license terms of these independent modules, and to copy and distribute
+//  the resulting executable under terms of your choice, provided that you
+//  also meet, for each linked independent module, the terms and conditions
+//  of the license of that module. An independent module is a module which
+//  is not derived from or based on libcjel-rt. If you modify libcjel-rt, you
+//  may extend this exception to your version of the library, but you are
+//  not obliged to do so. If you do not wish to do so, delete this exception
+//  statement from your version.
+//
+
+
+/**
+   @brief    update set of one execution of a parallel scope
+
+   All stores of the statements of a parallel scope are recorded as updates
+   instead of being written to memory, so every statement reads the state as
+   it was before the scope. Updates are inserted lock-free from any number
+   of threads into an open addressed table keyed by their location, updates
+   which do not fit into the table any more take a locked overflow path. Two
+   updates of the same location with different values form a conflict. The
+   set is applied to memory or merged into the set of an enclosing scope
+   once all statements of the scope have finished.
+
+   A sequential scope nested in a parallel one collects its stores in a
+   sequential layer instead, where a later update of a location replaces
+   the earlier one and loads of the scope read the updates of all enclosing
+   layers before they read the memory.
+
+   Locations are compared by their start address only. All updates and
+   lookups of one location have to use the same size, which holds as long
+   as a location is only accessed with its own type, and is asserted.
+   Updates of different locations whose byte ranges overlap are not
+   detected as conflicts.
+*/
+
+#ifndef _LIBCJEL_RT_UPDATE_SET_H_
+#define _LIBCJEL_RT_UPDATE_SET_H_
+
+#include <libcjel-rt/CjelRT>
+
+#include <libstdhl/Type>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace libcjel_rt
+{
+    class UpdateSet : public CjelRT
+    {
+      public:
+        /**
+           'capacity' is rounded up to a power of two of at least one cache
+           line of locations
+        */
+        UpdateSet( std::size_t capacity );
+
+        std::size_t capacity( void ) const;
+
+        /**
+           number of distinct updated locations
+        */
+        std::size_t size( void ) const;
+
+        /**
+           records the update of the 'size' lower bytes of 'value' at
+           'location', returns false if it conflicts with a previous update
+           of a parallel set, a previous update must have the same 'size'
+        */
+        u1 insert( void* location, u64 value, u32 size );
+
+        /**
+           true if the set is a sequential layer
+        */
+        u1 sequential( void ) const;
+
+        /**
+           turns the cleared set into a sequential layer
+        */
+        void setSequential( u1 sequential );
+
+        /**
+           innermost sequential layer enclosing the scope of the set, or a
+           null pointer if there is none
+        */
+        UpdateSet* outer( void ) const;
+
+        /**
+           'set' is the set of the enclosing scope or a null pointer, its
+           innermost sequential layer becomes the outer layer of this set
+        */
+        void setOuter( UpdateSet* set );
+
+        /**
+           the 'size' lower bytes of the update of 'location' in this set,
+           returns false if the set has no such update
+        */
+        u1 lookup( void* location, u32 size, u64& value ) const;
+
+        /**
+           the 'size' lower bytes at 'location' as seen by the scope of the
+           set, 'value' is the one read from memory and returned if no
+           sequential layer has updated the location
+        */
+        u64 read( void* location, u32 size, u64 value ) const;
+
+        /**
+           locations updated with different values
+        */
+        const std::vector< void* >& conflicts( void ) const;
+
+        /**
+           writes all updates to memory, nothing is written if the set
+           contains conflicts
+        */
+        u1 apply( void );
+
+        /**
+           inserts all updates into 'set', returns false if any of them
+           conflicts
+        */
+        u1 merge( UpdateSet& set ) const;
+
+        void clear( void );
+
+      private:
+        std::size_t m_mask;
+
+        std::unique_ptr< std::atomic< u64 >[] > m_locations;
+        std::unique_ptr< std::atomic< u64 >[] > m_values;
+        std::unique_ptr< std::atomic< u32 >[] > m_sizes;
+
+        std::atomic< std::size_t > m_size;
+
+        u1 m_sequential;
+        UpdateSet* m_outer;
+
+        mutable std::mutex m_lock;
+        std::unordered_map< void*, std::pair< u64, u32 > > m_overflow;
+        std::vector< void* > m_conflicts;
+    };
+}
+
+#endif  // _LIBCJEL_RT_UPDATE_SET_H_
+
+
+//
+//  Local variables:
+//  mode: c++
+//  indent-tabs-mode: nil
+//  c-basic-offset: 4
+//  tab-width: 4
+//  End:
+//  vim:noexpandtab:sw=4:ts=4:
+//
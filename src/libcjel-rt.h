@@ -43,8 +43,14 @@
 #define _LIBCJEL_RT_H_
 
 #include <libcjel-rt/CallableUnit>
+#include <libcjel-rt/CodeCache>
 #include <libcjel-rt/Instruction>
+#include <libcjel-rt/Runtime>
 #include <libcjel-rt/Version>
+#include <libcjel-rt/execute/Interpreter>
+#include <libcjel-rt/execute/NativeEvaluator>
+#include <libcjel-rt/execute/ThreadPool>
+#include <libcjel-rt/execute/UpdateSet>
 
 namespace libcjel_rt
 {
@@ -41,10 +41,17 @@
 
 #include "CjelIRToAsmJitPass.h"
 
+#include <libcjel-rt/execute/NativeEvaluator>
+#include <libcjel-rt/execute/ThreadPool>
+#include <libcjel-rt/execute/UpdateSet>
+
 #include <libcjel-ir/Constant>
 #include <libcjel-ir/Function>
 #include <libcjel-ir/Instruction>
 #include <libcjel-ir/Intrinsic>
+#include <libcjel-ir/Module>
+#include <libcjel-ir/Scope>
+#include <libcjel-ir/Statement>
 #include <libcjel-ir/Type>
 #include <libcjel-ir/Value>
 #include <libcjel-ir/analyze/CjelIRDumpPass>
@@ -52,6 +59,13 @@
 #include <libpass/PassRegistry>
 
 #include <libstdhl/Log>
+#include <libstdhl/Memory>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <unordered_set>
 
 using namespace libcjel_ir;
 using namespace libcjel_rt;
@@ -59,12 +73,67 @@ using namespace asmjit;
 
 char CjelIRToAsmJitPass::id = 0;
 
+constexpr u32 CjelIRToAsmJitPass::Context::Numbering::NONE;
+
 static libpass::PassRegistration< CjelIRToAsmJitPass > PASS( "CJEL IR to AsmJit", "TBD", 0, 0 );
 
 bool CjelIRToAsmJitPass::run( libpass::PassResult& pr )
 {
-    assert( not" PPA: TODO!!! " );
-    return false;
+    auto data = pr.result< CjelIRToAsmJitPass >();
+
+    if( not data or not data->module() )
+    {
+        fprintf( stderr, "%s:%i: no module to compile\n", __FILE__, __LINE__ );
+        return false;
+    }
+
+    Context c( data->runtime() );
+
+    void* entry = compile( *data->module(), c );
+
+    data->setSymbols(
+        c.symbols(),
+        libstdhl::Memory::make< CodeCache::Code >(
+            data->runtime(), entry, c.functions(), false, c.counters() ) );
+
+    pr.setResult< CjelIRToAsmJitPass >( data );
+    return true;
+}
+
+CjelIRToAsmJitPass::Data::Data( const Module::Ptr& module, Runtime& runtime )
+: m_module( module )
+, m_runtime( runtime )
+, m_symbols()
+, m_code()
+{
+}
+
+const Module::Ptr& CjelIRToAsmJitPass::Data::module( void ) const
+{
+    return m_module;
+}
+
+Runtime& CjelIRToAsmJitPass::Data::runtime( void ) const
+{
+    return m_runtime;
+}
+
+void* CjelIRToAsmJitPass::Data::symbol( const std::string& name ) const
+{
+    auto result = m_symbols.find( name );
+    return result != m_symbols.end() ? result->second : nullptr;
+}
+
+const std::unordered_map< std::string, void* >& CjelIRToAsmJitPass::Data::symbols( void ) const
+{
+    return m_symbols;
+}
+
+void CjelIRToAsmJitPass::Data::setSymbols(
+    const std::unordered_map< std::string, void* >& symbols, const CodeCache::Code::Ptr& code )
+{
+    m_symbols = symbols;
+    m_code = code;
 }
 
 #if 0
@@ -93,6 +162,8 @@ bool CjelIRToAsmJitPass::run( libpass::PassResult& pr )
         value.label().c_str(),       \
         ##ARGS )
 
+#define NOTE( FMT, ARGS... ) fprintf( stderr, "[asmjit] " FMT "\n", ##ARGS )
+
 #define FIXME()                                                                     \
     {                                                                               \
         fprintf( stderr, "%s:%i: FIXME: unimplemented\n", __FUNCTION__, __LINE__ ); \
@@ -121,13 +192,10 @@ static u32 calc_byte_size( const libcjel_ir::Type& type )
             {
                 return 4;
             }
-            else if( type.bitsize() <= 64 )
-            {
-                return 8;
-            }
             else
             {
-                assert( not" a bit type of bit-size greater than 64-bit is unsupported for now! " );
+                // wide bit types are stored as little-endian 64-bit limbs
+                return ( ( type.bitsize() + 63 ) / 64 ) * 8;
             }
             break;
         }
@@ -153,1399 +221,5641 @@ static u32 calc_byte_size( const libcjel_ir::Type& type )
     }
 }
 
-void CjelIRToAsmJitPass::alloc_reg_for_value( Value& value, Context& c )
+static inline u1 is_wide( const libcjel_ir::Type& type )
 {
-    const auto& type = value.type();
+    return type.isBit() and type.bitsize() > 64;
+}
 
-    if( c.val2reg().find( &value ) != c.val2reg().end() )
-    {
-        // already allocated!
-        return;
-    }
+static inline u32 limbs( const libcjel_ir::Type& type )
+{
+    return calc_byte_size( type ) / 8;
+}
 
-    if( isa< Reference >( value ) )
+static X86Gp sub_reg( const X86Gp& reg, u32 byte_size )
+{
+    switch( byte_size )
     {
-        Context::Callable& func = c.callable();
-
-        c.val2reg()[&value ] = c.compiler().newUIntPtr( value.label().c_str() );
-        VERBOSE( "newUIntPtr" );
+        case 1:
+        {
+            return reg.r8();
+        }
+        case 2:
+        {
+            return reg.r16();
+        }
+        case 4:
+        {
+            return reg.r32();
+        }
+        default:
+        {
+            return reg.r64();
+        }
+    }
+}
 
-        c.compiler().setArg( func.argsize( 1 ) - 1, c.val2reg()[&value ] );
-        VERBOSE( "setArg( %u, %s )", func.argsize() - 1, value.label().c_str() );
+/**
+   byte offset of the element 'index' of the structure or vector 'type', the
+   elements are packed in order at their 'calc_byte_size', which is the layout
+   of extracts, encoded constants and entry results alike
+*/
+static u32 element_offset( const libcjel_ir::Type& type, u64 index )
+{
+    assert( index <= type.results().size() );
 
-        return;
+    u32 byte_offset = 0;
+    for( u32 i = 0; i < index; i++ )
+    {
+        byte_offset += calc_byte_size( *type.results()[ i ] );
     }
+    return byte_offset;
+}
 
-    if( isa< AllocInstruction >( value ) )
+/**
+   true if values of 'type' are held in a vector register, which needs a
+   vector of equal bit elements of 1, 2, 4 or 8 bytes filling 4, 8 or 16
+   bytes, or 32 bytes if the host supports AVX2
+*/
+static u1 in_vector_register( const libcjel_ir::Type& type )
+{
+    if( type.id() != libcjel_ir::Type::VECTOR or type.results().empty() )
     {
-        u32 byte_size = calc_byte_size( type );
-
-        c.val2reg()[&value ] = c.compiler().newUIntPtr( value.label().c_str() );
-        VERBOSE( "newUIntPtr" );
-
-        c.compiler().lea( c.val2reg()[&value ], c.compiler().newStack( byte_size, 4 ) );
-        VERBOSE( "lea %s, newStack( %u, 4 ) ;; alloc", value.label().c_str(), byte_size );
-
-        X86Gp tmp = c.compiler().newU8( "tmp" );
-        c.compiler().mov( tmp, asmjit::imm( 0 ) );
-
-        u32 offset = 0;
-        for( auto element : value.type().results() )
-        {
-            assert( element->isBit() );
+        return false;
+    }
 
-            u32 top = calc_byte_size( *element );
-            u32 idx = 0;
-            for( u32 i = 0; i < top; i++ )
-            {
-                idx = i + offset;
-                c.compiler().mov( x86::ptr( c.val2reg()[&value ], idx ), tmp );
-                VERBOSE( "mov ptr( %s, %u ), imm( 0 )", value.label().c_str(), idx );
-            }
+    const auto& element = *type.results()[ 0 ];
 
-            offset += top;
-        }
-        return;
+    if( not element.isBit() or is_wide( element ) )
+    {
+        return false;
     }
 
-    switch( type.id() )
+    for( const auto& other : type.results() )
     {
-        case libcjel_ir::Type::BIT:
-        {
-            if( type.bitsize() < 1 )
-            {
-                assert( not" bit type has invalid bit-size of '0' " );
-            }
-            else if( type.bitsize() <= 8 )
-            {
-                c.val2reg()[&value ] = c.compiler().newU8( value.label().c_str() );
-                VERBOSE( "newU8" );
-            }
-            else if( type.bitsize() <= 16 )
-            {
-                c.val2reg()[&value ] = c.compiler().newU16( value.label().c_str() );
-                VERBOSE( "newU16" );
-            }
-            else if( type.bitsize() <= 32 )
-            {
-                c.val2reg()[&value ] = c.compiler().newU32( value.label().c_str() );
-                VERBOSE( "newU32" );
-            }
-            else if( type.bitsize() <= 64 )
-            {
-                c.val2reg()[&value ] = c.compiler().newU64( value.label().c_str() );
-                VERBOSE( "newU64" );
-            }
-            else
-            {
-                assert( not" a bit type of bit-size greater than 64-bit is unsupported for now! " );
-            }
-            break;
-        }
-        case libcjel_ir::Type::VECTOR:  // fall-through
-        case libcjel_ir::Type::STRUCTURE:
-        {
-            c.val2reg()[&value ] = c.compiler().newUIntPtr( value.label().c_str() );
-            VERBOSE( "newUIntPtr" );
-            break;
-        }
-        default:
+        if( not other->isBit() or other->bitsize() != element.bitsize() )
         {
-            fprintf(
-                stderr,
-                "unsupported type '%s' to allocate a register!\n",
-                type.description().c_str() );
-            assert( 0 );
-            break;
+            return false;
         }
     }
 
-    // fprintf( stderr,  "alloc '%p' for '%s' of type '%s'",
-    //     &c.val2reg()[&value ],
-    //     value.label(),
-    //     value.type().name() );
+    const u32 byte_size = calc_byte_size( type );
 
-    if( isa< Constant >( value ) )
+    if( byte_size == 32 )
     {
-        switch( value.id() )
-        {
-            case Value::BIT_CONSTANT:
-            {
-                visit_prolog(
-                    static_cast< BitConstant& >( value ),
-                    static_cast< libcjel_ir::Context& >( c ) );
-                break;
-            }
-            case Value::STRUCTURE_CONSTANT:
-            {
-                visit_prolog(
-                    static_cast< StructureConstant& >( value ),
-                    static_cast< libcjel_ir::Context& >( c ) );
-                break;
-            }
-            default:
-            {
-                fprintf(
-                    stderr,
-                    "unsupported constant value of type '%s' to allocate a "
-                    "register!\n",
-                    type.description().c_str() );
-                assert( 0 );
-                break;
-            }
-        }
+        return CpuInfo::getHost().hasFeature( CpuInfo::kX86FeatureAVX2 );
     }
-}
 
-void CjelIRToAsmJitPass::visit_prolog( Module& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    FIXME();
+    return byte_size == 4 or byte_size == 8 or byte_size == 16;
 }
-void CjelIRToAsmJitPass::visit_epilog( Module& value, libcjel_ir::Context& cxt )
+
+static X86Gp new_reg_for_bit_type(
+    const libcjel_ir::Type& type, const char* label, X86Compiler& cc )
 {
-}
+    assert( type.isBit() );
 
-//
-// Function
-//
+    if( type.bitsize() < 1 )
+    {
+        assert( not" bit type has invalid bit-size of '0' " );
+    }
+    else if( type.bitsize() <= 8 )
+    {
+        return cc.newU8( label );
+    }
+    else if( type.bitsize() <= 16 )
+    {
+        return cc.newU16( label );
+    }
+    else if( type.bitsize() <= 32 )
+    {
+        return cc.newU32( label );
+    }
+    else if( type.bitsize() <= 64 )
+    {
+        return cc.newU64( label );
+    }
 
-void CjelIRToAsmJitPass::visit_prolog( Function& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    FIXME();
-}
-void CjelIRToAsmJitPass::visit_interlog( Function& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
+    assert( not" a bit type of bit-size greater than 64-bit is unsupported for now! " );
+    return X86Gp();
 }
-void CjelIRToAsmJitPass::visit_epilog( Function& value, libcjel_ir::Context& cxt )
+
+static void mask_word( const X86Gp& word, u16 bitsize, X86Compiler& cc )
 {
-    TRACE( "" );
-}
+    if( bitsize % 64 == 0 )
+    {
+        return;
+    }
 
-//
-// Intrinsic
-//
+    const u64 mask = ( (u64)1 << ( bitsize % 64 ) ) - 1;
 
-void CjelIRToAsmJitPass::visit_prolog( Intrinsic& value, libcjel_ir::Context& cxt )
+    if( mask <= 0x7fffffff )
+    {
+        cc.and_( word, asmjit::imm( mask ) );
+    }
+    else
+    {
+        X86Gp tmp = cc.newU64( "mask" );
+        cc.mov( tmp, asmjit::imm_u( mask ) );
+        cc.and_( word, tmp );
+    }
+}
+
+/**
+   zero extends the bit value in 'reg' of 'bitsize' bits to a 64-bit word and
+   clears the bits above 'bitsize' which are not defined in the register
+*/
+static X86Gp zero_extend_word( const X86Gp& reg, u16 bitsize, X86Compiler& cc )
 {
-    TRACE( "" );
-    Context& c = static_cast< Context& >( cxt );
+    X86Gp word = cc.newU64( "word" );
 
-    Context::Callable& func = c.callable( &value );
-    func.argsize( -1 );
+    if( bitsize > 32 )
+    {
+        cc.mov( word, reg.r64() );
+    }
+    else if( bitsize > 16 )
+    {
+        // writing the lower half clears the upper one
+        cc.mov( word.r32(), reg.r32() );
+    }
+    else
+    {
+        cc.movzx( word, reg );
+    }
 
-    FuncSignatureX& fsig = func.funcsig();
-    fsig.init( CallConv::kIdHost, TypeId::kVoid, fsig._builderArgList, 0 );
+    mask_word( word, bitsize, cc );
+    return word;
 }
-void CjelIRToAsmJitPass::visit_interlog( Intrinsic& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    Context& c = static_cast< Context& >( cxt );
-    Context::Callable& func = c.callable();
 
-    c.compiler().addFunc( func.funcsig() );
-    VERBOSE( "addFunc( %s )", value.name().c_str() );
+/**
+   sign extends the bit value in 'reg' of 'bitsize' bits to a 64-bit word
+*/
+static X86Gp sign_extend_word( const X86Gp& reg, u16 bitsize, X86Compiler& cc )
+{
+    X86Gp word = cc.newI64( "word" );
 
-    for( auto param : value.inputs() )
+    if( bitsize > 32 )
     {
-        assert( isa< Reference >( param ) );
-        alloc_reg_for_value( *param, c );
+        cc.mov( word, reg.r64() );
     }
-
-    for( auto param : value.outputs() )
+    else if( bitsize > 16 )
     {
-        assert( isa< Reference >( param ) );
-        alloc_reg_for_value( *param, c );
+        cc.movsxd( word, reg.r32() );
+    }
+    else
+    {
+        cc.movsx( word, reg );
     }
 
-    for( auto param : value.linkage() )
+    if( bitsize != 8 and bitsize != 16 and bitsize != 32 and bitsize != 64 )
     {
-        assert( param and 0 );
+        cc.shl( word, 64 - bitsize );
+        cc.sar( word, 64 - bitsize );
     }
 
-    assert( func.funcsig().getArgCount() == func.argsize() );
+    return word;
 }
-void CjelIRToAsmJitPass::visit_epilog( Intrinsic& value, libcjel_ir::Context& cxt )
+
+/**
+   magic number 'multiplier' and 'shift' of the unsigned division of values
+   below 2^bitsize by 'divisor', which is neither a power of two nor above
+   2^( bitsize - 1 ), the multiplier has an implicit 65th bit if 'add' is set
+*/
+static void magic_unsigned( u64 divisor, u16 bitsize, u64& multiplier, u32& shift, u1& add )
 {
-    TRACE( "" );
-    Context& c = static_cast< Context& >( cxt );
+    const u32 log = 64 - __builtin_clzll( divisor );
 
-    c.compiler().endFunc();
-    c.compiler().finalize();
+    shift = bitsize + log;
 
-    void** func_ptr;
-    Error err = c.runtime().add( &func_ptr, &c.codeholder() );
+    const unsigned __int128 magic = ( ( (unsigned __int128)1 << shift ) / divisor ) + 1;
 
-    fprintf(
-        stderr,
-        "asmjit: %s @ %p\n"
-        "~~~{.asm}\n"
-        "%s"
-        "~~~\n",
-        value.name().c_str(),
-        func_ptr,
-        c.logger().getString() );
+    multiplier = (u64)magic;
+    add = ( magic >> 64 ) != 0;
+}
 
-    if( err )
+/**
+   magic number 'multiplier' and 'shift' of the signed division of 64-bit
+   values by 'divisor', whose magnitude is neither zero, one nor a power of
+   two, see Hacker's Delight, chapter 10
+*/
+static void magic_signed( i64 divisor, u64& multiplier, u32& shift )
+{
+    const u64 two63 = (u64)1 << 63;
+    const u64 ad = divisor < 0 ? -(u64)divisor : (u64)divisor;
+    const u64 t = two63 + ( (u64)divisor >> 63 );
+    const u64 anc = t - 1 - t % ad;
+
+    u32 p = 63;
+    u64 q1 = two63 / anc;
+    u64 r1 = two63 - q1 * anc;
+    u64 q2 = two63 / ad;
+    u64 r2 = two63 - q2 * ad;
+    u64 delta = 0;
+
+    do
     {
-        fprintf( stderr, "asmjit: %s", DebugUtils::errorAsString( err ) );
-        assert( 0 );
-    }
+        p++;
 
-    Context::Callable& func = c.callable();
-    func.funcptr( func_ptr );
-}
+        q1 = 2 * q1;
+        r1 = 2 * r1;
+        if( r1 >= anc )
+        {
+            q1++;
+            r1 -= anc;
+        }
 
-//
-// Reference
-//
+        q2 = 2 * q2;
+        r2 = 2 * r2;
+        if( r2 >= ad )
+        {
+            q2++;
+            r2 -= ad;
+        }
 
-void CjelIRToAsmJitPass::visit_prolog( Reference& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    Context& c = static_cast< Context& >( cxt );
-    Context::Callable& func = c.callable();
-    FuncSignatureX& fsig = func.funcsig();
-    fsig.addArg( TypeId::kUIntPtr );
+        delta = ad - r2;
+    } while( q1 < delta or ( q1 == delta and r1 == 0 ) );
+
+    multiplier = divisor < 0 ? -( q2 + 1 ) : q2 + 1;
+    shift = p - 64;
 }
-void CjelIRToAsmJitPass::visit_epilog( Reference& value, libcjel_ir::Context& cxt )
+
+/**
+   quotient of the zero extended word 'x' of 'bitsize' bits divided by the
+   constant 'divisor', which is not zero, without a divide instruction
+*/
+static X86Gp quotient_unsigned( const X86Gp& x, u64 divisor, u16 bitsize, X86Compiler& cc )
 {
-}
+    X86Gp q = cc.newU64( "quotient" );
 
-//
-// Structure
-//
+    if( ( divisor & ( divisor - 1 ) ) == 0 )
+    {
+        cc.mov( q, x );
+        cc.shr( q, __builtin_ctzll( divisor ) );
+    }
+    else if( divisor > ( NativeEvaluator::mask( bitsize ) >> 1 ) )
+    {
+        // the quotient is either zero or one
+        X86Gp d = cc.newU64( "divisor" );
+        cc.mov( d, imm_u( divisor ) );
+        cc.xor_( q.r32(), q.r32() );
+        cc.cmp( x, d );
+        cc.setae( q.r8() );
+    }
+    else
+    {
+        u64 multiplier = 0;
+        u32 shift = 0;
+        u1 add = false;
+        magic_unsigned( divisor, bitsize, multiplier, shift, add );
 
-void CjelIRToAsmJitPass::visit_prolog( Structure& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    FIXME();
-}
-void CjelIRToAsmJitPass::visit_epilog( Structure& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-}
+        X86Gp hi = cc.newU64( "hi" );
+        X86Gp lo = cc.newU64( "lo" );
+        X86Gp m = cc.newU64( "magic" );
 
-//
-// Variable
-//
+        cc.mov( lo, x );
+        cc.mov( m, imm_u( multiplier ) );
+        cc.mul( hi, lo, m );
 
-void CjelIRToAsmJitPass::visit_prolog( Variable& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    FIXME();
+        if( add )
+        {
+            // 'hi + x' may not fit into a word, so it is halved first
+            cc.mov( q, x );
+            cc.sub( q, hi );
+            cc.shr( q, 1 );
+            cc.add( q, hi );
+            if( shift > 65 )
+            {
+                cc.shr( q, shift - 65 );
+            }
+        }
+        else if( shift >= 64 )
+        {
+            cc.mov( q, hi );
+            if( shift > 64 )
+            {
+                cc.shr( q, shift - 64 );
+            }
+        }
+        else
+        {
+            cc.shrd( lo, hi, shift );
+            cc.mov( q, lo );
+        }
+    }
+
+    return q;
 }
-void CjelIRToAsmJitPass::visit_epilog( Variable& value, libcjel_ir::Context& cxt )
+
+/**
+   quotient truncated toward zero of the sign extended word 'x' divided by
+   the constant 'divisor', which is not zero, without a divide instruction
+*/
+static X86Gp quotient_signed( const X86Gp& x, i64 divisor, X86Compiler& cc )
 {
-    TRACE( "" );
-}
+    const u64 magnitude = divisor < 0 ? -(u64)divisor : (u64)divisor;
 
-//
-// Memory
-//
+    X86Gp q = cc.newI64( "quotient" );
 
-void CjelIRToAsmJitPass::visit_prolog( libcjel_ir::Memory& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    FIXME();
-}
-void CjelIRToAsmJitPass::visit_epilog( libcjel_ir::Memory& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-}
+    if( magnitude == 1 )
+    {
+        cc.mov( q, x );
+    }
+    else if( ( magnitude & ( magnitude - 1 ) ) == 0 )
+    {
+        // negative dividends are biased by 'magnitude - 1' to round toward
+        // zero
+        const u32 k = __builtin_ctzll( magnitude );
+
+        cc.mov( q, x );
+        cc.sar( q, 63 );
+        cc.shr( q, 64 - k );
+        cc.add( q, x );
+        cc.sar( q, k );
+    }
+    else
+    {
+        u64 multiplier = 0;
+        u32 shift = 0;
+        magic_signed( divisor, multiplier, shift );
 
-//
-// ParallelScope
-//
+        X86Gp lo = cc.newI64( "lo" );
+        X86Gp m = cc.newI64( "magic" );
 
-void CjelIRToAsmJitPass::visit_prolog( ParallelScope& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-}
-void CjelIRToAsmJitPass::visit_epilog( ParallelScope& value, libcjel_ir::Context& cxt )
-{
-}
+        cc.mov( lo, x );
+        cc.mov( m, imm_u( multiplier ) );
+        cc.imul( q, lo, m );
 
-//
-// SequentialScope
-//
+        if( divisor > 0 and (i64)multiplier < 0 )
+        {
+            cc.add( q, x );
+        }
+        else if( divisor < 0 and (i64)multiplier > 0 )
+        {
+            cc.sub( q, x );
+        }
 
-void CjelIRToAsmJitPass::visit_prolog( SequentialScope& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-}
-void CjelIRToAsmJitPass::visit_epilog( SequentialScope& value, libcjel_ir::Context& cxt )
-{
-}
+        if( shift > 0 )
+        {
+            cc.sar( q, shift );
+        }
 
-//
-// TrivialStatement
-//
+        // negative quotients are rounded toward zero
+        X86Gp sign = cc.newU64( "sign" );
+        cc.mov( sign, q );
+        cc.shr( sign, 63 );
+        cc.add( q, sign );
+        return q;
+    }
 
-void CjelIRToAsmJitPass::visit_prolog( TrivialStatement& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
+    if( divisor < 0 )
+    {
+        cc.neg( q );
+    }
+
+    return q;
 }
-void CjelIRToAsmJitPass::visit_epilog( TrivialStatement& value, libcjel_ir::Context& cxt )
+
+/**
+   calls 'action' for all instructions executed by 'value' including the
+   bodies of all callees, recursive callees are visited once
+*/
+static void traverse(
+    Value& value,
+    const std::function< void( libcjel_ir::Instruction& ) >& action,
+    std::unordered_set< Value* >& visiting )
 {
-}
+    value.iterate( Traversal::PREORDER, [&]( Value& node ) {
+        if( not isa< libcjel_ir::Instruction >( node ) )
+        {
+            return;
+        }
 
-//
-// BranchStatement
-//
+        action( static_cast< libcjel_ir::Instruction& >( node ) );
 
-void CjelIRToAsmJitPass::visit_prolog( BranchStatement& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    FIXME();
+        if( isa< CallInstruction >( node ) )
+        {
+            auto& callee =
+                static_cast< CallableUnit& >( *static_cast< CallInstruction& >( node ).callee() );
+
+            if( callee.context() and visiting.emplace( &callee ).second )
+            {
+                traverse( *callee.context(), action, visiting );
+            }
+        }
+    } );
 }
-void CjelIRToAsmJitPass::visit_interlog( BranchStatement& value, libcjel_ir::Context& cxt )
+
+static void traverse(
+    Value& value, const std::function< void( libcjel_ir::Instruction& ) >& action )
 {
-    TRACE( "" );
+    std::unordered_set< Value* > visiting;
+    traverse( value, action, visiting );
 }
-void CjelIRToAsmJitPass::visit_epilog( BranchStatement& value, libcjel_ir::Context& cxt )
+
+/**
+   number of instructions executed by 'value'
+*/
+static u64 statement_cost( Value& value )
 {
-    TRACE( "" );
+    u64 cost = 0;
+    traverse( value, [&]( libcjel_ir::Instruction& ) { cost++; } );
+    return cost;
 }
 
-//
-// LoopStatement
-//
-
-void CjelIRToAsmJitPass::visit_prolog( LoopStatement& value, libcjel_ir::Context& cxt )
+/**
+   upper bound of the number of words stored by 'value'
+*/
+static u64 store_count( Value& value )
 {
-    TRACE( "" );
-    FIXME();
+    u64 count = 0;
+    traverse( value, [&]( libcjel_ir::Instruction& instruction ) {
+        if( isa< StoreInstruction >( instruction ) )
+        {
+            const auto& type = instruction.operand( 0 )->type();
+            count += type.isBit() ? ( type.bitsize() + 63 ) / 64 : 1;
+        }
+    } );
+    return count;
 }
-void CjelIRToAsmJitPass::visit_interlog( LoopStatement& value, libcjel_ir::Context& cxt )
+
+/**
+   maximum number of instructions of an unrolled loop body
+*/
+static constexpr u64 UNROLL_BUDGET = 256;
+
+/**
+   true if 'a' and 'b' extract the same constant element of the same base
+*/
+static u1 same_location( Value& a, Value& b )
 {
-    TRACE( "" );
+    if( not isa< ExtractInstruction >( a ) or not isa< ExtractInstruction >( b ) )
+    {
+        return false;
+    }
+
+    auto& x = static_cast< ExtractInstruction& >( a );
+    auto& y = static_cast< ExtractInstruction& >( b );
+
+    if( x.operand( 0 ) != y.operand( 0 ) or not isa< BitConstant >( x.operand( 1 ) ) or
+        not isa< BitConstant >( y.operand( 1 ) ) )
+    {
+        return false;
+    }
+
+    return static_cast< BitConstant& >( *x.operand( 1 ) ).value().value() ==
+           static_cast< BitConstant& >( *y.operand( 1 ) ).value().value();
 }
-void CjelIRToAsmJitPass::visit_epilog( LoopStatement& value, libcjel_ir::Context& cxt )
+
+/**
+   detects a counted loop 'while( x != end ) { ...; x := x + 1 }' where 'end'
+   is not defined by the loop, 'x' is stored exactly once and the loop has no
+   calls or nested control flow, returns the load of 'x' in the condition
+*/
+static LoadInstruction* counted( LoopStatement& value, Value*& end )
 {
-    TRACE( "" );
-}
+    if( value.instructions().empty() or not isa< NeqInstruction >( value.instructions().back() ) )
+    {
+        return nullptr;
+    }
 
-//
-// CallInstruction
-//
+    std::unordered_set< Value* > defined;
+    std::vector< StoreInstruction* > stores;
+    u1 result = true;
 
-void CjelIRToAsmJitPass::visit_prolog( CallInstruction& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    Context& c = static_cast< Context& >( cxt );
+    value.iterate( Traversal::PREORDER, [&]( Value& node ) {
+        if( &node != &value and isa< Statement >( node ) and not isa< TrivialStatement >( node ) )
+        {
+            result = false;
+        }
+        else if( isa< CallInstruction >( node ) )
+        {
+            result = false;
+        }
+        else if( isa< StoreInstruction >( node ) )
+        {
+            stores.emplace_back( &static_cast< StoreInstruction& >( node ) );
+        }
 
-    assert( c.hasCallable( value.callee().get() ) );
-    Context::Callable& callee = c.callable( value.callee().get() );
+        if( isa< libcjel_ir::Instruction >( node ) )
+        {
+            defined.emplace( &node );
+        }
+    } );
 
-    alloc_reg_for_value( value, c );
+    if( not result )
+    {
+        return nullptr;
+    }
 
-    for( auto v : value.operands() )
+    auto& condition = static_cast< NeqInstruction& >( *value.instructions().back() );
+    LoadInstruction* load = nullptr;
+
+    for( u32 i = 0; i < 2 and not load; i++ )
     {
-        if( *v == *value.callee() )
+        const auto& lhs = condition.operand( i );
+        const auto& rhs = condition.operand( 1 - i );
+
+        if( isa< LoadInstruction >( lhs ) and not defined.count( rhs.get() ) )
+        {
+            load = static_cast< LoadInstruction* >( lhs.get() );
+            end = rhs.get();
+        }
+    }
+
+    if( not load or not load->type().isBit() or is_wide( load->type() ) )
+    {
+        return nullptr;
+    }
+
+    Value& location = *load->operand( 0 );
+    u32 increments = 0;
+
+    for( auto store : stores )
+    {
+        if( not same_location( *store->operand( 1 ), location ) )
         {
             continue;
         }
 
-        alloc_reg_for_value( *v, c );
+        const auto& src = store->operand( 0 );
+        if( not isa< AddUnsignedInstruction >( src ) )
+        {
+            return nullptr;
+        }
+
+        auto& add = static_cast< AddUnsignedInstruction& >( *src );
+        u1 step = false;
+
+        for( u32 i = 0; i < 2; i++ )
+        {
+            const auto& x = add.operand( i );
+            const auto& one = add.operand( 1 - i );
+
+            if( isa< LoadInstruction >( x ) and
+                same_location( *static_cast< LoadInstruction& >( *x ).operand( 0 ), location ) and
+                isa< BitConstant >( one ) and
+                static_cast< BitConstant& >( *one ).value().value() == 1 )
+            {
+                step = true;
+            }
+        }
+
+        if( not step )
+        {
+            return nullptr;
+        }
+
+        increments++;
     }
 
-    X86Gp fp = c.compiler().newIntPtr( value.callee()->label().c_str() );
-    c.compiler().mov( fp, imm_ptr( callee.funcptr() ) );
-    CCFuncCall* call = c.compiler().call( fp, callee.funcsig() );
+    return increments == 1 ? load : nullptr;
+}
 
-    VERBOSE( "call( %s ) --> %lu", value.callee()->label().c_str(), (u64)callee.funcptr() );
+/**
+   minimum number of recorded executions of a branch statement before its
+   counts replace the static estimates
+*/
+static constexpr u64 PROFILE_THRESHOLD = 16;
+
+/**
+   maximum measured probability in percent of a scope placed out of line
+*/
+static constexpr u64 COLD_PERCENT = 5;
+
+/**
+   inline budget multiplier for callees called at least once per recorded
+   invocation of the compiled callable
+*/
+static constexpr u64 HOT_INLINE_FACTOR = 4;
+
+/**
+   maximum number of elements of an allocation kept in registers
+*/
+static constexpr u32 SCALAR_ELEMENTS = 4;
+
+/**
+   maximum number of arguments of a compiled entry point, the ones behind the
+   integer argument registers are passed on the stack
+*/
+static constexpr u32 ENTRY_ARGUMENTS = 8;
+
+/**
+   bytes of one stream of a batch entry point, a 'base' and a 'stride' word
+*/
+static constexpr u32 STREAM_SIZE = 16;
+
+/**
+   probability in percent that the first scope of the branch 'value' is
+   executed, 'measured' is set if it is taken from recorded branch counts
+*/
+static u64 branch_probability( BranchStatement& value, Runtime& runtime, u1& measured )
+{
+    const auto counts = runtime.branchCounts( &value );
+    const u64 total = ( *counts )[ 1 ];
 
-    u32 i = 0;
-    for( i = 1; i < value.operands().size(); i++ )
+    measured = total >= PROFILE_THRESHOLD;
+    if( measured )
     {
-        call->setArg( ( i - 1 ), c.val2reg()[ value.operands()[ i ].get() ] );
-        VERBOSE( "call->setArg( %u, %s )", i - 1, value.operands()[ i ]->label().c_str() );
+        return std::min< u64 >( ( *counts )[ 0 ], total ) * 100 / total;
+    }
+
+    // equalities rarely hold and scopes which call other code are mostly
+    // error handling
+    u64 probability = 50;
+
+    const auto& condition = value.instructions().back();
+    if( isa< EquInstruction >( condition ) )
+    {
+        probability = 30;
+    }
+    else if( isa< NeqInstruction >( condition ) )
+    {
+        probability = 70;
+    }
+
+    const auto calls = [&]( Value& scope ) {
+        u1 result = false;
+        scope.iterate( Traversal::PREORDER, [&]( Value& node ) {
+            result = result or isa< CallInstruction >( node );
+        } );
+        return result;
+    };
+
+    const u1 first = calls( *value.scopes()[ 0 ] );
+    const u1 second = value.scopes().size() > 1 and calls( *value.scopes()[ 1 ] );
+
+    if( first and not second )
+    {
+        probability = std::min< u64 >( probability, 20 );
+    }
+    else if( second and not first )
+    {
+        probability = std::max< u64 >( probability, 80 );
     }
+
+    return probability;
 }
-void CjelIRToAsmJitPass::visit_epilog( CallInstruction& value, libcjel_ir::Context& cxt )
+
+/**
+   emits an atomic increment of 'counter' of the profile counters 'owner',
+   which the context keeps for the code, forked statements may count the
+   same one concurrently
+*/
+static void count( std::atomic< u64 >& counter,
+    const std::shared_ptr< void >& owner,
+    CjelIRToAsmJitPass::Context& c )
 {
+    c.counters().emplace_back( owner );
+
+    X86Gp ptr = c.compiler().newUIntPtr( "counter" );
+    c.compiler().mov( ptr, imm_ptr( &counter ) );
+    c.compiler().lock().add( x86::qword_ptr( ptr ), 1 );
 }
 
-//
-// IdCallInstruction
-//
+static void count( const Runtime::Counter& counter, CjelIRToAsmJitPass::Context& c )
+{
+    count( *counter, counter, c );
+}
 
-void CjelIRToAsmJitPass::visit_prolog( IdCallInstruction& value, libcjel_ir::Context& cxt )
+/**
+   called by the code of a parallel scope to execute its forked statements
+*/
+static void fork_join( ThreadPool* pool, const ThreadPool::Task* tasks, u64 count )
 {
-    TRACE( "" );
-    FIXME();
+    pool->run( tasks, count );
 }
-void CjelIRToAsmJitPass::visit_epilog( IdCallInstruction& value, libcjel_ir::Context& cxt )
+
+/**
+   called by the code of a scope which collects its updates
+*/
+static UpdateSet* begin_updates(
+    Runtime* runtime, u64 capacity, UpdateSet* outer, u64 sequential )
 {
+    UpdateSet* set = runtime->acquire( capacity );
+    set->setSequential( sequential );
+    set->setOuter( outer );
+    return set;
 }
 
-//
-// StreamInstruction
-//
+static void update_word( UpdateSet* set, void* location, u64 value, u64 size )
+{
+    set->insert( location, value, size );
+}
 
-void CjelIRToAsmJitPass::visit_prolog( StreamInstruction& value, libcjel_ir::Context& cxt )
+static u64 read_word( UpdateSet* set, void* location, u64 size, u64 value )
 {
-    TRACE( "" );
-    FIXME();
+    return set->read( location, size, value );
 }
-void CjelIRToAsmJitPass::visit_epilog( StreamInstruction& value, libcjel_ir::Context& cxt )
+
+static void commit_updates( Runtime* runtime, UpdateSet* set, UpdateSet* outer )
 {
+    runtime->commit( set, outer );
+}
+
+void CjelIRToAsmJitPass::alloc_reg_for_value( Value& value, Context& c )
+{
+    const auto& type = value.type();
+
+    if( c.val2reg().has( &value ) or c.scalars().count( &value ) or c.vectors().count( &value ) )
+    {
+        // already allocated!
+        return;
+    }
+
+    if( isa< Reference >( value ) )
+    {
+        Context::Callable& func = c.callable();
+
+        c.val2reg()[&value ] = c.compiler().newUIntPtr( value.label().c_str() );
+        VERBOSE( "newUIntPtr" );
+
+        c.compiler().setArg( func.argsize( 1 ) - 1, c.val2reg()[&value ] );
+        VERBOSE( "setArg( %u, %s )", func.argsize() - 1, value.label().c_str() );
+
+        return;
+    }
+
+    if( isa< StringConstant >( value ) )
+    {
+        c.val2reg()[&value ] = c.compiler().newUIntPtr( value.label().c_str() );
+        VERBOSE( "newUIntPtr" );
+
+        visit_prolog( static_cast< StringConstant& >( value ),
+            static_cast< libcjel_ir::Context& >( c ) );
+        return;
+    }
+
+    if( isa< AllocInstruction >( value ) )
+    {
+        u32 byte_size = calc_byte_size( type );
+
+        c.val2reg()[&value ] = c.compiler().newUIntPtr( value.label().c_str() );
+        VERBOSE( "newUIntPtr" );
+
+        c.compiler().lea( c.val2reg()[&value ], slot( byte_size, c ) );
+        VERBOSE( "lea %s, slot( %u ) ;; alloc", value.label().c_str(), byte_size );
+
+        zero( c.val2reg()[&value ], byte_size, c );
+        VERBOSE( "zero( %s, %u )", value.label().c_str(), byte_size );
+        return;
+    }
+
+    switch( type.id() )
+    {
+        case libcjel_ir::Type::BIT:
+        {
+            if( type.bitsize() < 1 )
+            {
+                assert( not" bit type has invalid bit-size of '0' " );
+            }
+            else if( type.bitsize() <= 8 )
+            {
+                c.val2reg()[&value ] = c.compiler().newU8( value.label().c_str() );
+                VERBOSE( "newU8" );
+            }
+            else if( type.bitsize() <= 16 )
+            {
+                c.val2reg()[&value ] = c.compiler().newU16( value.label().c_str() );
+                VERBOSE( "newU16" );
+            }
+            else if( type.bitsize() <= 32 )
+            {
+                c.val2reg()[&value ] = c.compiler().newU32( value.label().c_str() );
+                VERBOSE( "newU32" );
+            }
+            else if( type.bitsize() <= 64 )
+            {
+                c.val2reg()[&value ] = c.compiler().newU64( value.label().c_str() );
+                VERBOSE( "newU64" );
+            }
+            else
+            {
+                // wide values live in limbs on the stack and are accessed by pointer
+                const u32 byte_size = calc_byte_size( type );
+
+                c.val2reg()[&value ] = c.compiler().newUIntPtr( value.label().c_str() );
+                VERBOSE( "newUIntPtr" );
+
+                if( not isa< Constant >( value ) )
+                {
+                    // constant limbs are read from the pool
+                    c.compiler().lea( c.val2reg()[&value ], slot( byte_size, c ) );
+                    VERBOSE( "lea %s, slot( %u ) ;; limbs", value.label().c_str(), byte_size );
+                }
+            }
+            break;
+        }
+        case libcjel_ir::Type::VECTOR:
+        {
+            if( in_vector_register( type ) and not isa< Constant >( value ) )
+            {
+                c.vectors()[&value ] = new_reg_for_vector_type( type, value.label().c_str(), c );
+                return;
+            }
+
+            c.val2reg()[&value ] = c.compiler().newUIntPtr( value.label().c_str() );
+            VERBOSE( "newUIntPtr" );
+            break;
+        }
+        case libcjel_ir::Type::STRUCTURE:
+        {
+            c.val2reg()[&value ] = c.compiler().newUIntPtr( value.label().c_str() );
+            VERBOSE( "newUIntPtr" );
+            break;
+        }
+        default:
+        {
+            fprintf(
+                stderr,
+                "unsupported type '%s' to allocate a register!\n",
+                type.description().c_str() );
+            assert( 0 );
+            break;
+        }
+    }
+
+    // fprintf( stderr,  "alloc '%p' for '%s' of type '%s'",
+    //     &c.val2reg()[&value ],
+    //     value.label(),
+    //     value.type().name() );
+
+    if( isa< Constant >( value ) )
+    {
+        switch( value.id() )
+        {
+            case Value::BIT_CONSTANT:
+            {
+                visit_prolog(
+                    static_cast< BitConstant& >( value ),
+                    static_cast< libcjel_ir::Context& >( c ) );
+                break;
+            }
+            case Value::STRUCTURE_CONSTANT:
+            {
+                visit_prolog(
+                    static_cast< StructureConstant& >( value ),
+                    static_cast< libcjel_ir::Context& >( c ) );
+                break;
+            }
+            default:
+            {
+                fprintf(
+                    stderr,
+                    "unsupported constant value of type '%s' to allocate a "
+                    "register!\n",
+                    type.description().c_str() );
+                assert( 0 );
+                break;
+            }
+        }
+    }
+}
+
+u1 CjelIRToAsmJitPass::fold( Value& value, Context& c )
+{
+    if( not NativeEvaluator::foldable( value ) )
+    {
+        return false;
+    }
+
+    for( auto operand : static_cast< libcjel_ir::Instruction& >( value ).operands() )
+    {
+        if( c.val2reg().has( operand.get() ) )
+        {
+            // operand is an input or already materialized
+            return false;
+        }
+    }
+
+    const u64 result = NativeEvaluator::evaluate( static_cast< OperatorInstruction& >( value ) );
+
+    alloc_reg_for_value( value, c );
+
+    c.compiler().mov( c.val2reg()[&value ], asmjit::imm_u( result ) );
+    VERBOSE( "mov %s, imm( %lu ) ;; folded", value.label().c_str(), result );
+
+    return true;
+}
+
+void CjelIRToAsmJitPass::visit_prolog( Module& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    c.reset();
+    c.setModule( true );
+    c.symbols().clear();
+
+    // declare all callables upfront to resolve calls independent of their order
+    for( const auto& function : value.get< Function >() )
+    {
+        declare( *function, c );
+    }
+
+    for( const auto& intrinsic : value.get< Intrinsic >() )
+    {
+        declare( *intrinsic, c );
+    }
+}
+void CjelIRToAsmJitPass::visit_epilog( Module& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    c.setModule( false );
+
+    if( not value.has< Function >() and not value.has< Intrinsic >() )
+    {
+        return;
+    }
+
+    u8* base = static_cast< u8* >( link( value, c ) );
+
+    const auto symbol = [&]( CallableUnit& callable ) {
+        // forwarding callables share the entry point of their final callee
+        Context::Callable& code = c.callable( &target( callable ) );
+        Context::Callable& func = c.callable( &callable );
+
+        u8* entry = base + c.codeholder().getLabelOffset( code.func()->getLabel() );
+        func.funcptr( reinterpret_cast< void** >( entry ) );
+
+        c.symbols()[ callable.name() ] = entry;
+    };
+
+    for( const auto& function : value.get< Function >() )
+    {
+        symbol( *function );
+    }
+
+    for( const auto& intrinsic : value.get< Intrinsic >() )
+    {
+        symbol( *intrinsic );
+    }
 }
 
 //
-// NopInstruction
+// Function
 //
 
-void CjelIRToAsmJitPass::visit_prolog( NopInstruction& value, libcjel_ir::Context& cxt )
+void CjelIRToAsmJitPass::visit_prolog( Function& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    callable_prolog( value, static_cast< Context& >( cxt ) );
+}
+void CjelIRToAsmJitPass::visit_interlog( Function& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    callable_interlog( value, static_cast< Context& >( cxt ) );
+}
+void CjelIRToAsmJitPass::visit_epilog( Function& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    callable_epilog( value, static_cast< Context& >( cxt ) );
+}
+
+//
+// Intrinsic
+//
+
+void CjelIRToAsmJitPass::visit_prolog( Intrinsic& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    callable_prolog( value, static_cast< Context& >( cxt ) );
+}
+void CjelIRToAsmJitPass::visit_interlog( Intrinsic& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    callable_interlog( value, static_cast< Context& >( cxt ) );
+}
+void CjelIRToAsmJitPass::visit_epilog( Intrinsic& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    callable_epilog( value, static_cast< Context& >( cxt ) );
+}
+
+//
+// Reference
+//
+
+void CjelIRToAsmJitPass::visit_prolog( Reference& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+    Context::Callable& func = c.callable();
+    FuncSignatureX& fsig = func.funcsig();
+    fsig.addArg( TypeId::kUIntPtr );
+}
+void CjelIRToAsmJitPass::visit_epilog( Reference& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// Structure
+//
+
+void CjelIRToAsmJitPass::visit_prolog( Structure& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    FIXME();
+}
+void CjelIRToAsmJitPass::visit_epilog( Structure& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+}
+
+//
+// Variable
+//
+
+void CjelIRToAsmJitPass::visit_prolog( Variable& value, libcjel_ir::Context& cxt )
 {
     TRACE( "" );
+    FIXME();
+}
+void CjelIRToAsmJitPass::visit_epilog( Variable& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+}
+
+//
+// Memory
+//
+
+void CjelIRToAsmJitPass::visit_prolog( libcjel_ir::Memory& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    FIXME();
+}
+void CjelIRToAsmJitPass::visit_epilog( libcjel_ir::Memory& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+}
+
+//
+// ParallelScope
+//
+
+void CjelIRToAsmJitPass::visit_prolog( ParallelScope& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    enter_scope( c );
+
+    Context::Fork fork{
+        forkable( value, c ), nullptr, {}, {}, false, X86Gp(), c.live().size(), false };
+
+    if( c.runtime().parallelUpdates() )
+    {
+        // the capacity is a hint, stores in loops may exceed it
+        open_updates( fork, std::max< u64 >( store_count( value ) * 2, 1 ), false, c );
+        VERBOSE( "call( begin_updates ) ;; parallel" );
+    }
+
+    c.forks().emplace_back( std::move( fork ) );
+}
+void CjelIRToAsmJitPass::visit_epilog( ParallelScope& value, libcjel_ir::Context& cxt )
+{
+    Context& c = static_cast< Context& >( cxt );
+
+    assert( not c.forks().empty() and not c.forks().back().cursor );
+    Context::Fork fork = std::move( c.forks().back() );
+    c.forks().pop_back();
+
+    if( not fork.tasks.empty() )
+    {
+        spawn( fork, c );
+    }
+
+    if( fork.deferred )
+    {
+        close_updates( fork, c );
+        VERBOSE( "call( commit_updates ) ;; parallel" );
+    }
+
+    leave_scope( c );
+    release( fork.slots, c );
+}
+
+//
+// SequentialScope
+//
+
+void CjelIRToAsmJitPass::visit_prolog( SequentialScope& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    enter_scope( c );
+
+    Context::Fork fork{ false, nullptr, {}, {}, false, X86Gp(), c.live().size(), false };
+
+    if( c.updates() )
+    {
+        // the statements see the stores of the previous ones, so the scope
+        // collects them in a layer which is committed as a whole
+        open_updates( fork, std::max< u64 >( store_count( value ) * 2, 1 ), true, c );
+        VERBOSE( "call( begin_updates ) ;; sequential" );
+    }
+
+    c.forks().emplace_back( std::move( fork ) );
+}
+void CjelIRToAsmJitPass::visit_epilog( SequentialScope& value, libcjel_ir::Context& cxt )
+{
+    Context& c = static_cast< Context& >( cxt );
+
+    assert( not c.forks().empty() );
+    Context::Fork fork = std::move( c.forks().back() );
+    c.forks().pop_back();
+
+    if( fork.deferred )
+    {
+        close_updates( fork, c );
+        VERBOSE( "call( commit_updates ) ;; sequential" );
+    }
+
+    leave_scope( c );
+    release( fork.slots, c );
+}
+
+//
+// TrivialStatement
+//
+
+void CjelIRToAsmJitPass::visit_prolog( TrivialStatement& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    if( c.forks().empty() or not c.forks().back().parallel or
+        statement_cost( value ) < c.runtime().parallelGrain() )
+    {
+        return;
+    }
+
+    Context::Fork& fork = c.forks().back();
+    Context::Task task{ &value, nullptr, {}, false, false };
+
+    // the statement is still visited to keep the traversal intact, but its
+    // code is dropped in the epilog and compiled again as a task function
+    std::unordered_set< Value* > defined;
+    value.iterate( Traversal::PREORDER, [&]( Value& node ) {
+        if( isa< libcjel_ir::Instruction >( node ) )
+        {
+            defined.emplace( &node );
+        }
+    } );
+
+    std::unordered_set< Value* > seen;
+    value.iterate( Traversal::PREORDER, [&]( Value& node ) {
+        if( not isa< libcjel_ir::Instruction >( node ) )
+        {
+            return;
+        }
+
+        for( auto operand : static_cast< libcjel_ir::Instruction& >( node ).operands() )
+        {
+            Value* v = operand.get();
+
+            if( isa< CallableUnit >( v ) or isa< Constant >( v ) or defined.count( v ) or
+                not seen.emplace( v ).second )
+            {
+                continue;
+            }
+
+            task.captures.emplace_back( v );
+        }
+    } );
+
+    // constants first materialized by the dropped code, including the ones
+    // of inlined callee bodies
+    traverse( value, [&]( libcjel_ir::Instruction& instruction ) {
+        for( auto operand : instruction.operands() )
+        {
+            if( isa< Constant >( operand ) and not c.val2reg().has( operand.get() ) and
+                not c.val2mem().has( operand.get() ) and seen.emplace( operand.get() ).second )
+            {
+                fork.constants.emplace_back( operand.get() );
+            }
+        }
+    } );
+
+    task.func = c.compiler().newFunc( FuncSignature1< void, void* >( CallConv::kIdHost ) );
+    VERBOSE( "newFunc( %s ) ;; task", value.label().c_str() );
+
+    fork.cursor = c.compiler().getCursor();
+    fork.tasks.emplace_back( std::move( task ) );
+}
+void CjelIRToAsmJitPass::visit_epilog( TrivialStatement& value, libcjel_ir::Context& cxt )
+{
+    Context& c = static_cast< Context& >( cxt );
+
+    if( c.forks().empty() or not c.forks().back().cursor )
+    {
+        return;
+    }
+
+    Context::Fork& fork = c.forks().back();
+
+    CBNode* last = c.compiler().getCursor();
+    if( last != fork.cursor )
+    {
+        c.compiler().removeNodes( fork.cursor->getNext(), last );
+    }
+    c.compiler().setCursor( fork.cursor );
+    VERBOSE( "removeNodes ;; forked %s", value.label().c_str() );
+
+    // values materialized by the dropped code are not available anymore
+    for( auto constant : fork.constants )
+    {
+        c.val2reg().erase( constant );
+        c.val2mem().erase( constant );
+    }
+
+    value.iterate( Traversal::PREORDER, [&]( Value& node ) {
+        if( isa< libcjel_ir::Instruction >( node ) )
+        {
+            c.val2reg().erase( &node );
+            c.val2mem().erase( &node );
+            c.vectors().erase( &node );
+        }
+    } );
+
+    fork.cursor = nullptr;
+    fork.constants.clear();
+}
+
+//
+// BranchStatement
+//
+
+void CjelIRToAsmJitPass::visit_prolog( BranchStatement& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    assert( not value.scopes().empty() and value.scopes().size() <= 2 );
+
+    Context::Control control{ &value,
+        c.forks().size(),
+        c.inlining().size(),
+        c.promotions().size(),
+        { c.compiler().newLabel(), c.compiler().newLabel() },
+        0,
+        false,
+        false,
+        false,
+        false,
+        nullptr,
+        nullptr };
+
+    if( convertible( value, c ) )
+    {
+        control.predicated = true;
+        VERBOSE( "predicate %s", value.label().c_str() );
+    }
+    else
+    {
+        hoist( value, c );
+
+        u1 measured = false;
+        const u64 probability = branch_probability( value, c.runtime(), measured );
+        const u1 pair = value.scopes().size() == 2;
+
+        // scopes of cold code are not nested into each other
+        u1 nested = false;
+        for( const auto& outer : c.controls() )
+        {
+            nested = nested or ( outer.cold and outer.resume );
+        }
+
+        // a single scope is only moved if it is placed out of line
+        control.cold = measured and not nested and
+                       ( probability <= COLD_PERCENT or
+                           ( pair and probability >= 100 - COLD_PERCENT ) );
+        control.swapped = probability < 50 and ( pair or control.cold );
+
+        VERBOSE(
+            "layout %s ;; %lu%%%s%s",
+            value.label().c_str(),
+            probability,
+            control.swapped ? " swapped" : "",
+            control.cold ? " cold" : "" );
+    }
+
+    c.controls().emplace_back( std::move( control ) );
+}
+void CjelIRToAsmJitPass::visit_interlog( BranchStatement& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+}
+void CjelIRToAsmJitPass::visit_epilog( BranchStatement& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    assert( not c.controls().empty() and c.controls().back().statement == &value );
+    Context::Control control = std::move( c.controls().back() );
+    c.controls().pop_back();
+
+    if( control.predicated )
+    {
+        return;
+    }
+
+    if( value.scopes().size() == 1 and not control.swapped )
+    {
+        c.compiler().bind( control.labels[ 0 ] );
+    }
+
+    c.compiler().bind( control.labels[ 1 ] );
+    VERBOSE( "bind end ;; branch" );
+}
+
+//
+// LoopStatement
+//
+
+void CjelIRToAsmJitPass::visit_prolog( LoopStatement& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    const std::size_t promotions = c.promotions().size();
+
+    hoist( value, c );
+
+    if( c.isInstrumented() )
+    {
+        count( c.runtime().loopEntries( &value ), c );
+    }
+
+    Value* end = nullptr;
+    LoadInstruction* load = counted( value, end );
+
+    // the counter of a counted loop is held in a register as long as no
+    // other thread or update set can observe its location
+    u1 promotable =
+        load and not c.updates() and ( isa< Constant >( end ) or c.val2reg().has( end ) );
+
+    value.iterate( Traversal::PREORDER, [&]( Value& node ) {
+        if( promotable and isa< ParallelScope >( node ) and forkable( node, c ) )
+        {
+            promotable = false;
+        }
+    } );
+
+    if( promotable )
+    {
+        auto& location = static_cast< ExtractInstruction& >( *load->operand( 0 ) );
+        visit_prolog( location, c );
+
+        Context::Promotion counter{ location.operand( 0 ).get(),
+            static_cast< BitConstant& >( *location.operand( 1 ) ).value().value(),
+            new_reg_for_bit_type( load->type(), "counter", c.compiler() ),
+            c.val2mem()[ &location ] };
+
+        c.compiler().mov( counter.reg, counter.memory );
+        VERBOSE( "mov counter, %s ;; promote", location.label().c_str() );
+
+        c.promotions().emplace_back( counter );
+
+        u64 factor = c.runtime().loopUnroll();
+
+        // loops recorded to run fewer iterations than one unrolled body
+        // would only execute the remaining ones
+        const u64 entries = *c.runtime().loopEntries( &value );
+        if( entries >= PROFILE_THRESHOLD and *c.runtime().backEdges( &value ) / entries < factor )
+        {
+            factor = 1;
+        }
+
+        if( factor > 1 and statement_cost( value ) * factor <= UNROLL_BUDGET )
+        {
+            unroll( value, *end, factor, c.promotions().back(), c );
+        }
+    }
+
+    Context::Control control{ &value,
+        c.forks().size(),
+        c.inlining().size(),
+        promotions,
+        { c.compiler().newLabel(), c.compiler().newLabel() },
+        0,
+        false,
+        false,
+        false,
+        false,
+        nullptr,
+        nullptr };
+
+    c.compiler().bind( control.labels[ 0 ] );
+    VERBOSE( "bind head ;; loop" );
+
+    c.controls().emplace_back( std::move( control ) );
+}
+void CjelIRToAsmJitPass::visit_interlog( LoopStatement& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+}
+void CjelIRToAsmJitPass::visit_epilog( LoopStatement& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    assert( not c.controls().empty() and c.controls().back().statement == &value );
+    Context::Control control = std::move( c.controls().back() );
+    c.controls().pop_back();
+
+    c.compiler().bind( control.labels[ 1 ] );
+    VERBOSE( "bind exit ;; loop" );
+
+    while( c.promotions().size() > control.promotions )
+    {
+        Context::Promotion& counter = c.promotions().back();
+
+        c.compiler().mov( counter.memory, counter.reg );
+        VERBOSE( "mov memory, counter ;; write back" );
+
+        c.promotions().pop_back();
+    }
+}
+
+//
+// CallInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( CallInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    assert( c.hasCallable( value.callee().get() ) );
+
+    if( inlinable( value, c ) )
+    {
+        inline_call( value, c );
+        return;
+    }
+
+    Context::Callable& callee = c.callable( value.callee().get() );
+
+    alloc_reg_for_value( value, c );
+
+    for( auto v : value.operands() )
+    {
+        if( *v == *value.callee() )
+        {
+            continue;
+        }
+
+        alloc_reg_for_value( *v, c );
+    }
+
+    CCFuncCall* call = nullptr;
+
+    auto& target = this->target( static_cast< CallableUnit& >( *value.callee() ) );
+    Context::Callable& direct =
+        c.hasCallable( &target ) ? c.callable( &target ) : c.callable( value.callee().get() );
+
+    if( direct.func() )
+    {
+        // callee lives in the same code holder, emit a direct relative call
+        call = c.compiler().call( direct.func()->getLabel(), callee.funcsig() );
+        c.called().emplace( &target );
+        VERBOSE( "call( %s ) --> %s", value.callee()->label().c_str(), target.label().c_str() );
+    }
+    else
+    {
+        X86Gp fp = c.compiler().newIntPtr( value.callee()->label().c_str() );
+        c.compiler().mov( fp, imm_ptr( callee.funcptr() ) );
+        call = c.compiler().call( fp, callee.funcsig() );
+
+        VERBOSE( "call( %s ) --> %lu", value.callee()->label().c_str(), (u64)callee.funcptr() );
+    }
+
+    u32 i = 0;
+    for( i = 1; i < value.operands().size(); i++ )
+    {
+        call->setArg( ( i - 1 ), c.val2reg()[ value.operands()[ i ].get() ] );
+        VERBOSE( "call->setArg( %u, %s )", i - 1, value.operands()[ i ]->label().c_str() );
+    }
+}
+void CjelIRToAsmJitPass::visit_epilog( CallInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// IdCallInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( IdCallInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    FIXME();
+}
+void CjelIRToAsmJitPass::visit_epilog( IdCallInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// StreamInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( StreamInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    FIXME();
+}
+void CjelIRToAsmJitPass::visit_epilog( StreamInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// NopInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( NopInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+}
+void CjelIRToAsmJitPass::visit_epilog( NopInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// AllocInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( AllocInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    FIXME();
+}
+void CjelIRToAsmJitPass::visit_epilog( AllocInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// IdInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( IdInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    FIXME();
+}
+void CjelIRToAsmJitPass::visit_epilog( IdInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// CastInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( CastInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    FIXME();
+}
+void CjelIRToAsmJitPass::visit_epilog( CastInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// ExtractInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( ExtractInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    auto base = value.operand( 0 );
+    auto offset = value.operand( 1 );
+
+    auto scalar = c.scalars().find( base.get() );
+    if( scalar != c.scalars().end() )
+    {
+        const u64 index = static_cast< BitConstant& >( *offset ).value().value();
+
+        c.val2reg()[&value ] = scalar->second[ index ];
+        VERBOSE( "%s := element( %s, %lu ) ;; scalar", value.label().c_str(),
+            base->label().c_str(), index );
+        return;
+    }
+
+    auto vector = c.vectors().find( base.get() );
+    if( vector != c.vectors().end() )
+    {
+        assert( isa< BitConstant >( offset ) );
+        const u64 index = static_cast< BitConstant& >( *offset ).value().value();
+
+        c.val2reg()[&value ] =
+            extract_lane( vector->second, index, *base->type().results()[ index ], c );
+        VERBOSE( "%s := lane( %s, %lu ) ;; vector", value.label().c_str(),
+            base->label().c_str(), index );
+        return;
+    }
+
+    if( isa< Reference >( base ) and
+        ( base->type().isStructure() or base->type().id() == libcjel_ir::Type::VECTOR ) )
+    {
+        assert( isa< BitConstant >( offset ) );
+        BitConstant& index = static_cast< BitConstant& >( *offset );
+
+        assert(
+            index.value().value() < base->type().results().size() );  // PPA: FIXME: use real
+                                                                      // operator< for: Type < u64
+
+        const u32 byte_offset = element_offset( base->type(), index.value().value() );
+
+        c.val2mem()[&value ] = x86::ptr( c.val2reg()[ base.get() ], byte_offset );
+        VERBOSE(
+            "ptr( %s, %u ) [ '%s' @ %s --> bs = %lu ]",
+            base->label().c_str(),
+            byte_offset,
+            base->type().name().c_str(),
+            index.name().c_str(),
+            base->type()
+                .results()[ index.value().value() ]
+                ->bitsize() );  // PPA: FIXME: index access!!!
+    }
+    else
+    {
+        assert( 0 );
+    }
+}
+void CjelIRToAsmJitPass::visit_epilog( ExtractInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// LoadInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( LoadInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    alloc_reg_for_value( value, c );
+
+    auto src = value.operand( 0 ).get();
+
+    // stores of enclosing sequential scopes may still be held in their layers
+    Context::Fork* fork = c.updates();
+    if( fork and not fork->layered )
+    {
+        fork = nullptr;
+    }
+
+    if( c.vectors().count( &value ) and fork )
+    {
+        const X86Mem memory = isa< ExtractInstruction >( src ) ? c.val2mem()[ src ]
+                                                               : x86::ptr( c.val2reg()[ src ], 0 );
+        const auto& type = value.type();
+        const X86Mem lanes = slot( calc_byte_size( type ), c );
+
+        for( u32 i = 0; i < type.results().size(); i++ )
+        {
+            const u32 byte_size = calc_byte_size( *type.results()[ i ] );
+            const u32 offset = element_offset( type, i );
+
+            X86Mem address = memory;
+            address.addOffset( offset );
+
+            X86Mem lane = lanes;
+            lane.addOffset( offset );
+            lane.setSize( byte_size );
+
+            c.compiler().mov( lane, sub_reg( read( address, byte_size, *fork, c ), byte_size ) );
+        }
+
+        move_vector( c.vectors()[&value ], lanes, calc_byte_size( type ), true, c );
+        VERBOSE( "read %s, %s ;; vector", value.label().c_str(), src->label().c_str() );
+    }
+    else if( c.vectors().count( &value ) )
+    {
+        const X86Mem memory = isa< ExtractInstruction >( src ) ? c.val2mem()[ src ]
+                                                               : x86::ptr( c.val2reg()[ src ], 0 );
+
+        move_vector( c.vectors()[&value ], memory, calc_byte_size( value.type() ), true, c );
+        VERBOSE( "mov %s, %s ;; vector", value.label().c_str(), src->label().c_str() );
+    }
+    else if( auto counter = promoted( *src, c ) )
+    {
+        c.compiler().mov( c.val2reg()[&value ], counter->reg );
+        VERBOSE( "mov %s, counter ;; %s", value.label().c_str(), src->label().c_str() );
+    }
+    else if( isa< ExtractInstruction >( src ) and c.val2reg().has( src ) )
+    {
+        c.compiler().mov( c.val2reg()[&value ], c.val2reg()[ src ] );
+        VERBOSE( "mov %s, %s ;; scalar", value.label().c_str(), src->label().c_str() );
+    }
+    else if( isa< ExtractInstruction >( src ) and is_wide( value.type() ) )
+    {
+        X86Gp ptr = c.compiler().newUIntPtr( "ptr" );
+        c.compiler().lea( ptr, c.val2mem()[ src ] );
+
+        copy( c.val2reg()[&value ], ptr, calc_byte_size( value.type() ), c );
+
+        if( fork )
+        {
+            // deferred updates of wide values are inserted limb by limb
+            for( u32 i = 0; i < limbs( value.type() ); i++ )
+            {
+                X86Gp limb = read( x86::ptr( ptr, i * 8 ), 8, *fork, c );
+                c.compiler().mov( x86::ptr( c.val2reg()[&value ], i * 8 ), limb );
+            }
+        }
+        VERBOSE( "copy( %s, %s )", value.label().c_str(), src->label().c_str() );
+    }
+    else if( isa< ExtractInstruction >( src ) and fork )
+    {
+        const u32 byte_size = calc_byte_size( value.type() );
+
+        X86Gp word = read( c.val2mem()[ src ], byte_size, *fork, c );
+        c.compiler().mov( c.val2reg()[&value ], sub_reg( word, byte_size ) );
+        VERBOSE( "read %s, %s", value.label().c_str(), src->label().c_str() );
+    }
+    else if( isa< ExtractInstruction >( src ) )
+    {
+        c.compiler().mov( c.val2reg()[&value ], c.val2mem()[ src ] );
+        VERBOSE( "mov %s, %s", value.label().c_str(), src->label().c_str() );
+    }
+    else
+    {
+        assert( 0 );
+    }
+}
+void CjelIRToAsmJitPass::visit_epilog( LoadInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// StoreInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( StoreInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    auto src = value.operand( 0 ).get();
+    auto dst = value.operand( 1 ).get();
+
+    alloc_reg_for_value( *src, c );
+
+    Context::Fork* fork = c.updates();
+
+    if( auto branch = predicate( c ) )
+    {
+        auto& statement = static_cast< BranchStatement& >( *branch->statement );
+        const X86Gp& condition = c.val2reg()[ statement.instructions().back().get() ];
+        const u32 byte_size = calc_byte_size( src->type() );
+
+        X86Mem memory = isa< ExtractInstruction >( dst ) ? c.val2mem()[ dst ]
+                                                         : x86::ptr( c.val2reg()[ dst ], 0 );
+        memory.setSize( byte_size );
+
+        // the location keeps its value if the scope is not selected, byte
+        // values are selected as double words as 'cmov' has no byte form
+        X86Gp selected = c.val2reg()[ src ];
+        X86Gp old;
+
+        if( byte_size == 1 )
+        {
+            X86Gp word = c.compiler().newU32( "value" );
+            c.compiler().movzx( word, selected );
+            selected = word;
+
+            old = c.compiler().newU32( "old" );
+            c.compiler().movzx( old, memory );
+        }
+        else
+        {
+            old = new_reg_for_bit_type( src->type(), "old", c.compiler() );
+            c.compiler().mov( old, memory );
+        }
+
+        c.compiler().test( condition, condition );
+
+        if( branch->scope == 0 )
+        {
+            c.compiler().cmovnz( old, selected );
+        }
+        else
+        {
+            c.compiler().cmovz( old, selected );
+        }
+
+        c.compiler().mov( memory, sub_reg( old, byte_size ) );
+        VERBOSE( "cmov %s, %s ;; predicated", dst->label().c_str(), src->label().c_str() );
+    }
+    else if( auto counter = promoted( *dst, c ) )
+    {
+        c.compiler().mov( counter->reg, c.val2reg()[ src ] );
+        VERBOSE( "mov counter, %s ;; %s", src->label().c_str(), dst->label().c_str() );
+    }
+    else if( c.scalars().count( dst ) or
+             ( isa< ExtractInstruction >( dst ) and c.val2reg().has( dst ) ) )
+    {
+        const X86Gp& element =
+            isa< ExtractInstruction >( dst ) ? c.val2reg()[ dst ] : c.scalars()[ dst ][ 0 ];
+
+        c.compiler().mov( element, c.val2reg()[ src ] );
+        VERBOSE( "mov %s, %s ;; scalar", dst->label().c_str(), src->label().c_str() );
+    }
+    else if( c.vectors().count( src ) )
+    {
+        const X86Mem memory = isa< ExtractInstruction >( dst ) ? c.val2mem()[ dst ]
+                                                               : x86::ptr( c.val2reg()[ dst ], 0 );
+        const auto& type = src->type();
+
+        if( fork )
+        {
+            // deferred updates are inserted element by element
+            for( u32 i = 0; i < type.results().size(); i++ )
+            {
+                const auto& element = *type.results()[ i ];
+                X86Mem address = memory;
+                address.addOffset( element_offset( type, i ) );
+
+                X86Gp ptr = c.compiler().newUIntPtr( "ptr" );
+                c.compiler().lea( ptr, address );
+
+                update( ptr, extract_lane( c.vectors()[ src ], i, element, c ), element, *fork, c );
+            }
+            VERBOSE( "update( %s, %s ) ;; vector", dst->label().c_str(), src->label().c_str() );
+        }
+        else
+        {
+            move_vector( c.vectors()[ src ], memory, calc_byte_size( type ), false, c );
+            VERBOSE( "mov %s, %s ;; vector", dst->label().c_str(), src->label().c_str() );
+        }
+    }
+    else if( fork and ( isa< ExtractInstruction >( dst ) or isa< Reference >( dst ) ) )
+    {
+        X86Gp ptr;
+
+        if( isa< ExtractInstruction >( dst ) )
+        {
+            ptr = c.compiler().newUIntPtr( "ptr" );
+            c.compiler().lea( ptr, c.val2mem()[ dst ] );
+        }
+        else
+        {
+            ptr = c.val2reg()[ dst ];
+        }
+
+        update( ptr, c.val2reg()[ src ], src->type(), *fork, c );
+        VERBOSE( "update( %s, %s )", dst->label().c_str(), src->label().c_str() );
+    }
+    else if( is_wide( src->type() ) and
+             ( isa< ExtractInstruction >( dst ) or isa< Reference >( dst ) ) )
+    {
+        X86Gp ptr;
+
+        if( isa< ExtractInstruction >( dst ) )
+        {
+            ptr = c.compiler().newUIntPtr( "ptr" );
+            c.compiler().lea( ptr, c.val2mem()[ dst ] );
+        }
+        else
+        {
+            ptr = c.val2reg()[ dst ];
+        }
+
+        copy( ptr, c.val2reg()[ src ], calc_byte_size( src->type() ), c );
+        VERBOSE( "copy( %s, %s )", dst->label().c_str(), src->label().c_str() );
+    }
+    else if( isa< ExtractInstruction >( dst ) )
+    {
+        c.compiler().mov( c.val2mem()[ dst ], c.val2reg()[ src ] );
+        VERBOSE(
+            "mov %s, %s (%s)", dst->label().c_str(), src->label().c_str(), src->name().c_str() );
+    }
+    else if( isa< Reference >( dst ) and dst->type().isBit() )
+    {
+        c.compiler().mov( x86::ptr( c.val2reg()[ dst ], 0 ), c.val2reg()[ src ] );
+        VERBOSE(
+            "mov ptr( %s ), %s (%s)",
+            dst->label().c_str(),
+            src->label().c_str(),
+            src->name().c_str() );
+    }
+    else
+    {
+        assert( not" unsupported 'store' instruction usage! " );
+    }
+}
+void CjelIRToAsmJitPass::visit_epilog( StoreInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// NotInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( NotInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    if( fold( value, c ) )
+    {
+        return;
+    }
+
+    if( lanewise( value, c ) )
+    {
+        return;
+    }
+
+    if( is_wide( value.type() ) )
+    {
+        limbwise( X86Inst::kIdNot, X86Inst::kIdNot, value, *value.operand( 0 ), nullptr, c );
+        return;
+    }
+
+    auto res = &value;
+    auto lhs = value.operand( 0 ).get();
+
+    alloc_reg_for_value( *res, c );
+    alloc_reg_for_value( *lhs, c );
+
+    c.compiler().mov( c.val2reg()[ res ], c.val2reg()[ lhs ] );
+    VERBOSE( "mov %s, %s", res->label().c_str(), lhs->label().c_str() );
+
+    c.compiler().not_( c.val2reg()[ res ] );
+    VERBOSE( "not_ %s", res->label().c_str() );
+}
+void CjelIRToAsmJitPass::visit_epilog( NotInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// LnotInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( LnotInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    if( fold( value, c ) )
+    {
+        return;
+    }
+
+    compare( value, *value.operand( 0 ), nullptr, X86Inst::kCondE, c );
+}
+void CjelIRToAsmJitPass::visit_epilog( LnotInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// AndInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( AndInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    if( fold( value, c ) )
+    {
+        return;
+    }
+
+    if( lanewise( value, c ) )
+    {
+        return;
+    }
+
+    if( is_wide( value.type() ) )
+    {
+        limbwise(
+            X86Inst::kIdAnd,
+            X86Inst::kIdAnd,
+            value,
+            *value.operand( 0 ),
+            value.operand( 1 ).get(),
+            c );
+        return;
+    }
+
+    auto res = &value;
+    auto lhs = value.operand( 0 ).get();
+    auto rhs = value.operand( 1 ).get();
+
+    alloc_reg_for_value( *res, c );
+    alloc_reg_for_value( *lhs, c );
+    alloc_reg_for_value( *rhs, c );
+
+    c.compiler().mov( c.val2reg()[ res ], c.val2reg()[ lhs ] );
+    VERBOSE( "mov %s, %s", res->label().c_str(), lhs->label().c_str() );
+
+    c.compiler().and_( c.val2reg()[ res ], c.val2reg()[ rhs ] );
+    VERBOSE( "and_ %s, %s", res->label().c_str(), rhs->label().c_str() );
+}
+void CjelIRToAsmJitPass::visit_epilog( AndInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// OrInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( OrInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    if( fold( value, c ) )
+    {
+        return;
+    }
+
+    if( lanewise( value, c ) )
+    {
+        return;
+    }
+
+    if( is_wide( value.type() ) )
+    {
+        limbwise(
+            X86Inst::kIdOr,
+            X86Inst::kIdOr,
+            value,
+            *value.operand( 0 ),
+            value.operand( 1 ).get(),
+            c );
+        return;
+    }
+
+    const auto res = &value;
+    const auto lhs = value.operand( 0 ).get();
+    const auto rhs = value.operand( 1 ).get();
+
+    alloc_reg_for_value( *res, c );
+    alloc_reg_for_value( *lhs, c );
+    alloc_reg_for_value( *rhs, c );
+
+    c.compiler().mov( c.val2reg()[ res ], c.val2reg()[ lhs ] );
+    VERBOSE( "mov %s, %s", res->label().c_str(), lhs->label().c_str() );
+
+    c.compiler().or_( c.val2reg()[ res ], c.val2reg()[ rhs ] );
+    VERBOSE( "or_ %s, %s", res->label().c_str(), rhs->label().c_str() );
+}
+void CjelIRToAsmJitPass::visit_epilog( OrInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// XorInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( XorInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    if( fold( value, c ) )
+    {
+        return;
+    }
+
+    if( lanewise( value, c ) )
+    {
+        return;
+    }
+
+    if( is_wide( value.type() ) )
+    {
+        limbwise(
+            X86Inst::kIdXor,
+            X86Inst::kIdXor,
+            value,
+            *value.operand( 0 ),
+            value.operand( 1 ).get(),
+            c );
+        return;
+    }
+
+    const auto res = &value;
+    const auto lhs = value.operand( 0 ).get();
+    const auto rhs = value.operand( 1 ).get();
+
+    alloc_reg_for_value( *res, c );
+    alloc_reg_for_value( *lhs, c );
+    alloc_reg_for_value( *rhs, c );
+
+    c.compiler().mov( c.val2reg()[ res ], c.val2reg()[ lhs ] );
+    VERBOSE( "mov %s, %s", res->label().c_str(), lhs->label().c_str() );
+
+    c.compiler().xor_( c.val2reg()[ res ], c.val2reg()[ rhs ] );
+    VERBOSE( "xor_ %s, %s", res->label().c_str(), rhs->label().c_str() );
+}
+void CjelIRToAsmJitPass::visit_epilog( XorInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// AddUnsignedInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( AddUnsignedInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    if( fold( value, c ) )
+    {
+        return;
+    }
+
+    if( lanewise( value, c ) )
+    {
+        return;
+    }
+
+    if( is_wide( value.type() ) )
+    {
+        limbwise(
+            X86Inst::kIdAdd,
+            X86Inst::kIdAdc,
+            value,
+            *value.operand( 0 ),
+            value.operand( 1 ).get(),
+            c );
+        return;
+    }
+
+    const auto res = &value;
+    const auto lhs = value.operand( 0 ).get();
+    const auto rhs = value.operand( 1 ).get();
+
+    alloc_reg_for_value( *res, c );
+    alloc_reg_for_value( *lhs, c );
+    alloc_reg_for_value( *rhs, c );
+
+    c.compiler().mov( c.val2reg()[ res ], c.val2reg()[ lhs ] );
+    VERBOSE( "mov %s, %s", res->label().c_str(), lhs->label().c_str() );
+
+    c.compiler().add( c.val2reg()[ res ], c.val2reg()[ rhs ] );
+    VERBOSE( "add %s, %s", res->label().c_str(), rhs->label().c_str() );
+}
+void CjelIRToAsmJitPass::visit_epilog( AddUnsignedInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// AddSignedInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( AddSignedInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    if( fold( value, c ) )
+    {
+        return;
+    }
+
+    if( is_wide( value.type() ) )
+    {
+        limbwise(
+            X86Inst::kIdAdd,
+            X86Inst::kIdAdc,
+            value,
+            *value.operand( 0 ),
+            value.operand( 1 ).get(),
+            c );
+        return;
+    }
+
+    const auto res = &value;
+    const auto lhs = value.operand( 0 ).get();
+    const auto rhs = value.operand( 1 ).get();
+
+    alloc_reg_for_value( *res, c );
+    alloc_reg_for_value( *lhs, c );
+    alloc_reg_for_value( *rhs, c );
+
+    c.compiler().mov( c.val2reg()[ res ], c.val2reg()[ lhs ] );
+    VERBOSE( "mov %s, %s", res->label().c_str(), lhs->label().c_str() );
+
+    c.compiler().add( c.val2reg()[ res ], c.val2reg()[ rhs ] );
+    VERBOSE( "add %s, %s", res->label().c_str(), rhs->label().c_str() );
+}
+void CjelIRToAsmJitPass::visit_epilog( AddSignedInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// DivSignedInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( DivSignedInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    if( fold( value, c ) )
+    {
+        return;
+    }
+
+    if( is_wide( value.type() ) )
+    {
+        FIXME();
+        return;
+    }
+
+    const auto res = &value;
+    const auto lhs = value.operand( 0 ).get();
+    const auto rhs = value.operand( 1 ).get();
+    const u16 bitsize = lhs->type().bitsize();
+
+    alloc_reg_for_value( *res, c );
+    alloc_reg_for_value( *lhs, c );
+
+    X86Gp x = sign_extend_word( c.val2reg()[ lhs ], bitsize, c.compiler() );
+    X86Gp q;
+
+    const u64 constant = isa< BitConstant >( rhs )
+                             ? static_cast< BitConstant& >( *rhs ).value().value() &
+                                   NativeEvaluator::mask( bitsize )
+                             : 0;
+
+    if( constant )
+    {
+        // sign extension of the constant to the 64-bit word
+        const u32 unused = 64 - bitsize;
+        const i64 divisor = (i64)( constant << unused ) >> unused;
+
+        q = quotient_signed( x, divisor, c.compiler() );
+        VERBOSE( "%s := %s / %li ;; magic", res->label().c_str(), lhs->label().c_str(), divisor );
+    }
+    else if( isa< BitConstant >( rhs ) )
+    {
+        // a division by zero yields zero as in the native evaluator
+        q = c.compiler().newI64( "zero" );
+        c.compiler().xor_( q.r32(), q.r32() );
+        VERBOSE( "%s := 0 ;; division by zero", res->label().c_str() );
+    }
+    else
+    {
+        alloc_reg_for_value( *rhs, c );
+        X86Gp y = sign_extend_word( c.val2reg()[ rhs ], bitsize, c.compiler() );
+
+        // a division by zero yields zero as in the native evaluator instead
+        // of raising a divide error
+        Label zero = c.compiler().newLabel();
+        Label done = c.compiler().newLabel();
+
+        c.compiler().test( y, y );
+        c.compiler().jz( zero );
+
+        if( bitsize < 32 )
+        {
+            // sign extended values below 32 bits cannot overflow 'idiv'
+            X86Gp hi = c.compiler().newI32( "hi" );
+            q = c.compiler().newI32( "lo" );
+
+            c.compiler().mov( q, x.r32() );
+            c.compiler().mov( hi, q );
+            c.compiler().sar( hi, 31 );
+            c.compiler().idiv( hi, q, y.r32() );
+        }
+        else
+        {
+            X86Gp hi = c.compiler().newI64( "hi" );
+            q = c.compiler().newI64( "lo" );
+
+            c.compiler().mov( q, x );
+            c.compiler().mov( hi, q );
+            c.compiler().sar( hi, 63 );
+
+            if( bitsize == 64 )
+            {
+                // the quotient of the minimum value and '-1' wraps around
+                // instead of raising a divide error
+                Label divide = c.compiler().newLabel();
+
+                c.compiler().cmp( y, -1 );
+                c.compiler().jne( divide );
+                c.compiler().neg( q );
+                c.compiler().jmp( done );
+                c.compiler().bind( divide );
+            }
+
+            c.compiler().idiv( hi, q, y );
+        }
+
+        c.compiler().jmp( done );
+        c.compiler().bind( zero );
+        c.compiler().xor_( q.r32(), q.r32() );
+        c.compiler().bind( done );
+        VERBOSE( "idiv %s, %s", lhs->label().c_str(), rhs->label().c_str() );
+    }
+
+    c.compiler().mov( c.val2reg()[ res ], sub_reg( q, calc_byte_size( value.type() ) ) );
+}
+void CjelIRToAsmJitPass::visit_epilog( DivSignedInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// ModUnsignedInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( ModUnsignedInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    if( fold( value, c ) )
+    {
+        return;
+    }
+
+    if( is_wide( value.type() ) )
+    {
+        FIXME();
+        return;
+    }
+
+    const auto res = &value;
+    const auto lhs = value.operand( 0 ).get();
+    const auto rhs = value.operand( 1 ).get();
+    const u16 bitsize = lhs->type().bitsize();
+
+    alloc_reg_for_value( *res, c );
+    alloc_reg_for_value( *lhs, c );
+
+    X86Gp x = zero_extend_word( c.val2reg()[ lhs ], bitsize, c.compiler() );
+    X86Gp r;
+
+    const u64 divisor = isa< BitConstant >( rhs )
+                            ? static_cast< BitConstant& >( *rhs ).value().value() &
+                                  NativeEvaluator::mask( bitsize )
+                            : 0;
+
+    if( divisor and ( divisor & ( divisor - 1 ) ) == 0 )
+    {
+        r = x;
+        mask_word( r, __builtin_ctzll( divisor ), c.compiler() );
+        if( divisor == 1 )
+        {
+            c.compiler().xor_( r.r32(), r.r32() );
+        }
+        VERBOSE( "%s := %s %% %lu ;; mask", res->label().c_str(), lhs->label().c_str(), divisor );
+    }
+    else if( divisor )
+    {
+        X86Gp q = quotient_unsigned( x, divisor, bitsize, c.compiler() );
+
+        X86Gp d = c.compiler().newU64( "divisor" );
+        c.compiler().mov( d, imm_u( divisor ) );
+        c.compiler().imul( q, d );
+
+        r = x;
+        c.compiler().sub( r, q );
+        VERBOSE( "%s := %s %% %lu ;; magic", res->label().c_str(), lhs->label().c_str(), divisor );
+    }
+    else if( isa< BitConstant >( rhs ) )
+    {
+        // a modulo by zero yields zero as in the native evaluator
+        r = c.compiler().newU64( "zero" );
+        c.compiler().xor_( r.r32(), r.r32() );
+        VERBOSE( "%s := 0 ;; modulo by zero", res->label().c_str() );
+    }
+    else
+    {
+        alloc_reg_for_value( *rhs, c );
+        X86Gp y = zero_extend_word( c.val2reg()[ rhs ], bitsize, c.compiler() );
+
+        // the remainder starts as zero, which is the result of a modulo by
+        // zero in the native evaluator
+        Label zero = c.compiler().newLabel();
+
+        if( bitsize <= 32 )
+        {
+            r = c.compiler().newU32( "hi" );
+            X86Gp lo = c.compiler().newU32( "lo" );
+
+            c.compiler().xor_( r, r );
+            c.compiler().test( y.r32(), y.r32() );
+            c.compiler().jz( zero );
+            c.compiler().mov( lo, x.r32() );
+            c.compiler().div( r, lo, y.r32() );
+        }
+        else
+        {
+            r = c.compiler().newU64( "hi" );
+            X86Gp lo = c.compiler().newU64( "lo" );
+
+            c.compiler().xor_( r.r32(), r.r32() );
+            c.compiler().test( y, y );
+            c.compiler().jz( zero );
+            c.compiler().mov( lo, x );
+            c.compiler().div( r, lo, y );
+        }
+
+        c.compiler().bind( zero );
+        VERBOSE( "div %s, %s", lhs->label().c_str(), rhs->label().c_str() );
+    }
+
+    c.compiler().mov( c.val2reg()[ res ], sub_reg( r, calc_byte_size( value.type() ) ) );
+}
+void CjelIRToAsmJitPass::visit_epilog( ModUnsignedInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// EquInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( EquInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    if( fold( value, c ) )
+    {
+        return;
+    }
+
+    compare( value, *value.operand( 0 ), value.operand( 1 ).get(), X86Inst::kCondE, c );
+}
+void CjelIRToAsmJitPass::visit_epilog( EquInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// NeqInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( NeqInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    if( fold( value, c ) )
+    {
+        return;
+    }
+
+    compare( value, *value.operand( 0 ), value.operand( 1 ).get(), X86Inst::kCondNE, c );
+}
+void CjelIRToAsmJitPass::visit_epilog( NeqInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// ZeroExtendInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( ZeroExtendInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    if( fold( value, c ) )
+    {
+        return;
+    }
+
+    const auto& type = value.type();
+    const auto res = &value;
+    const auto arg = value.operand( 0 ).get();
+
+    assert( type.isBit() and arg->type().isBit() );
+
+    alloc_reg_for_value( *res, c );
+    alloc_reg_for_value( *arg, c );
+
+    if( is_wide( arg->type() ) )
+    {
+        const u32 top = ( limbs( arg->type() ) - 1 ) * 8;
+
+        zero( c.val2reg()[ res ], calc_byte_size( type ), c );
+        copy( c.val2reg()[ res ], c.val2reg()[ arg ], calc_byte_size( arg->type() ), c );
+
+        // clear the bits above the operand in its top limb
+        X86Gp word = c.compiler().newU64( "word" );
+        c.compiler().mov( word, x86::ptr( c.val2reg()[ res ], top ) );
+        mask_word( word, arg->type().bitsize(), c.compiler() );
+        c.compiler().mov( x86::ptr( c.val2reg()[ res ], top ), word );
+
+        VERBOSE( "zext %s, %s ;; limbs", res->label().c_str(), arg->label().c_str() );
+        return;
+    }
+
+    X86Gp word = zero_extend_word( c.val2reg()[ arg ], arg->type().bitsize(), c.compiler() );
+
+    if( is_wide( type ) )
+    {
+        zero( c.val2reg()[ res ], calc_byte_size( type ), c );
+        c.compiler().mov( x86::ptr( c.val2reg()[ res ], 0 ), word );
+        VERBOSE( "mov ptr( %s, 0 ), %s ;; zext", res->label().c_str(), arg->label().c_str() );
+    }
+    else
+    {
+        c.compiler().mov( c.val2reg()[ res ], sub_reg( word, calc_byte_size( type ) ) );
+        VERBOSE( "mov %s, %s ;; zext", res->label().c_str(), arg->label().c_str() );
+    }
+}
+void CjelIRToAsmJitPass::visit_epilog( ZeroExtendInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// TruncationInstruction
+//
+
+void CjelIRToAsmJitPass::visit_prolog( TruncationInstruction& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    if( fold( value, c ) )
+    {
+        return;
+    }
+
+    const auto& type = value.type();
+    const auto res = &value;
+    const auto arg = value.operand( 0 ).get();
+
+    alloc_reg_for_value( *res, c );
+    alloc_reg_for_value( *arg, c );
+
+    if( is_wide( arg->type() ) )
+    {
+        if( is_wide( type ) )
+        {
+            copy( c.val2reg()[ res ], c.val2reg()[ arg ], calc_byte_size( type ), c );
+            VERBOSE( "copy( %s, %s ) ;; trunc", res->label().c_str(), arg->label().c_str() );
+        }
+        else
+        {
+            c.compiler().mov( c.val2reg()[ res ], x86::ptr( c.val2reg()[ arg ], 0 ) );
+            VERBOSE( "mov %s, ptr( %s, 0 ) ;; trunc", res->label().c_str(), arg->label().c_str() );
+        }
+        return;
+    }
+
+    switch( type.id() )
+    {
+        case libcjel_ir::Type::BIT:
+        {
+            if( type.bitsize() < 1 )
+            {
+                assert( not" bit type has invalid bit-size of '0' " );
+            }
+            else if( type.bitsize() <= 8 )
+            {
+                c.val2reg()[ res ] = c.val2reg()[ arg ].r8();
+                VERBOSE( "%s.r8()", arg->label().c_str() );
+            }
+            else if( type.bitsize() <= 16 )
+            {
+                c.val2reg()[ res ] = c.val2reg()[ arg ].r16();
+                VERBOSE( "%s.r16()", arg->label().c_str() );
+            }
+            else if( type.bitsize() <= 32 )
+            {
+                c.val2reg()[ res ] = c.val2reg()[ arg ].r32();
+                VERBOSE( "%s.r32()", arg->label().c_str() );
+            }
+            else if( type.bitsize() <= 64 )
+            {
+                c.val2reg()[ res ] = c.val2reg()[ arg ].r64();
+                VERBOSE( "%s.r64()", arg->label().c_str() );
+            }
+            else
+            {
+                assert( not" a truncation to a wide bit type needs a wide operand " );
+            }
+            break;
+        }
+        default:
+        {
+            fprintf(
+                stderr,
+                "unsupported type '%s' for 'trunc' instruction!\n",
+                type.description().c_str() );
+            assert( 0 );
+            break;
+        }
+    }
+}
+void CjelIRToAsmJitPass::visit_epilog( TruncationInstruction& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// BitConstant
+//
+
+void CjelIRToAsmJitPass::visit_prolog( BitConstant& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    alloc_reg_for_value( value, c );
+
+    if( is_wide( value.type() ) )
+    {
+        // the limbs are read through their pointer only
+        std::string bytes( calc_byte_size( value.type() ), '\0' );
+        encode( value, reinterpret_cast< u8* >( &bytes[ 0 ] ) );
+
+        c.compiler().lea( c.val2reg()[&value ], pooled( bytes, c ) );
+        VERBOSE( "lea %s, pool( %lu ) ;; %s", value.label().c_str(), bytes.size(),
+            value.name().c_str() );
+        return;
+    }
+
+    c.compiler().mov(
+        c.val2reg()[&value ],
+        asmjit::imm( value.value().value() ) );  // FIXME: PPA: value access limited
+                                                 // to 1 word!!!
+    VERBOSE( "mov %s, imm( %s )", value.label().c_str(), value.name().c_str() );
+}
+void CjelIRToAsmJitPass::visit_epilog( BitConstant& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// StructureConstant
+//
+
+void CjelIRToAsmJitPass::visit_prolog( StructureConstant& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    alloc_reg_for_value( value, c );
+
+    // encoded like the inputs of the compiled code
+    std::string bytes( calc_byte_size( value.type() ), '\0' );
+    encode( value, reinterpret_cast< u8* >( &bytes[ 0 ] ) );
+
+    c.compiler().lea( c.val2reg()[&value ], pooled( bytes, c ) );
+    VERBOSE( "lea %s, pool( %lu ) ;; %s", value.label().c_str(), bytes.size(),
+        value.name().c_str() );
+}
+void CjelIRToAsmJitPass::visit_epilog( StructureConstant& value, libcjel_ir::Context& cxt )
+{
+}
+
+//
+// StringConstant
+//
+
+void CjelIRToAsmJitPass::visit_prolog( StringConstant& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    Context& c = static_cast< Context& >( cxt );
+
+    alloc_reg_for_value( value, c );
+
+    // strings are passed as pointers to their zero terminated characters
+    const std::string& characters = value.value();
+    std::string bytes( characters.c_str(), characters.size() + 1 );
+
+    c.compiler().lea( c.val2reg()[&value ], pooled( bytes, c ) );
+    VERBOSE( "lea %s, pool( %lu ) ;; string", value.label().c_str(), bytes.size() );
+}
+void CjelIRToAsmJitPass::visit_epilog( StringConstant& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+}
+
+//
+// Interconnect
+//
+
+void CjelIRToAsmJitPass::visit_prolog( Interconnect& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+    FIXME();
+}
+void CjelIRToAsmJitPass::visit_epilog( Interconnect& value, libcjel_ir::Context& cxt )
+{
+    TRACE( "" );
+}
+
+//
+// JiT
+//
+
+X86Vec CjelIRToAsmJitPass::new_reg_for_vector_type(
+    const libcjel_ir::Type& type, const char* label, Context& c )
+{
+    if( calc_byte_size( type ) <= 16 )
+    {
+        NOTE( "newXmm" );
+        return c.compiler().newXmm( label );
+    }
+
+    CCFunc* func = c.compiler().getFunc();
+    if( c.upper() != func )
+    {
+        // every return passes the exit of the function, so the legacy SSE
+        // code of the caller does not pay for dirty upper halves
+        CBNode* resume = c.compiler().setCursor( func->getExitNode() );
+        c.compiler().vzeroupper();
+        c.compiler().setCursor( resume );
+        c.setUpper( func );
+        NOTE( "vzeroupper ;; exit" );
+    }
+
+    NOTE( "newYmm" );
+    return c.compiler().newYmm( label );
+}
+
+void CjelIRToAsmJitPass::move_vector(
+    const X86Vec& reg, X86Mem memory, u32 byte_size, u1 load, Context& c )
+{
+    u32 id = X86Inst::kIdNone;
+
+    switch( byte_size )
+    {
+        case 4:
+        {
+            id = X86Inst::kIdMovd;
+            break;
+        }
+        case 8:
+        {
+            id = X86Inst::kIdMovq;
+            break;
+        }
+        case 16:
+        {
+            id = X86Inst::kIdMovdqu;
+            break;
+        }
+        default:
+        {
+            id = X86Inst::kIdVmovdqu;
+            break;
+        }
+    }
+
+    memory.setSize( byte_size );
+
+    if( load )
+    {
+        c.compiler().emit( id, reg, memory );
+    }
+    else
+    {
+        c.compiler().emit( id, memory, reg );
+    }
+}
+
+X86Gp CjelIRToAsmJitPass::extract_lane(
+    const X86Vec& reg, u32 index, const libcjel_ir::Type& element, Context& c )
+{
+    const u32 byte_size = calc_byte_size( element );
+    u32 offset = index * byte_size;
+
+    // YMM registers are accessed with the VEX forms of the same instructions
+    const u1 vex = reg.isYmm();
+    X86Xmm xmm = reg.xmm();
+
+    if( offset >= 16 )
+    {
+        xmm = c.compiler().newXmm( "half" );
+        c.compiler().emit( X86Inst::kIdVextracti128, xmm, reg, imm( 1 ) );
+        offset -= 16;
+    }
+
+    X86Gp lane = new_reg_for_bit_type( element, "lane", c.compiler() );
+
+    if( byte_size <= 2 )
+    {
+        X86Gp word = c.compiler().newU32( "word" );
+        c.compiler().emit( vex ? X86Inst::kIdVpextrw : X86Inst::kIdPextrw,
+            word,
+            xmm,
+            imm( offset / 2 ) );
+
+        if( byte_size == 1 and offset % 2 )
+        {
+            c.compiler().shr( word, imm( 8 ) );
+        }
+
+        c.compiler().mov( lane, sub_reg( word, byte_size ) );
+    }
+    else
+    {
+        if( offset > 0 )
+        {
+            // the element is moved into the lowest lane first
+            X86Xmm moved = c.compiler().newXmm( "moved" );
+            c.compiler().emit( vex ? X86Inst::kIdVpshufd : X86Inst::kIdPshufd,
+                moved,
+                xmm,
+                imm( byte_size == 4 ? offset / 4 : 0xee ) );
+            xmm = moved;
+        }
+
+        c.compiler().emit( byte_size == 4 ? ( vex ? X86Inst::kIdVmovd : X86Inst::kIdMovd )
+                                          : ( vex ? X86Inst::kIdVmovq : X86Inst::kIdMovq ),
+            lane,
+            xmm );
+    }
+
+    NOTE( "lane( %u, %u )", index, byte_size );
+    return lane;
+}
+
+u1 CjelIRToAsmJitPass::lanewise( libcjel_ir::Instruction& value, Context& c )
+{
+    if( not in_vector_register( value.type() ) )
+    {
+        return false;
+    }
+
+    alloc_reg_for_value( value, c );
+
+    for( const auto& operand : value.operands() )
+    {
+        alloc_reg_for_value( *operand, c );
+
+        if( not c.vectors().count( operand.get() ) )
+        {
+            fprintf(
+                stderr,
+                "unsupported operand '%s' of vector operation '%s'!\n",
+                operand->label().c_str(),
+                value.name().c_str() );
+            assert( 0 );
+            return true;
+        }
+    }
+
+    const X86Vec& res = c.vectors()[&value ];
+    const X86Vec& lhs = c.vectors()[ value.operand( 0 ).get() ];
+    X86Vec rhs;
+
+    const u1 vex = res.isYmm();
+    const u32 byte_size = calc_byte_size( *value.type().results()[ 0 ] );
+    const u32 w = byte_size == 1 ? 0 : byte_size == 2 ? 1 : byte_size == 4 ? 2 : 3;
+
+    static const u32 padd[ 4 ][ 2 ] = { { X86Inst::kIdPaddb, X86Inst::kIdVpaddb },
+        { X86Inst::kIdPaddw, X86Inst::kIdVpaddw },
+        { X86Inst::kIdPaddd, X86Inst::kIdVpaddd },
+        { X86Inst::kIdPaddq, X86Inst::kIdVpaddq } };
+
+    const u32* id = nullptr;
+
+    if( isa< NotInstruction >( value ) )
+    {
+        // all ones from comparing a register with itself
+        static const u32 pxor[ 2 ] = { X86Inst::kIdPxor, X86Inst::kIdVpxor };
+        id = pxor;
+
+        rhs = new_reg_for_vector_type( value.type(), "ones", c );
+
+        if( vex )
+        {
+            c.compiler().emit( X86Inst::kIdVpcmpeqd, rhs, rhs, rhs );
+        }
+        else
+        {
+            c.compiler().emit( X86Inst::kIdPcmpeqd, rhs, rhs );
+        }
+    }
+    else
+    {
+        rhs = c.vectors()[ value.operand( 1 ).get() ];
+
+        static const u32 pand[ 2 ] = { X86Inst::kIdPand, X86Inst::kIdVpand };
+        static const u32 por[ 2 ] = { X86Inst::kIdPor, X86Inst::kIdVpor };
+        static const u32 pxor[ 2 ] = { X86Inst::kIdPxor, X86Inst::kIdVpxor };
+
+        id = isa< AndInstruction >( value )
+                 ? pand
+                 : isa< OrInstruction >( value )
+                       ? por
+                       : isa< XorInstruction >( value ) ? pxor : padd[ w ];
+    }
+
+    if( vex )
+    {
+        c.compiler().emit( id[ 1 ], res, lhs, rhs );
+    }
+    else
+    {
+        c.compiler().emit( X86Inst::kIdMovdqa, res, lhs );
+        c.compiler().emit( id[ 0 ], res, rhs );
+    }
+
+    VERBOSE( "%s %s, %s ;; packed", value.name().c_str(), value.label().c_str(),
+        value.operand( 0 )->label().c_str() );
+    return true;
+}
+
+void CjelIRToAsmJitPass::alloc_reg_for_input( Value& value, u32 argument, Context& c )
+{
+    if( c.val2reg().has( &value ) )
+    {
+        // already allocated!
+        return;
+    }
+
+    const auto& type = value.type();
+
+    switch( type.id() )
+    {
+        case libcjel_ir::Type::BIT:
+        {
+            if( is_wide( type ) )
+            {
+                // wide inputs are used in place like structures
+                c.val2reg()[&value ] = c.compiler().newUIntPtr( value.label().c_str() );
+                c.compiler().setArg( argument, c.val2reg()[&value ] );
+                VERBOSE( "setArg( %u, %s ) ;; input", argument, value.label().c_str() );
+                break;
+            }
+
+            // the argument register holds the zero extended value
+            X86Gp word = c.compiler().newU64( value.label().c_str() );
+            c.compiler().setArg( argument, word );
+
+            c.val2reg()[&value ] = sub_reg( word, calc_byte_size( type ) );
+            VERBOSE( "setArg( %u, %s ) ;; input", argument, value.label().c_str() );
+            break;
+        }
+        case libcjel_ir::Type::STRUCTURE:
+        {
+            c.val2reg()[&value ] = c.compiler().newUIntPtr( value.label().c_str() );
+            VERBOSE( "newUIntPtr" );
+
+            c.compiler().setArg( argument, c.val2reg()[&value ] );
+            VERBOSE( "setArg( %u, %s ) ;; input", argument, value.label().c_str() );
+            break;
+        }
+        default:
+        {
+            fprintf(
+                stderr,
+                "unsupported type '%s' to pass as input!\n",
+                type.description().c_str() );
+            assert( 0 );
+            break;
+        }
+    }
+}
+
+void CjelIRToAsmJitPass::compare( Value& value, Value& lhs, Value* rhs, u32 condition, Context& c )
+{
+    alloc_reg_for_value( value, c );
+    alloc_reg_for_value( lhs, c );
+
+    if( rhs )
+    {
+        alloc_reg_for_value( *rhs, c );
+    }
+
+    const X86Gp& res = c.val2reg()[&value ];
+
+    if( value.type().bitsize() > 8 )
+    {
+        // clear the upper bits before the flags are set
+        c.compiler().xor_( res, res );
+        VERBOSE( "xor_ %s, %s", value.label().c_str(), value.label().c_str() );
+    }
+
+    if( is_wide( lhs.type() ) )
+    {
+        // accumulate the differing bits of all limbs and test them at once
+        X86Gp acc = c.compiler().newU64( "acc" );
+        X86Gp tmp = c.compiler().newU64( "limb" );
+
+        const u32 top = limbs( lhs.type() ) - 1;
+
+        c.compiler().xor_( acc.r32(), acc.r32() );
+        for( u32 i = 0; i <= top; i++ )
+        {
+            c.compiler().mov( tmp, x86::ptr( c.val2reg()[&lhs ], i * 8 ) );
+            if( rhs )
+            {
+                c.compiler().xor_( tmp, x86::ptr( c.val2reg()[ rhs ], i * 8 ) );
+            }
+            if( i == top )
+            {
+                // bits above the bit-size are undefined
+                mask_word( tmp, lhs.type().bitsize(), c.compiler() );
+            }
+            c.compiler().or_( acc, tmp );
+        }
+
+        c.compiler().test( acc, acc );
+        VERBOSE( "test %s, %s ;; limbs", lhs.label().c_str(), rhs ? rhs->label().c_str() : "0" );
+    }
+    else if( rhs )
+    {
+        c.compiler().cmp( c.val2reg()[&lhs ], c.val2reg()[ rhs ] );
+        VERBOSE( "cmp %s, %s", lhs.label().c_str(), rhs->label().c_str() );
+    }
+    else
+    {
+        c.compiler().test( c.val2reg()[&lhs ], c.val2reg()[&lhs ] );
+        VERBOSE( "test %s, %s", lhs.label().c_str(), lhs.label().c_str() );
+    }
+
+    c.compiler().emit( X86Inst::condToSetcc( condition ), res.r8() );
+    VERBOSE( "setcc( %u ) %s", condition, value.label().c_str() );
+}
+
+void CjelIRToAsmJitPass::limbwise(
+    u32 first, u32 next, Value& value, Value& lhs, Value* rhs, Context& c )
+{
+    alloc_reg_for_value( value, c );
+    alloc_reg_for_value( lhs, c );
+
+    if( rhs )
+    {
+        alloc_reg_for_value( *rhs, c );
+    }
+
+    X86Gp limb = c.compiler().newU64( "limb" );
+
+    for( u32 i = 0; i < limbs( value.type() ); i++ )
+    {
+        const u32 id = i == 0 ? first : next;
+
+        c.compiler().mov( limb, x86::ptr( c.val2reg()[&lhs ], i * 8 ) );
+
+        if( rhs )
+        {
+            // the moves in between keep the carry flag of 'adc' chains intact
+            c.compiler().emit( id, limb, x86::ptr( c.val2reg()[ rhs ], i * 8 ) );
+        }
+        else
+        {
+            c.compiler().emit( id, limb );
+        }
+
+        c.compiler().mov( x86::ptr( c.val2reg()[&value ], i * 8 ), limb );
+    }
+
+    VERBOSE(
+        "limbwise( %u, %u ) %s, %s, %s",
+        first,
+        next,
+        value.label().c_str(),
+        lhs.label().c_str(),
+        rhs ? rhs->label().c_str() : "" );
+}
+
+void CjelIRToAsmJitPass::copy( const X86Gp& dst, const X86Gp& src, u32 byte_size, Context& c )
+{
+    u32 offset = 0;
+
+    if( byte_size >= 16 )
+    {
+        X86Xmm vec = c.compiler().newXmm( "vec" );
+
+        for( ; byte_size - offset >= 16; offset += 16 )
+        {
+            c.compiler().movdqu( vec, x86::ptr( src, offset ) );
+            c.compiler().movdqu( x86::ptr( dst, offset ), vec );
+        }
+    }
+
+    if( offset == byte_size )
+    {
+        return;
+    }
+
+    X86Gp tmp = c.compiler().newU64( "tmp" );
+
+    for( u32 width = 8; width > 0; width /= 2 )
+    {
+        for( ; byte_size - offset >= width; offset += width )
+        {
+            c.compiler().mov( sub_reg( tmp, width ), x86::ptr( src, offset ) );
+            c.compiler().mov( x86::ptr( dst, offset ), sub_reg( tmp, width ) );
+        }
+    }
+}
+
+void CjelIRToAsmJitPass::zero( const X86Gp& dst, u32 byte_size, Context& c )
+{
+    u32 offset = 0;
+
+    if( byte_size >= 16 )
+    {
+        X86Xmm vec = c.compiler().newXmm( "vec" );
+        c.compiler().pxor( vec, vec );
+
+        for( ; byte_size - offset >= 16; offset += 16 )
+        {
+            c.compiler().movdqu( x86::ptr( dst, offset ), vec );
+        }
+    }
+
+    if( offset == byte_size )
+    {
+        return;
+    }
+
+    X86Gp tmp = c.compiler().newU64( "tmp" );
+    c.compiler().xor_( tmp.r32(), tmp.r32() );
+
+    for( u32 width = 8; width > 0; width /= 2 )
+    {
+        for( ; byte_size - offset >= width; offset += width )
+        {
+            c.compiler().mov( x86::ptr( dst, offset ), sub_reg( tmp, width ) );
+        }
+    }
+}
+
+u1 CjelIRToAsmJitPass::forkable( Value& value, Context& c )
+{
+    const u64 grain = c.runtime().parallelGrain();
+    if( grain == 0 or c.runtime().pool().workers() == 0 )
+    {
+        return false;
+    }
+
+    for( const auto& fork : c.forks() )
+    {
+        if( fork.cursor )
+        {
+            // the enclosing statement is forked itself and compiled again
+            return false;
+        }
+    }
+
+    u32 statements = 0;
+    value.iterate( Traversal::PREORDER, [&]( Value& node ) {
+        if( isa< TrivialStatement >( node ) and statement_cost( node ) >= grain )
+        {
+            statements++;
+        }
+    } );
+
+    return statements >= 2;
+}
+
+void CjelIRToAsmJitPass::spawn( Context::Fork& fork, Context& c )
+{
+    const u32 count = fork.tasks.size();
+
+    X86Gp tasks = c.compiler().newUIntPtr( "tasks" );
+    c.compiler().lea( tasks, slot( count * sizeof( ThreadPool::Task ), c ) );
+    NOTE( "lea tasks, slot( %u ) ;; fork", count );
+
+    for( u32 i = 0; i < count; i++ )
+    {
+        Context::Task& task = fork.tasks[ i ];
+
+        X86Gp frame = c.compiler().newUIntPtr( "frame" );
+        c.compiler().lea( frame, slot( ( task.captures.size() + 1 ) * 8, c ) );
+
+        if( fork.deferred )
+        {
+            // the update set of the scope follows the captured values
+            task.updates = true;
+            task.layered = fork.layered;
+            c.compiler().mov( x86::ptr( frame, task.captures.size() * 8 ), fork.updates );
+        }
+
+        for( u32 k = 0; k < task.captures.size(); k++ )
+        {
+            Value* capture = task.captures[ k ];
+
+            if( isa< ExtractInstruction >( capture ) )
+            {
+                X86Gp address = c.compiler().newUIntPtr( "capture" );
+                c.compiler().lea( address, c.val2mem()[ capture ] );
+                c.compiler().mov( x86::ptr( frame, k * 8 ), address );
+            }
+            else if( c.vectors().count( capture ) )
+            {
+                const u32 byte_size = calc_byte_size( capture->type() );
+
+                X86Gp address = c.compiler().newUIntPtr( "capture" );
+                c.compiler().lea( address, slot( byte_size, c ) );
+                move_vector( c.vectors()[ capture ], x86::ptr( address, 0 ), byte_size, false, c );
+                c.compiler().mov( x86::ptr( frame, k * 8 ), address );
+            }
+            else
+            {
+                alloc_reg_for_value( *capture, c );
+                c.compiler().mov( x86::ptr( frame, k * 8 ), c.val2reg()[ capture ] );
+            }
+            NOTE( "mov ptr( frame, %u ), %s ;; capture", k * 8, capture->label().c_str() );
+        }
+
+        X86Gp function = c.compiler().newUIntPtr( "task" );
+        c.compiler().lea( function, x86::ptr( task.func->getLabel() ) );
+
+        const u32 offset = i * sizeof( ThreadPool::Task );
+        c.compiler().mov(
+            x86::ptr( tasks, offset + offsetof( ThreadPool::Task, function ) ), function );
+        c.compiler().mov( x86::ptr( tasks, offset + offsetof( ThreadPool::Task, frame ) ), frame );
+        NOTE( "task[ %u ] := %s", i, task.statement->label().c_str() );
+    }
+
+    X86Gp pool = c.compiler().newUIntPtr( "pool" );
+    c.compiler().mov( pool, imm_ptr( &c.runtime().pool() ) );
+
+    X86Gp size = c.compiler().newU64( "count" );
+    c.compiler().mov( size, imm( count ) );
+
+    X86Gp fp = c.compiler().newIntPtr( "fork_join" );
+    c.compiler().mov( fp, imm_ptr( (void*)&fork_join ) );
+
+    CCFuncCall* call = c.compiler().call(
+        fp, FuncSignature3< void, void*, const void*, u64 >( CallConv::kIdHost ) );
+    call->setArg( 0, pool );
+    call->setArg( 1, tasks );
+    call->setArg( 2, size );
+    NOTE( "call( fork_join, %u )", count );
+
+    for( auto& task : fork.tasks )
+    {
+        c.tasks().emplace_back( std::move( task ) );
+    }
+}
+
+void CjelIRToAsmJitPass::compile_tasks( Context& c )
+{
+    while( not c.tasks().empty() )
+    {
+        Context::Task task = std::move( c.tasks().front() );
+        c.tasks().pop_front();
+
+        // registers and slots of the parent function are not accessible in
+        // the task
+        c.val2reg().clear();
+        c.val2mem().clear();
+        c.vectors().clear();
+        c.slots().clear();
+        c.live().clear();
+
+        c.compiler().addFunc( task.func );
+        NOTE( "addFunc( %s ) ;; task", task.statement->label().c_str() );
+
+        X86Gp frame = c.compiler().newUIntPtr( "frame" );
+        c.compiler().setArg( 0, frame );
+
+        for( u32 k = 0; k < task.captures.size(); k++ )
+        {
+            Value* capture = task.captures[ k ];
+            const auto& type = capture->type();
+
+            if( isa< ExtractInstruction >( capture ) )
+            {
+                X86Gp address = c.compiler().newUIntPtr( capture->label().c_str() );
+                c.compiler().mov( address, x86::ptr( frame, k * 8 ) );
+                c.val2mem()[ capture ] = x86::ptr( address, 0 );
+            }
+            else if( in_vector_register( type ) and isa< libcjel_ir::Instruction >( capture ) and
+                     not isa< AllocInstruction >( capture ) )
+            {
+                // vector values are passed by the address of a spilled copy
+                X86Gp address = c.compiler().newUIntPtr( capture->label().c_str() );
+                c.compiler().mov( address, x86::ptr( frame, k * 8 ) );
+
+                c.vectors()[ capture ] =
+                    new_reg_for_vector_type( type, capture->label().c_str(), c );
+                move_vector( c.vectors()[ capture ],
+                    x86::ptr( address, 0 ),
+                    calc_byte_size( type ),
+                    true,
+                    c );
+            }
+            else
+            {
+                if( isa< Reference >( capture ) or isa< AllocInstruction >( capture ) or
+                    not type.isBit() or is_wide( type ) )
+                {
+                    c.val2reg()[ capture ] = c.compiler().newUIntPtr( capture->label().c_str() );
+                }
+                else
+                {
+                    c.val2reg()[ capture ] =
+                        new_reg_for_bit_type( type, capture->label().c_str(), c.compiler() );
+                }
+
+                c.compiler().mov( c.val2reg()[ capture ], x86::ptr( frame, k * 8 ) );
+            }
+            NOTE( "mov %s, ptr( frame, %u ) ;; capture", capture->label().c_str(), k * 8 );
+        }
+
+        if( task.updates )
+        {
+            X86Gp updates = c.compiler().newUIntPtr( "updates" );
+            c.compiler().mov( updates, x86::ptr( frame, task.captures.size() * 8 ) );
+
+            c.forks().emplace_back(
+                Context::Fork{ false, nullptr, {}, {}, true, updates, 0, task.layered } );
+        }
+
+        task.statement->iterate( Traversal::PREORDER, this, &c );
+
+        if( task.updates )
+        {
+            c.forks().pop_back();
+        }
+
+        c.compiler().endFunc();
+        NOTE( "endFunc ;; task" );
+    }
+}
+
+void CjelIRToAsmJitPass::update(
+    const X86Gp& dst,
+    const X86Gp& src,
+    const libcjel_ir::Type& type,
+    Context::Fork& fork,
+    Context& c )
+{
+    assert( type.isBit() );
+
+    X86Gp fp = c.compiler().newIntPtr( "update_word" );
+    c.compiler().mov( fp, imm_ptr( (void*)&update_word ) );
+
+    const auto insert = [&]( const X86Gp& location, const X86Gp& word, u32 size ) {
+        X86Gp bytes = c.compiler().newU64( "size" );
+        c.compiler().mov( bytes, imm( size ) );
+
+        CCFuncCall* call = c.compiler().call(
+            fp, FuncSignature4< void, void*, void*, u64, u64 >( CallConv::kIdHost ) );
+        call->setArg( 0, fork.updates );
+        call->setArg( 1, location );
+        call->setArg( 2, word );
+        call->setArg( 3, bytes );
+    };
+
+    if( is_wide( type ) )
+    {
+        for( u32 i = 0; i < limbs( type ); i++ )
+        {
+            X86Gp word = c.compiler().newU64( "limb" );
+            c.compiler().mov( word, x86::ptr( src, i * 8 ) );
+
+            X86Gp location = c.compiler().newUIntPtr( "location" );
+            c.compiler().lea( location, x86::ptr( dst, i * 8 ) );
+
+            insert( location, word, 8 );
+        }
+        return;
+    }
+
+    insert( dst, zero_extend_word( src, type.bitsize(), c.compiler() ), calc_byte_size( type ) );
+}
+
+void CjelIRToAsmJitPass::open_updates(
+    Context::Fork& fork, u64 capacity, u1 sequential, Context& c )
+{
+    Context::Fork* outer = c.updates();
+
+    fork.deferred = true;
+    fork.layered = sequential or ( outer and outer->layered );
+    fork.updates = c.compiler().newUIntPtr( "updates" );
+
+    X86Gp runtime = c.compiler().newUIntPtr( "runtime" );
+    c.compiler().mov( runtime, imm_ptr( &c.runtime() ) );
+
+    X86Gp size = c.compiler().newU64( "capacity" );
+    c.compiler().mov( size, imm( capacity ) );
+
+    X86Gp enclosing;
+    if( outer )
+    {
+        enclosing = outer->updates;
+    }
+    else
+    {
+        enclosing = c.compiler().newUIntPtr( "none" );
+        c.compiler().xor_( enclosing, enclosing );
+    }
+
+    X86Gp layer = c.compiler().newU64( "sequential" );
+    c.compiler().mov( layer, imm( sequential ? 1 : 0 ) );
+
+    X86Gp fp = c.compiler().newIntPtr( "begin_updates" );
+    c.compiler().mov( fp, imm_ptr( (void*)&begin_updates ) );
+
+    CCFuncCall* call = c.compiler().call(
+        fp, FuncSignature4< void*, void*, u64, void*, u64 >( CallConv::kIdHost ) );
+    call->setArg( 0, runtime );
+    call->setArg( 1, size );
+    call->setArg( 2, enclosing );
+    call->setArg( 3, layer );
+    call->setRet( 0, fork.updates );
+}
+
+void CjelIRToAsmJitPass::close_updates( Context::Fork& fork, Context& c )
+{
+    Context::Fork* outer = c.updates();
+
+    X86Gp runtime = c.compiler().newUIntPtr( "runtime" );
+    c.compiler().mov( runtime, imm_ptr( &c.runtime() ) );
+
+    X86Gp none;
+    if( not outer )
+    {
+        none = c.compiler().newUIntPtr( "none" );
+        c.compiler().xor_( none, none );
+    }
+
+    X86Gp fp = c.compiler().newIntPtr( "commit_updates" );
+    c.compiler().mov( fp, imm_ptr( (void*)&commit_updates ) );
+
+    CCFuncCall* call = c.compiler().call(
+        fp, FuncSignature3< void, void*, void*, void* >( CallConv::kIdHost ) );
+    call->setArg( 0, runtime );
+    call->setArg( 1, fork.updates );
+    call->setArg( 2, outer ? outer->updates : none );
+}
+
+X86Gp CjelIRToAsmJitPass::read( const X86Mem& memory, u32 size, Context::Fork& fork, Context& c )
+{
+    X86Mem address = memory;
+    address.setSize( size );
+
+    X86Gp word = c.compiler().newU64( "word" );
+
+    if( size == 8 )
+    {
+        c.compiler().mov( word, address );
+    }
+    else if( size == 4 )
+    {
+        // writing the lower half clears the upper one
+        c.compiler().mov( word.r32(), address );
+    }
+    else
+    {
+        c.compiler().movzx( word, address );
+    }
+
+    X86Gp location = c.compiler().newUIntPtr( "location" );
+    c.compiler().lea( location, memory );
+
+    X86Gp bytes = c.compiler().newU64( "size" );
+    c.compiler().mov( bytes, imm( size ) );
+
+    X86Gp fp = c.compiler().newIntPtr( "read_word" );
+    c.compiler().mov( fp, imm_ptr( (void*)&read_word ) );
+
+    CCFuncCall* call = c.compiler().call(
+        fp, FuncSignature4< u64, void*, void*, u64, u64 >( CallConv::kIdHost ) );
+    call->setArg( 0, fork.updates );
+    call->setArg( 1, location );
+    call->setArg( 2, bytes );
+    call->setArg( 3, word );
+    call->setRet( 0, word );
+
+    return word;
+}
+
+void CjelIRToAsmJitPass::hoist( Value& value, Context& c )
+{
+    std::unordered_set< Value* > visiting;
+
+    std::function< void( Value& ) > materialize = [&]( Value& scope ) {
+        scope.iterate( Traversal::PREORDER, [&]( Value& node ) {
+            if( not isa< libcjel_ir::Instruction >( node ) )
+            {
+                return;
+            }
+
+            auto& instruction = static_cast< libcjel_ir::Instruction& >( node );
+
+            for( u32 i = 0; i < instruction.operands().size(); i++ )
+            {
+                const auto& operand = instruction.operand( i );
+
+                if( isa< ExtractInstruction >( instruction ) and i == 1 )
+                {
+                    // element indices are folded into the address
+                    continue;
+                }
+
+                if( isa< BitConstant >( operand ) or isa< StructureConstant >( operand ) )
+                {
+                    alloc_reg_for_value( *operand, c );
+                }
+            }
+
+            if( isa< CallInstruction >( instruction ) )
+            {
+                auto& call = static_cast< CallInstruction& >( instruction );
+
+                if( inlinable( call, c ) and visiting.emplace( call.callee().get() ).second )
+                {
+                    materialize( *static_cast< CallableUnit& >( *call.callee() ).context() );
+                }
+            }
+        } );
+    };
+
+    materialize( value );
+}
+
+CjelIRToAsmJitPass::Context::Control* CjelIRToAsmJitPass::control( Context& c )
+{
+    if( c.controls().empty() )
+    {
+        return nullptr;
+    }
+
+    Context::Control& control = c.controls().back();
+
+    if( control.depth != c.forks().size() or control.inlining != c.inlining().size() )
+    {
+        return nullptr;
+    }
+
+    return &control;
+}
+
+void CjelIRToAsmJitPass::enter_scope( Context& c )
+{
+    Context::Control* control = this->control( c );
+    if( not control )
+    {
+        return;
+    }
+
+    if( isa< LoopStatement >( control->statement ) )
+    {
+        auto& loop = static_cast< LoopStatement& >( *control->statement );
+        const X86Gp& condition = c.val2reg()[ loop.instructions().back().get() ];
+
+        c.compiler().test( condition, condition );
+        c.compiler().jz( control->labels[ 1 ] );
+        NOTE( "jz exit ;; loop" );
+    }
+    else if( isa< BranchStatement >( control->statement ) )
+    {
+        auto& branch = static_cast< BranchStatement& >( *control->statement );
+        const X86Gp& condition = c.val2reg()[ branch.instructions().back().get() ];
+        const auto counts = c.runtime().branchCounts( &branch );
+
+        if( control->predicated )
+        {
+            control->active = true;
+            return;
+        }
+
+        if( control->scope == 0 )
+        {
+            if( c.isInstrumented() )
+            {
+                count( ( *counts )[ 1 ], counts, c );
+            }
+
+            c.compiler().test( condition, condition );
+
+            if( not control->swapped )
+            {
+                c.compiler().jz( control->labels[ 0 ] );
+                NOTE( "jz else ;; branch" );
+            }
+            else if( control->cold )
+            {
+                c.compiler().jnz( control->labels[ 0 ] );
+                NOTE( "jnz cold ;; branch" );
+
+                control->resume = enter_cold( c );
+                c.compiler().bind( control->labels[ 0 ] );
+            }
+            else
+            {
+                c.compiler().jnz( control->labels[ 0 ] );
+                NOTE( "jnz then ;; branch" );
+
+                // the likely second scope is emitted in front of the jump
+                control->anchor = c.compiler().getCursor();
+                c.compiler().jmp( control->labels[ 1 ] );
+                c.compiler().bind( control->labels[ 0 ] );
+            }
+
+            if( c.isInstrumented() )
+            {
+                count( ( *counts )[ 0 ], counts, c );
+            }
+        }
+        else if( not control->swapped )
+        {
+            if( control->cold )
+            {
+                control->resume = enter_cold( c );
+            }
+
+            c.compiler().bind( control->labels[ 0 ] );
+        }
+        else if( not control->cold )
+        {
+            control->resume = c.compiler().getCursor();
+            c.compiler().setCursor( control->anchor );
+        }
+    }
+}
+
+void CjelIRToAsmJitPass::leave_scope( Context& c )
+{
+    Context::Control* control = this->control( c );
+    if( not control )
+    {
+        return;
+    }
+
+    if( isa< LoopStatement >( control->statement ) )
+    {
+        if( c.isInstrumented() )
+        {
+            count( c.runtime().backEdges( control->statement ), c );
+        }
+
+        c.compiler().jmp( control->labels[ 0 ] );
+        NOTE( "jmp head ;; loop" );
+    }
+    else if( isa< BranchStatement >( control->statement ) )
+    {
+        auto& branch = static_cast< BranchStatement& >( *control->statement );
+        const u1 first = control->scope == 0;
+
+        if( control->predicated )
+        {
+            control->active = false;
+        }
+        else if( control->cold and first == control->swapped )
+        {
+            c.compiler().jmp( control->labels[ 1 ] );
+            NOTE( "jmp end ;; cold" );
+
+            leave_cold( control->resume, c );
+            control->resume = nullptr;
+        }
+        else if( first and not control->swapped and not control->cold and
+                 branch.scopes().size() == 2 )
+        {
+            c.compiler().jmp( control->labels[ 1 ] );
+            NOTE( "jmp end ;; branch" );
+        }
+        else if( not first and control->swapped and not control->cold )
+        {
+            c.compiler().setCursor( control->resume );
+            control->resume = nullptr;
+        }
+    }
+
+    control->scope++;
+}
+
+u1 CjelIRToAsmJitPass::convertible( BranchStatement& value, Context& c )
+{
+    const u64 budget = c.runtime().ifConversionBudget();
+
+    if( budget == 0 or c.updates() or c.runtime().parallelUpdates() or
+        value.instructions().empty() )
+    {
+        return false;
+    }
+
+    const auto narrow = [&]( Value& v ) { return v.type().isBit() and not is_wide( v.type() ); };
+
+    for( const auto& scope : value.scopes() )
+    {
+        u64 size = 0;
+        u1 result = true;
+
+        scope->iterate( Traversal::PREORDER, [&]( Value& node ) {
+            if( isa< Statement >( node ) and not isa< TrivialStatement >( node ) )
+            {
+                result = false;
+            }
+            else if( isa< ParallelScope >( node ) and forkable( node, c ) )
+            {
+                result = false;
+            }
+            else if( isa< StoreInstruction >( node ) )
+            {
+                auto& src = *static_cast< StoreInstruction& >( node ).operand( 0 );
+                auto& dst = *static_cast< StoreInstruction& >( node ).operand( 1 );
+
+                result = result and narrow( src ) and not promoted( dst, c ) and
+                         ( isa< ExtractInstruction >( dst ) or
+                             ( isa< Reference >( dst ) and dst.type().isBit() ) );
+                size++;
+            }
+            else if( isa< ExtractInstruction >( node ) or isa< NopInstruction >( node ) )
+            {
+                size++;
+            }
+            else if(
+                isa< LoadInstruction >( node ) or isa< NotInstruction >( node ) or
+                isa< LnotInstruction >( node ) or isa< AndInstruction >( node ) or
+                isa< OrInstruction >( node ) or isa< XorInstruction >( node ) or
+                isa< AddUnsignedInstruction >( node ) or isa< AddSignedInstruction >( node ) or
+                isa< EquInstruction >( node ) or isa< NeqInstruction >( node ) or
+                isa< ZeroExtendInstruction >( node ) or isa< TruncationInstruction >( node ) )
+            {
+                // arithmetic on wide values is not worth the unconditional cost
+                result = result and narrow( node );
+
+                if( not isa< LoadInstruction >( node ) )
+                {
+                    for( auto operand : static_cast< libcjel_ir::Instruction& >( node ).operands() )
+                    {
+                        result = result and narrow( *operand );
+                    }
+                }
+                size++;
+            }
+            else if( isa< libcjel_ir::Instruction >( node ) )
+            {
+                result = false;
+            }
+        } );
+
+        if( not result or size > budget )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+CjelIRToAsmJitPass::Context::Control* CjelIRToAsmJitPass::predicate( Context& c )
+{
+    if( c.controls().empty() )
+    {
+        return nullptr;
+    }
+
+    Context::Control& control = c.controls().back();
+    return control.predicated and control.active ? &control : nullptr;
+}
+
+CBNode* CjelIRToAsmJitPass::enter_cold( Context& c )
+{
+    CBNode* resume = c.compiler().getCursor();
+
+    if( not c.cold() )
+    {
+        // the function body falls through to a return in front of the cold
+        // scopes, which jump back to the end of their branch statements
+        c.compiler().setCursor( c.compiler().getFunc()->getExitNode()->getPrev() );
+        c.compiler().ret();
+        c.setCold( c.compiler().getCursor() );
+        NOTE( "ret ;; cold" );
+    }
+
+    c.compiler().setCursor( c.cold() );
+    return resume;
+}
+
+void CjelIRToAsmJitPass::leave_cold( CBNode* resume, Context& c )
+{
+    c.setCold( c.compiler().getCursor() );
+    c.compiler().setCursor( resume );
+}
+
+CjelIRToAsmJitPass::Context::Promotion* CjelIRToAsmJitPass::promoted( Value& value, Context& c )
+{
+    if( not isa< ExtractInstruction >( value ) or
+        not isa< BitConstant >( static_cast< ExtractInstruction& >( value ).operand( 1 ) ) )
+    {
+        return nullptr;
+    }
+
+    auto& location = static_cast< ExtractInstruction& >( value );
+    const u64 index = static_cast< BitConstant& >( *location.operand( 1 ) ).value().value();
+
+    for( auto promotion = c.promotions().rbegin(); promotion != c.promotions().rend();
+         ++promotion )
+    {
+        if( promotion->base == location.operand( 0 ).get() and promotion->index == index )
+        {
+            return &( *promotion );
+        }
+    }
+
+    return nullptr;
+}
+
+void CjelIRToAsmJitPass::unroll(
+    LoopStatement& value, Value& end, u64 factor, Context::Promotion& counter, Context& c )
+{
+    const u16 bitsize = end.type().bitsize();
+
+    const auto reset = [&]() {
+        // every body gets its own registers
+        value.iterate( Traversal::PREORDER, [&]( Value& node ) {
+            if( isa< libcjel_ir::Instruction >( node ) )
+            {
+                c.val2reg().erase( &node );
+                c.val2mem().erase( &node );
+                c.vectors().erase( &node );
+            }
+        } );
+    };
+
+    Label head = c.compiler().newLabel();
+    Label tail = c.compiler().newLabel();
+
+    X86Gp last = zero_extend_word( c.val2reg()[&end ], bitsize, c.compiler() );
+
+    c.compiler().bind( head );
+
+    // iterations left until the counter wraps to 'end'
+    X86Gp remaining = c.compiler().newU64( "remaining" );
+    c.compiler().mov( remaining, last );
+    c.compiler().sub( remaining, zero_extend_word( counter.reg, bitsize, c.compiler() ) );
+    mask_word( remaining, bitsize, c.compiler() );
+
+    c.compiler().cmp( remaining, imm( factor ) );
+    c.compiler().jb( tail );
+    VERBOSE( "jb tail ;; unroll %lu", factor );
+
+    for( u64 i = 0; i < factor; i++ )
+    {
+        reset();
+
+        for( const auto& instruction : value.instructions() )
+        {
+            instruction->iterate( Traversal::PREORDER, this, &c );
+        }
+
+        for( const auto& scope : value.scopes() )
+        {
+            scope->iterate( Traversal::PREORDER, this, &c );
+        }
+    }
+
+    if( c.isInstrumented() )
+    {
+        count( c.runtime().backEdges( &value ), c );
+    }
+
+    c.compiler().jmp( head );
+    c.compiler().bind( tail );
+
+    reset();
+}
+
+void CjelIRToAsmJitPass::number( Value& value, Context& c )
+{
+    value.iterate( Traversal::PREORDER, [&]( Value& node ) { c.numbering().number( &node ); } );
+
+    c.val2reg().reserve( c.numbering().size() );
+    c.val2mem().reserve( c.numbering().size() );
+}
+
+void CjelIRToAsmJitPass::declare( CallableUnit& value, Context& c )
+{
+    Context::Callable& func = c.callable( &value );
+    func.argsize( -1 );
+
+    FuncSignatureX& fsig = func.funcsig();
+    fsig.init( CallConv::kIdHost, TypeId::kVoid, fsig._builderArgList, 0 );
+
+    for( std::size_t i = 0; i < value.inputs().size() + value.outputs().size(); i++ )
+    {
+        fsig.addArg( TypeId::kUIntPtr );
+    }
+
+    func.setFunc( c.compiler().newFunc( fsig ) );
+    VERBOSE( "newFunc( %s )", value.name().c_str() );
 }
-void CjelIRToAsmJitPass::visit_epilog( NopInstruction& value, libcjel_ir::Context& cxt )
+
+void CjelIRToAsmJitPass::collect( CallableUnit& value, std::vector< CallableUnit* >& callables )
 {
-}
+    if( std::find( callables.begin(), callables.end(), &value ) != callables.end() )
+    {
+        // already collected or recursive call
+        return;
+    }
 
-//
-// AllocInstruction
-//
+    callables.emplace_back( &value );
 
-void CjelIRToAsmJitPass::visit_prolog( AllocInstruction& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    FIXME();
+    if( not value.context() )
+    {
+        return;
+    }
+
+    value.context()->iterate( Traversal::PREORDER, [&]( Value& node ) {
+        if( isa< CallInstruction >( node ) )
+        {
+            const auto& callee = static_cast< CallInstruction& >( node ).callee();
+            assert( isa< CallableUnit >( callee ) );
+            collect( static_cast< CallableUnit& >( *callee ), callables );
+        }
+    } );
 }
-void CjelIRToAsmJitPass::visit_epilog( AllocInstruction& value, libcjel_ir::Context& cxt )
+
+CallableUnit& CjelIRToAsmJitPass::target( CallableUnit& value )
 {
-}
+    std::unordered_set< CallableUnit* > visited;
 
-//
-// IdInstruction
-//
+    CallableUnit* result = &value;
+    while( visited.emplace( result ).second )
+    {
+        CallableUnit* callee = forward( *result );
+        if( not callee )
+        {
+            break;
+        }
+        result = callee;
+    }
 
-void CjelIRToAsmJitPass::visit_prolog( IdInstruction& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    FIXME();
+    return *result;
 }
-void CjelIRToAsmJitPass::visit_epilog( IdInstruction& value, libcjel_ir::Context& cxt )
+
+CallableUnit* CjelIRToAsmJitPass::forward( CallableUnit& value )
 {
-}
+    if( not value.context() )
+    {
+        return nullptr;
+    }
 
-//
-// CastInstruction
-//
+    CallInstruction* call = nullptr;
+    u1 result = true;
 
-void CjelIRToAsmJitPass::visit_prolog( CastInstruction& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    FIXME();
+    value.context()->iterate( Traversal::PREORDER, [&]( Value& node ) {
+        if( not result )
+        {
+            return;
+        }
+
+        if( isa< Statement >( node ) and not isa< TrivialStatement >( node ) )
+        {
+            result = false;
+        }
+        else if( isa< CallInstruction >( node ) and not call )
+        {
+            call = &static_cast< CallInstruction& >( node );
+        }
+        else if( isa< libcjel_ir::Instruction >( node ) and not isa< NopInstruction >( node ) )
+        {
+            // any other action before or after the call
+            result = false;
+        }
+    } );
+
+    if( not result or not call or not isa< CallableUnit >( call->callee() ) )
+    {
+        return nullptr;
+    }
+
+    std::vector< Value* > parameters;
+    for( auto param : value.inputs() )
+    {
+        parameters.emplace_back( param.get() );
+    }
+    for( auto param : value.outputs() )
+    {
+        parameters.emplace_back( param.get() );
+    }
+
+    if( call->operands().size() != parameters.size() + 1 )
+    {
+        return nullptr;
+    }
+
+    for( u32 i = 1; i < call->operands().size(); i++ )
+    {
+        if( call->operands()[ i ].get() != parameters[ i - 1 ] )
+        {
+            return nullptr;
+        }
+    }
+
+    return static_cast< CallableUnit* >( call->callee().get() );
 }
-void CjelIRToAsmJitPass::visit_epilog( CastInstruction& value, libcjel_ir::Context& cxt )
+
+u1 CjelIRToAsmJitPass::inlinable( CallInstruction& value, Context& c )
 {
-}
+    u64 budget = c.runtime().inlineBudget();
 
-//
-// ExtractInstruction
-//
+    if( budget == 0 or not isa< Intrinsic >( value.callee() ) )
+    {
+        return false;
+    }
 
-void CjelIRToAsmJitPass::visit_prolog( ExtractInstruction& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    Context& c = static_cast< Context& >( cxt );
+    auto& callee = static_cast< Intrinsic& >( *value.callee() );
 
-    auto base = value.operand( 0 );
-    auto offset = value.operand( 1 );
+    if( c.profile() )
+    {
+        // callees which were not called while profiling stay out of line,
+        // the ones called at least once per invocation get a larger budget
+        const u64 calls = c.invocations( &callee );
+
+        if( calls == 0 )
+        {
+            return false;
+        }
+        else if( calls >= c.profile() )
+        {
+            budget *= HOT_INLINE_FACTOR;
+        }
+    }
 
-    if( isa< Reference >( base ) and base->type().isStructure() )
+    if( not callee.context() or c.inlining().find( &callee ) != c.inlining().end() )
     {
-        assert( isa< BitConstant >( offset ) );
-        BitConstant& index = static_cast< BitConstant& >( *offset );
+        // no body or recursive call
+        return false;
+    }
 
-        assert(
-            index.value().value() < base->type().results().size() );  // PPA: FIXME: use real
-                                                                      // operator< for: Type < u64
+    for( u32 i = 1; i < value.operands().size(); i++ )
+    {
+        const auto& argument = value.operands()[ i ];
 
-        u32 byte_offset = 0;
-        u32 byte_size = 0;
-        u32 bit_size = 0;
-        for( u32 i = 0; i < index.value().value();
-             i++ )  // PPA: FIXME: check if value is not greater one word!
+        if( argument->type().isBit() and not isa< Reference >( argument ) and
+            not isa< AllocInstruction >( argument ) )
         {
-            bit_size = base->type().results()[ i ]->bitsize();
-            byte_size = bit_size / 8 + ( ( bit_size % 8 ) % 2 );
-            byte_offset += byte_size;
+            // parameters are bound to pointers only
+            return false;
         }
-        // fprintf( stderr,  "byte size = %lu, %lu", byte_size, byte_offset
-        // );
+    }
 
-        c.val2mem()[&value ] = x86::ptr( c.val2reg()[ base.get() ], byte_offset );
+    u64 size = 0;
+    u1 result = true;
+
+    callee.context()->iterate( Traversal::PREORDER, [&]( Value& node ) {
+        if( isa< Statement >( node ) and not isa< TrivialStatement >( node ) )
+        {
+            result = false;
+        }
+        else if( isa< libcjel_ir::Instruction >( node ) )
+        {
+            size++;
+        }
+    } );
+
+    return result and size <= budget;
+}
+
+void CjelIRToAsmJitPass::inline_call( CallInstruction& value, Context& c )
+{
+    auto& callee = static_cast< Intrinsic& >( *value.callee() );
+
+    std::vector< Value* > parameters;
+    for( auto param : callee.inputs() )
+    {
+        parameters.emplace_back( param.get() );
+    }
+    for( auto param : callee.outputs() )
+    {
+        parameters.emplace_back( param.get() );
+    }
+
+    assert( value.operands().size() == parameters.size() + 1 );
+
+    for( u32 i = 1; i < value.operands().size(); i++ )
+    {
+        Value* argument = value.operands()[ i ].get();
+
+        if( c.scalars().count( argument ) )
+        {
+            const std::vector< X86Gp > elements = c.scalars()[ argument ];
+            c.scalars()[ parameters[ i - 1 ] ] = elements;
+            VERBOSE(
+                "%s := %s ;; inline scalar",
+                parameters[ i - 1 ]->label().c_str(),
+                argument->label().c_str() );
+            continue;
+        }
+
+        alloc_reg_for_value( *argument, c );
+
+        c.val2reg()[ parameters[ i - 1 ] ] = c.val2reg()[ argument ];
         VERBOSE(
-            "ptr( %s, %u ) [ '%s' @ %s --> bs = %lu ]",
-            base->label().c_str(),
-            byte_offset,
-            base->type().name().c_str(),
-            index.name().c_str(),
-            base->type()
-                .results()[ index.value().value() ]
-                ->bitsize() );  // PPA: FIXME: index access!!!
+            "%s := %s ;; inline",
+            parameters[ i - 1 ]->label().c_str(),
+            argument->label().c_str() );
     }
-    else
+
+    if( c.isInstrumented() )
     {
-        assert( 0 );
+        count( c.runtime().invocations( &callee ), c );
+    }
+
+    c.inlining().emplace( &callee );
+    callee.context()->iterate( Traversal::PREORDER, this, &c );
+    c.inlining().erase( &callee );
+
+    // every inlined instance gets its own registers
+    for( auto param : parameters )
+    {
+        c.val2reg().erase( param );
+        c.scalars().erase( param );
     }
+
+    callee.context()->iterate( Traversal::PREORDER, [&]( Value& node ) {
+        if( isa< libcjel_ir::Instruction >( node ) )
+        {
+            c.val2reg().erase( &node );
+            c.val2mem().erase( &node );
+            c.vectors().erase( &node );
+        }
+    } );
 }
-void CjelIRToAsmJitPass::visit_epilog( ExtractInstruction& value, libcjel_ir::Context& cxt )
+
+u1 CjelIRToAsmJitPass::scalarizable( CallInstruction& value, u32 operand, Context& c )
 {
-}
+    Value& argument = *value.operand( operand );
+    const auto& type = argument.type();
 
-//
-// LoadInstruction
-//
+    if( not isa< AllocInstruction >( argument ) or c.runtime().parallelUpdates() or
+        not inlinable( value, c ) )
+    {
+        return false;
+    }
 
-void CjelIRToAsmJitPass::visit_prolog( LoadInstruction& value, libcjel_ir::Context& cxt )
+    if( type.isStructure() )
+    {
+        if( type.results().size() > SCALAR_ELEMENTS )
+        {
+            return false;
+        }
+
+        for( u32 i = 0; i < type.results().size(); i++ )
+        {
+            const auto& element = *type.results()[ i ];
+
+            if( not element.isBit() or is_wide( element ) )
+            {
+                return false;
+            }
+        }
+    }
+    else if( not type.isBit() or is_wide( type ) )
+    {
+        return false;
+    }
+
+    auto& callee = static_cast< Intrinsic& >( *value.callee() );
+
+    if( forkable( *callee.context(), c ) )
+    {
+        // forked statements capture the addresses of their locations
+        return false;
+    }
+
+    const u32 inputs = callee.inputs().size();
+    Value* parameter = operand <= inputs ? callee.inputs()[ operand - 1 ].get()
+                                         : callee.outputs()[ operand - 1 - inputs ].get();
+
+    std::unordered_set< Value* > elements;
+    u1 result = true;
+
+    callee.context()->iterate( Traversal::PREORDER, [&]( Value& node ) {
+        if( not isa< libcjel_ir::Instruction >( node ) )
+        {
+            return;
+        }
+
+        auto& instruction = static_cast< libcjel_ir::Instruction& >( node );
+
+        for( u32 i = 0; i < instruction.operands().size(); i++ )
+        {
+            Value* v = instruction.operand( i ).get();
+
+            if( v == parameter )
+            {
+                if( type.isStructure() and isa< ExtractInstruction >( instruction ) and i == 0 and
+                    isa< BitConstant >( instruction.operand( 1 ) ) )
+                {
+                    elements.emplace( &instruction );
+                }
+                else if( not( type.isBit() and isa< StoreInstruction >( instruction ) and i == 1 ) )
+                {
+                    result = false;
+                }
+            }
+            else if( elements.count( v ) )
+            {
+                if( not( isa< LoadInstruction >( instruction ) and i == 0 ) and
+                    not( isa< StoreInstruction >( instruction ) and i == 1 ) )
+                {
+                    result = false;
+                }
+            }
+        }
+    } );
+
+    return result;
+}
+
+X86Mem CjelIRToAsmJitPass::pooled( const std::string& bytes, Context& c )
 {
-    TRACE( "" );
-    Context& c = static_cast< Context& >( cxt );
+    auto result = c.pool().emplace( bytes, Label() );
 
-    alloc_reg_for_value( value, c );
+    if( result.second )
+    {
+        // data blocks follow all functions, so they never get executed and
+        // live in the read-only executable memory of the runtime
+        Label label = c.compiler().newLabel();
+        result.first->second = label;
 
-    auto src = value.operand( 0 ).get();
+        CBNode* cursor = c.compiler().getCursor();
+        c.compiler().setCursor( c.compiler().getLastNode() );
 
-    if( isa< ExtractInstruction >( src ) )
+        c.compiler().align( kAlignData, 16 );
+        c.compiler().bind( label );
+        c.compiler().embed( bytes.data(), bytes.size() );
+
+        c.compiler().setCursor( cursor );
+        NOTE( "embed( %lu ) ;; pool", bytes.size() );
+    }
+
+    return x86::ptr( result.first->second );
+}
+
+X86Mem CjelIRToAsmJitPass::slot( u32 byte_size, Context& c )
+{
+    // largest power of two up to the size, limited to the one of vector moves
+    u32 alignment = 1;
+    while( alignment < 16 and alignment * 2 <= byte_size )
     {
-        c.compiler().mov( c.val2reg()[&value ], c.val2mem()[ src ] );
-        VERBOSE( "mov %s, %s", value.label().c_str(), src->label().c_str() );
+        alignment *= 2;
     }
-    else
+
+    std::vector< Context::Slot >& slots = c.slots();
+    std::size_t index = slots.size();
+
+    for( std::size_t i = 0; i < slots.size(); i++ )
     {
-        assert( 0 );
+        const Context::Slot& slot = slots[ i ];
+
+        if( slot.used or slot.size < byte_size or slot.alignment < alignment )
+        {
+            continue;
+        }
+
+        if( index == slots.size() or slot.size < slots[ index ].size )
+        {
+            index = i;
+        }
+    }
+
+    if( index == slots.size() )
+    {
+        slots.emplace_back(
+            Context::Slot{ c.compiler().newStack( byte_size, alignment ), byte_size, alignment,
+                false } );
+        NOTE( "newStack( %u, %u )", byte_size, alignment );
     }
+
+    slots[ index ].used = true;
+    c.live().emplace_back( index );
+
+    return slots[ index ].memory;
 }
-void CjelIRToAsmJitPass::visit_epilog( LoadInstruction& value, libcjel_ir::Context& cxt )
+
+void CjelIRToAsmJitPass::release( std::size_t live, Context& c )
 {
+    if( c.updates() )
+    {
+        // the update set may still write into the slots, they are released
+        // by the scope which commits it
+        return;
+    }
+
+    while( c.live().size() > live )
+    {
+        c.slots()[ c.live().back() ].used = false;
+        c.live().pop_back();
+    }
 }
 
-//
-// StoreInstruction
-//
+void CjelIRToAsmJitPass::callable_prolog( CallableUnit& value, Context& c )
+{
+    Context::Callable& func = c.callable( &value );
+    func.argsize( -1 );
 
-void CjelIRToAsmJitPass::visit_prolog( StoreInstruction& value, libcjel_ir::Context& cxt )
+    FuncSignatureX& fsig = func.funcsig();
+    fsig.init( CallConv::kIdHost, TypeId::kVoid, fsig._builderArgList, 0 );
+}
+
+void CjelIRToAsmJitPass::callable_interlog( CallableUnit& value, Context& c )
 {
-    TRACE( "" );
-    Context& c = static_cast< Context& >( cxt );
+    Context::Callable& func = c.callable( &value );
+
+    if( func.func() )
+    {
+        // declared by the module, its signature equals the one of the prolog
+        c.compiler().addFunc( func.func() );
+    }
+    else
+    {
+        c.compiler().addFunc( func.funcsig() );
+    }
+    VERBOSE( "addFunc( %s )", value.name().c_str() );
+
+    if( value.context() )
+    {
+        number( *value.context(), c );
+    }
 
-    auto src = value.operand( 0 ).get();
-    auto dst = value.operand( 1 ).get();
+    // registers and slots of previously emitted functions are not accessible
+    // anymore
+    c.val2reg().clear();
+    c.val2mem().clear();
+    c.slots().clear();
+    c.live().clear();
+    c.setCold( nullptr );
 
-    alloc_reg_for_value( *src, c );
+    for( auto param : value.inputs() )
+    {
+        assert( isa< Reference >( param ) );
+        alloc_reg_for_value( *param, c );
+    }
 
-    if( isa< ExtractInstruction >( dst ) )
+    for( auto param : value.outputs() )
     {
-        c.compiler().mov( c.val2mem()[ dst ], c.val2reg()[ src ] );
-        VERBOSE(
-            "mov %s, %s (%s)", dst->label().c_str(), src->label().c_str(), src->name().c_str() );
+        assert( isa< Reference >( param ) );
+        alloc_reg_for_value( *param, c );
     }
-    else if( isa< Reference >( dst ) and dst->type().isBit() )
+
+    for( auto param : value.linkage() )
     {
-        c.compiler().mov( x86::ptr( c.val2reg()[ dst ], 0 ), c.val2reg()[ src ] );
-        VERBOSE(
-            "mov ptr( %s ), %s (%s)",
-            dst->label().c_str(),
-            src->label().c_str(),
-            src->name().c_str() );
+        assert( param and 0 );
     }
-    else
+
+    if( c.isInstrumented() )
     {
-        assert( not" unsupported 'store' instruction usage! " );
+        count( c.runtime().invocations( &value ), c );
     }
-}
-void CjelIRToAsmJitPass::visit_epilog( StoreInstruction& value, libcjel_ir::Context& cxt )
-{
-}
 
-//
-// NotInstruction
-//
+    assert( func.funcsig().getArgCount() == func.argsize() );
+}
 
-void CjelIRToAsmJitPass::visit_prolog( NotInstruction& value, libcjel_ir::Context& cxt )
+void CjelIRToAsmJitPass::callable_epilog( CallableUnit& value, Context& c )
 {
-    TRACE( "" );
-    Context& c = static_cast< Context& >( cxt );
+    c.compiler().endFunc();
+    VERBOSE( "endFunc" );
 
-    auto res = &value;
-    auto lhs = value.operand( 0 ).get();
+    // forked statements are placed behind their parent function
+    compile_tasks( c );
 
-    alloc_reg_for_value( *res, c );
-    alloc_reg_for_value( *lhs, c );
+    if( c.isModule() )
+    {
+        // the module is linked as a whole in its epilog
+        return;
+    }
 
-    c.compiler().mov( c.val2reg()[ res ], c.val2reg()[ lhs ] );
-    VERBOSE( "mov %s, %s", res->label().c_str(), lhs->label().c_str() );
+    void* func_ptr = link( value, c );
 
-    c.compiler().not_( c.val2reg()[ res ] );
-    VERBOSE( "not_ %s", res->label().c_str() );
+    Context::Callable& func = c.callable( &value );
+    func.funcptr( static_cast< void** >( func_ptr ) );
 }
-void CjelIRToAsmJitPass::visit_epilog( NotInstruction& value, libcjel_ir::Context& cxt )
+
+void* CjelIRToAsmJitPass::finalize( Value& value, Context& c )
 {
+    c.compiler().endFunc();
+
+    return link( value, c );
 }
 
-//
-// LnotInstruction
-//
+void* CjelIRToAsmJitPass::link( Value& value, Context& c )
+{
+    c.compiler().finalize();
 
-void CjelIRToAsmJitPass::visit_prolog( LnotInstruction& value, libcjel_ir::Context& cxt )
+    void* func_ptr = c.runtime().add( c.codeholder() );
+
+    fprintf(
+        stderr,
+        "asmjit: %s @ %p\n"
+        "~~~{.asm}\n"
+        "%s"
+        "~~~\n",
+        value.name().c_str(),
+        func_ptr,
+        c.logger().getString() );
+
+    c.functions().emplace_back( func_ptr );
+    return func_ptr;
+}
+
+void* CjelIRToAsmJitPass::compile( libcjel_ir::OperatorInstruction& value, Context& c )
 {
-    TRACE( "" );
-    Context& c = static_cast< Context& >( cxt );
+    libcjel_ir::CjelIRDumpPass dump;
 
-    auto res = &value;
-    auto lhs = value.operand( 0 ).get();
+    c.reset();
 
-    Label lbl_true = c.compiler().newLabel();
-    Label lbl_exit = c.compiler().newLabel();
+    assert( value.operands().size() <= 2 );
 
-    alloc_reg_for_value( *res, c );
-    alloc_reg_for_value( *lhs, c );
+    Context::Callable& func = c.callable( &value );
+    func.argsize( -1 );
 
-    c.compiler().cmp( c.val2reg()[ lhs ], asmjit::imm( 0 ) );
-    VERBOSE( "cmp %s, imm( 0 )", lhs->label().c_str() );
+    const u1 returned = returned_in_register( value.type() );
+
+    FuncSignatureX& fsig = func.funcsig();
+    fsig.init(
+        CallConv::kIdHost, returned ? TypeId::kU64 : TypeId::kVoid, fsig._builderArgList, 0 );
+    if( not returned )
+    {
+        fsig.addArg( TypeId::kUIntPtr );
+    }
+    for( u32 i = 0; i < value.operands().size(); i++ )
+    {
+        assert( libcjel_ir::isa< libcjel_ir::Constant >( value.operand( i ) ) );
+        fsig.addArg( passed_in_register( value.operand( i )->type() ) ? TypeId::kU64
+                                                                        : TypeId::kUIntPtr );
+    }
 
-    // jump if equal to true path, else cont with false path
-    c.compiler().je( lbl_true );
-    VERBOSE( "je 'lbl_true'" );
+    c.compiler().addFunc( func.funcsig() );
+    VERBOSE( "addFunc( %s )", value.name().c_str() );
 
-    // false path
-    c.compiler().mov( c.val2reg()[&value ], asmjit::imm( 0 ) );
-    VERBOSE( "mov %s, imm( 0 )", value.label().c_str() );
+    X86Gp out;
+    if( not returned )
+    {
+        out = c.compiler().newUIntPtr( "out" );
+        c.compiler().setArg( 0, out );
+        VERBOSE( "setArg( %u, %s )", 0, "out" );
+    }
 
-    c.compiler().jmp( lbl_exit );
-    VERBOSE( "jmp 'lbl_exit'" );
+    for( u32 i = 0; i < value.operands().size(); i++ )
+    {
+        alloc_reg_for_input( *value.operand( i ), i + ( returned ? 0 : 1 ), c );
+    }
 
-    // true path
-    c.compiler().bind( lbl_true );
-    VERBOSE( "bind 'lbl_true'" );
+    value.iterate( libcjel_ir::Traversal::PREORDER, this, &c );
+    value.iterate( libcjel_ir::Traversal::PREORDER, &dump );
 
-    c.compiler().mov( c.val2reg()[&value ], asmjit::imm( 1 ) );
-    VERBOSE( "mov %s, imm( 1 )", value.label().c_str() );
+    if( returned )
+    {
+        X86Gp word =
+            zero_extend_word( c.val2reg()[&value ], value.type().bitsize(), c.compiler() );
+        c.compiler().ret( word );
+        VERBOSE( "ret %s", value.label().c_str() );
+    }
+    else
+    {
+        copy( out, c.val2reg()[&value ], calc_byte_size( value.type() ), c );
+        VERBOSE( "copy( out, %s )", value.label().c_str() );
+    }
 
-    // end if compare
-    c.compiler().bind( lbl_exit );
-    VERBOSE( "bind 'lbl_exit'" );
-}
-void CjelIRToAsmJitPass::visit_epilog( LnotInstruction& value, libcjel_ir::Context& cxt )
-{
+    void* func_ptr = finalize( value, c );
+    func.funcptr( static_cast< void** >( func_ptr ) );
+    return func_ptr;
 }
 
-//
-// AndInstruction
-//
-
-void CjelIRToAsmJitPass::visit_prolog( AndInstruction& value, libcjel_ir::Context& cxt )
+std::vector< CallableUnit* > CjelIRToAsmJitPass::open_module(
+    libcjel_ir::CallInstruction& value, Context& c )
 {
-    TRACE( "" );
-    Context& c = static_cast< Context& >( cxt );
+    libcjel_ir::CjelIRDumpPass dump;
 
-    auto res = &value;
-    auto lhs = value.operand( 0 ).get();
-    auto rhs = value.operand( 1 ).get();
+    // the call and all reachable callees share one code holder, so every
+    // call between them is a direct relative one
+    c.reset();
+    c.setModule( true );
 
-    alloc_reg_for_value( *res, c );
-    alloc_reg_for_value( *lhs, c );
-    alloc_reg_for_value( *rhs, c );
+    assert( isa< CallableUnit >( value.callee() ) );
+    std::vector< CallableUnit* > callees;
+    collect( static_cast< CallableUnit& >( *value.callee() ), callees );
 
-    c.compiler().mov( c.val2reg()[ res ], c.val2reg()[ lhs ] );
-    VERBOSE( "mov %s, %s", res->label().c_str(), lhs->label().c_str() );
+    for( auto callee : callees )
+    {
+        callee->iterate( libcjel_ir::Traversal::PREORDER, &dump );
+        declare( *callee, c );
+    }
 
-    c.compiler().and_( c.val2reg()[ res ], c.val2reg()[ rhs ] );
-    VERBOSE( "and_ %s, %s", res->label().c_str(), rhs->label().c_str() );
-}
-void CjelIRToAsmJitPass::visit_epilog( AndInstruction& value, libcjel_ir::Context& cxt )
-{
-}
+    value.iterate( libcjel_ir::Traversal::PREORDER, &dump );
 
-//
-// OrInstruction
-//
+    return callees;
+}
 
-void CjelIRToAsmJitPass::visit_prolog( OrInstruction& value, libcjel_ir::Context& cxt )
+void* CjelIRToAsmJitPass::close_module( libcjel_ir::CallInstruction& value,
+    const std::vector< CallableUnit* >& callees,
+    Context& c )
 {
-    TRACE( "" );
-    Context& c = static_cast< Context& >( cxt );
+    // statements forked by inlined callee bodies
+    compile_tasks( c );
 
-    const auto res = &value;
-    const auto lhs = value.operand( 0 ).get();
-    const auto rhs = value.operand( 1 ).get();
+    // create Builtin/Rule asm jit for all callees which were not inlined
+    std::unordered_set< CallableUnit* > emitted;
+    for( u1 pending = true; pending; )
+    {
+        pending = false;
 
-    alloc_reg_for_value( *res, c );
-    alloc_reg_for_value( *lhs, c );
-    alloc_reg_for_value( *rhs, c );
+        for( auto callee : callees )
+        {
+            if( c.called().find( callee ) != c.called().end() and emitted.emplace( callee ).second )
+            {
+                callee->iterate( libcjel_ir::Traversal::PREORDER, this, &c );
+                pending = true;
+            }
+        }
+    }
 
-    c.compiler().mov( c.val2reg()[ res ], c.val2reg()[ lhs ] );
-    VERBOSE( "mov %s, %s", res->label().c_str(), lhs->label().c_str() );
+    c.setModule( false );
 
-    c.compiler().or_( c.val2reg()[ res ], c.val2reg()[ rhs ] );
-    VERBOSE( "or_ %s, %s", res->label().c_str(), rhs->label().c_str() );
+    void* func_ptr = link( value, c );
+    c.callable( &value ).funcptr( static_cast< void** >( func_ptr ) );
+    return func_ptr;
 }
-void CjelIRToAsmJitPass::visit_epilog( OrInstruction& value, libcjel_ir::Context& cxt )
+
+void CjelIRToAsmJitPass::scalarize( libcjel_ir::CallInstruction& value, u32 operand, Context& c )
 {
-}
+    // the result is kept in zeroed registers and written out once
+    const auto& type = value.operand( operand )->type();
+    std::vector< X86Gp > elements;
 
-//
-// XorInstruction
-//
+    if( type.isBit() )
+    {
+        elements.emplace_back( new_reg_for_bit_type( type, "element", c.compiler() ) );
+    }
+    else
+    {
+        for( const auto& element : type.results() )
+        {
+            elements.emplace_back( new_reg_for_bit_type( *element, "element", c.compiler() ) );
+        }
+    }
 
-void CjelIRToAsmJitPass::visit_prolog( XorInstruction& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    FIXME();
+    for( const auto& element : elements )
+    {
+        c.compiler().xor_( element, element );
+    }
+
+    c.scalars()[ value.operand( operand ).get() ] = elements;
+    VERBOSE( "scalar( %s, %lu )", value.operand( operand )->label().c_str(), elements.size() );
 }
-void CjelIRToAsmJitPass::visit_epilog( XorInstruction& value, libcjel_ir::Context& cxt )
+
+void CjelIRToAsmJitPass::store_scalars( libcjel_ir::Value& value, const X86Gp& dst, Context& c )
 {
-}
+    const auto& type = value.type();
+    const auto& elements = c.scalars()[&value ];
 
-//
-// AddUnsignedInstruction
-//
+    for( u32 i = 0; i < elements.size(); i++ )
+    {
+        const u32 offset = type.isBit() ? 0 : element_offset( type, i );
+        c.compiler().mov( x86::ptr( dst, offset ), elements[ i ] );
+    }
+    VERBOSE( "mov ptr, scalar( %s )", value.label().c_str() );
+}
 
-void CjelIRToAsmJitPass::visit_prolog( AddUnsignedInstruction& value, libcjel_ir::Context& cxt )
+u32 CjelIRToAsmJitPass::vectorizable( CallInstruction& value, Context& c )
 {
-    TRACE( "" );
-    Context& c = static_cast< Context& >( cxt );
+    if( c.isInstrumented() or not inlinable( value, c ) )
+    {
+        return 0;
+    }
 
-    const auto res = &value;
-    const auto lhs = value.operand( 0 ).get();
-    const auto rhs = value.operand( 1 ).get();
+    auto& callee = static_cast< Intrinsic& >( *value.callee() );
 
-    alloc_reg_for_value( *res, c );
-    alloc_reg_for_value( *lhs, c );
-    alloc_reg_for_value( *rhs, c );
+    std::vector< Value* > parameters;
+    for( auto param : callee.inputs() )
+    {
+        parameters.emplace_back( param.get() );
+    }
+    for( auto param : callee.outputs() )
+    {
+        parameters.emplace_back( param.get() );
+    }
 
-    c.compiler().mov( c.val2reg()[ res ], c.val2reg()[ lhs ] );
-    VERBOSE( "mov %s, %s", res->label().c_str(), lhs->label().c_str() );
+    // every element of a stream is held in one lane
+    u32 width = 1;
+    for( u32 i = 1; i < value.operands().size(); i++ )
+    {
+        const u32 size = calc_byte_size( value.operand( i )->type() );
 
-    c.compiler().add( c.val2reg()[ res ], c.val2reg()[ rhs ] );
-    VERBOSE( "add %s, %s", res->label().c_str(), rhs->label().c_str() );
-}
-void CjelIRToAsmJitPass::visit_epilog( AddUnsignedInstruction& value, libcjel_ir::Context& cxt )
-{
-}
+        if( size > 8 or ( size & ( size - 1 ) ) != 0 )
+        {
+            return 0;
+        }
 
-//
-// AddSignedInstruction
-//
+        width = std::max( width, size );
+    }
 
-void CjelIRToAsmJitPass::visit_prolog( AddSignedInstruction& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    FIXME();
-}
-void CjelIRToAsmJitPass::visit_epilog( AddSignedInstruction& value, libcjel_ir::Context& cxt )
-{
-}
+    const u32 inputs = callee.inputs().size();
 
-//
-// DivSignedInstruction
-//
+    // elements of the inputs, locations of the result and their byte sizes
+    std::unordered_map< Value*, u32 > fields;
+    std::unordered_map< Value*, u32 > locations;
+    std::unordered_set< Value* > values;
+    std::unordered_set< Value* > stored;
 
-void CjelIRToAsmJitPass::visit_prolog( DivSignedInstruction& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    FIXME();
-}
-void CjelIRToAsmJitPass::visit_epilog( DivSignedInstruction& value, libcjel_ir::Context& cxt )
-{
-}
+    if( parameters.back()->type().isBit() )
+    {
+        locations[ parameters.back() ] = calc_byte_size( parameters.back()->type() );
+    }
 
-//
-// ModUnsignedInstruction
-//
+    u1 result = true;
 
-void CjelIRToAsmJitPass::visit_prolog( ModUnsignedInstruction& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    FIXME();
-}
-void CjelIRToAsmJitPass::visit_epilog( ModUnsignedInstruction& value, libcjel_ir::Context& cxt )
-{
-}
+    callee.context()->iterate( Traversal::PREORDER, [&]( Value& node ) {
+        if( isa< Statement >( node ) and not isa< TrivialStatement >( node ) )
+        {
+            // only straight-line bodies are evaluated lane-wise
+            result = false;
+            return;
+        }
 
-//
-// EquInstruction
-//
+        if( not result or not isa< libcjel_ir::Instruction >( node ) )
+        {
+            return;
+        }
 
-void CjelIRToAsmJitPass::visit_prolog( EquInstruction& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    Context& c = static_cast< Context& >( cxt );
+        auto& instruction = static_cast< libcjel_ir::Instruction& >( node );
 
-    const auto res = &value;
-    const auto lhs = value.operand( 0 ).get();
-    const auto rhs = value.operand( 1 ).get();
+        const auto operand = [&]( u32 i ) -> u1 {
+            Value* v = instruction.operand( i ).get();
+            return values.count( v ) or ( isa< BitConstant >( v ) and not is_wide( v->type() ) );
+        };
 
-    Label lbl_true = c.compiler().newLabel();
-    Label lbl_exit = c.compiler().newLabel();
+        if( isa< ExtractInstruction >( instruction ) )
+        {
+            const auto base = std::find(
+                parameters.begin(), parameters.end(), instruction.operand( 0 ).get() );
 
-    alloc_reg_for_value( *res, c );
-    alloc_reg_for_value( *lhs, c );
-    alloc_reg_for_value( *rhs, c );
+            if( base == parameters.end() or not( *base )->type().isStructure() or
+                not isa< BitConstant >( instruction.operand( 1 ) ) )
+            {
+                result = false;
+                return;
+            }
 
-    c.compiler().cmp( c.val2reg()[ lhs ], c.val2reg()[ rhs ] );
-    VERBOSE( "cmp %s, %s", lhs->label().c_str(), rhs->label().c_str() );
+            const auto& type = ( *base )->type();
+            const u64 index =
+                static_cast< BitConstant& >( *instruction.operand( 1 ) ).value().value();
+
+            if( index >= type.results().size() or not type.results()[ index ]->isBit() or
+                is_wide( *type.results()[ index ] ) or
+                element_offset( type, index ) + calc_byte_size( *type.results()[ index ] ) >
+                    calc_byte_size( type ) )
+            {
+                result = false;
+                return;
+            }
 
-    // jump if equal to true path, else cont with false path
-    c.compiler().je( lbl_true );
-    VERBOSE( "je 'lbl_true'" );
+            const u32 size = calc_byte_size( *type.results()[ index ] );
 
-    // false path
-    c.compiler().mov( c.val2reg()[&value ], asmjit::imm( 0 ) );
-    VERBOSE( "mov %s, imm( 0 )", value.label().c_str() );
+            if( base - parameters.begin() < inputs )
+            {
+                fields[&instruction ] = size;
+            }
+            else
+            {
+                locations[&instruction ] = size;
+            }
+        }
+        else if( isa< LoadInstruction >( instruction ) )
+        {
+            result = fields.count( instruction.operand( 0 ).get() ) > 0;
+            values.emplace( &instruction );
+        }
+        else if( isa< StoreInstruction >( instruction ) )
+        {
+            // every location of the result is written at most once
+            Value* dst = instruction.operand( 1 ).get();
 
-    c.compiler().jmp( lbl_exit );
-    VERBOSE( "jmp 'lbl_exit'" );
+            result = operand( 0 ) and locations.count( dst ) and
+                     calc_byte_size( instruction.operand( 0 )->type() ) == locations[ dst ] and
+                     stored.emplace( dst ).second;
+        }
+        else if( isa< AndInstruction >( instruction ) or isa< OrInstruction >( instruction ) or
+                 isa< XorInstruction >( instruction ) or
+                 isa< AddUnsignedInstruction >( instruction ) or
+                 isa< EquInstruction >( instruction ) or isa< NeqInstruction >( instruction ) )
+        {
+            result = operand( 0 ) and operand( 1 );
+            values.emplace( &instruction );
+        }
+        else if( isa< NotInstruction >( instruction ) or
+                 isa< ZeroExtendInstruction >( instruction ) or
+                 isa< TruncationInstruction >( instruction ) )
+        {
+            result = operand( 0 );
+            values.emplace( &instruction );
+        }
+        else
+        {
+            result = false;
+        }
 
-    // true path
-    c.compiler().bind( lbl_true );
-    VERBOSE( "bind 'lbl_true'" );
+        if( values.count( &instruction ) )
+        {
+            if( not instruction.type().isBit() or is_wide( instruction.type() ) )
+            {
+                result = false;
+                return;
+            }
 
-    c.compiler().mov( c.val2reg()[&value ], asmjit::imm( 1 ) );
-    VERBOSE( "mov %s, imm( 1 )", value.label().c_str() );
+            width = std::max( width, calc_byte_size( instruction.type() ) );
+        }
+    } );
 
-    // end if compare
-    c.compiler().bind( lbl_exit );
-    VERBOSE( "bind 'lbl_exit'" );
-}
-void CjelIRToAsmJitPass::visit_epilog( EquInstruction& value, libcjel_ir::Context& cxt )
-{
+    return result ? width : 0;
 }
 
-//
-// NeqInstruction
-//
-
-void CjelIRToAsmJitPass::visit_prolog( NeqInstruction& value, libcjel_ir::Context& cxt )
+void CjelIRToAsmJitPass::vectorize( CallInstruction& value,
+    const std::vector< u32 >& operands,
+    const std::vector< X86Gp >& cursors,
+    const std::vector< X86Gp >& strides,
+    const X86Gp& count,
+    u32 width,
+    Context& c )
 {
-    TRACE( "" );
-    Context& c = static_cast< Context& >( cxt );
+    const u1 avx = CpuInfo::getHost().hasFeature( CpuInfo::kX86FeatureAVX2 );
+    const u32 bytes = avx ? 32 : 16;
+    const u32 lanes = bytes / width;
+    const u32 w = width == 1 ? 0 : width == 2 ? 1 : width == 4 ? 2 : 3;
+
+    // SSE2 and AVX2 forms of the lane operations per lane width
+    static const u32 padd[ 4 ][ 2 ] = { { X86Inst::kIdPaddb, X86Inst::kIdVpaddb },
+        { X86Inst::kIdPaddw, X86Inst::kIdVpaddw },
+        { X86Inst::kIdPaddd, X86Inst::kIdVpaddd },
+        { X86Inst::kIdPaddq, X86Inst::kIdVpaddq } };
+    static const u32 pcmpeq[ 4 ][ 2 ] = { { X86Inst::kIdPcmpeqb, X86Inst::kIdVpcmpeqb },
+        { X86Inst::kIdPcmpeqw, X86Inst::kIdVpcmpeqw },
+        { X86Inst::kIdPcmpeqd, X86Inst::kIdVpcmpeqd },
+        { X86Inst::kIdPcmpeqd, X86Inst::kIdVpcmpeqq } };
+    static const u32 psrl[ 4 ][ 2 ] = { { X86Inst::kIdNone, X86Inst::kIdNone },
+        { X86Inst::kIdPsrlw, X86Inst::kIdVpsrlw },
+        { X86Inst::kIdPsrld, X86Inst::kIdVpsrld },
+        { X86Inst::kIdPsrlq, X86Inst::kIdVpsrlq } };
+    static const u32 psll[ 4 ][ 2 ] = { { X86Inst::kIdNone, X86Inst::kIdNone },
+        { X86Inst::kIdPsllw, X86Inst::kIdVpsllw },
+        { X86Inst::kIdPslld, X86Inst::kIdVpslld },
+        { X86Inst::kIdPsllq, X86Inst::kIdVpsllq } };
+
+    const auto vec = [&]( const char* name ) -> X86Vec {
+        if( avx )
+        {
+            return c.compiler().newYmm( name );
+        }
+        return c.compiler().newXmm( name );
+    };
 
-    const auto res = &value;
-    const auto lhs = value.operand( 0 ).get();
-    const auto rhs = value.operand( 1 ).get();
+    // the SSE2 forms overwrite their first operand, so it is copied first
+    const auto packed = [&]( const u32* id, const X86Vec& lhs, const Operand& rhs ) -> X86Vec {
+        X86Vec res = vec( "lane" );
+        if( avx )
+        {
+            c.compiler().emit( id[ 1 ], res, lhs, rhs );
+        }
+        else
+        {
+            c.compiler().emit( X86Inst::kIdMovdqa, res, lhs );
+            c.compiler().emit( id[ 0 ], res, rhs );
+        }
+        return res;
+    };
 
-    Label lbl_true = c.compiler().newLabel();
-    Label lbl_exit = c.compiler().newLabel();
+    static const u32 pand[ 2 ] = { X86Inst::kIdPand, X86Inst::kIdVpand };
+    static const u32 por[ 2 ] = { X86Inst::kIdPor, X86Inst::kIdVpor };
+    static const u32 pxor[ 2 ] = { X86Inst::kIdPxor, X86Inst::kIdVpxor };
 
-    alloc_reg_for_value( *res, c );
-    alloc_reg_for_value( *lhs, c );
-    alloc_reg_for_value( *rhs, c );
+    // the low 'size' bytes of 'word' in every lane
+    const auto broadcast = [&]( u64 word, u32 size ) -> X86Mem {
+        std::string data( bytes, '\0' );
+        for( u32 i = 0; i < bytes; i += width )
+        {
+            memcpy( &data[ i ], &word, size );
+        }
+        return pooled( data, c );
+    };
 
-    c.compiler().cmp( c.val2reg()[ lhs ], c.val2reg()[ rhs ] );
-    VERBOSE( "cmp %s, %s", lhs->label().c_str(), rhs->label().c_str() );
+    // lanes of comparison results are masks until their value is needed
+    struct Lane
+    {
+        X86Vec reg;
+        u1 mask;
+    };
+    std::unordered_map< Value*, Lane > lane;
 
-    // jump if not equal to true path, else cont with false path
-    c.compiler().jne( lbl_true );
-    VERBOSE( "jne 'lbl_true'" );
+    const auto get = [&]( Value* v ) -> X86Vec {
+        if( isa< BitConstant >( v ) )
+        {
+            X86Vec reg = vec( v->label().c_str() );
+            c.compiler().emit( avx ? X86Inst::kIdVmovdqu : X86Inst::kIdMovdqu,
+                reg,
+                broadcast( static_cast< BitConstant& >( *v ).value().value(),
+                    calc_byte_size( v->type() ) ) );
+            return reg;
+        }
 
-    // false path
-    c.compiler().mov( c.val2reg()[&value ], asmjit::imm( 0 ) );
-    VERBOSE( "mov %s, imm( 0 )", value.label().c_str() );
+        Lane& l = lane[ v ];
+        if( l.mask )
+        {
+            l.reg = packed( pand, l.reg, broadcast( 1, 1 ) );
+            l.mask = false;
+        }
+        return l.reg;
+    };
 
-    c.compiler().jmp( lbl_exit );
-    VERBOSE( "jmp 'lbl_exit'" );
+    auto& callee = static_cast< Intrinsic& >( *value.callee() );
 
-    // true path
-    c.compiler().bind( lbl_true );
-    VERBOSE( "bind 'lbl_true'" );
+    std::unordered_map< Value*, u32 > streams;
+    for( u32 k = 0; k < operands.size(); k++ )
+    {
+        const u32 inputs = callee.inputs().size();
+        const u32 i = operands[ k ] - 1;
+        streams[ i < inputs ? callee.inputs()[ i ].get() : callee.outputs()[ i - inputs ].get() ] =
+            k;
+    }
 
-    c.compiler().mov( c.val2reg()[&value ], asmjit::imm( 1 ) );
-    VERBOSE( "mov %s, imm(1)", value.label().c_str() );
+    // element records of the input streams, zero extended to the lane width
+    std::vector< X86Vec > records( operands.size() );
+    std::vector< u1 > loaded( operands.size(), false );
 
-    // end if compare
-    c.compiler().bind( lbl_exit );
-    VERBOSE( "bind 'lbl_exit'" );
-}
-void CjelIRToAsmJitPass::visit_epilog( NeqInstruction& value, libcjel_ir::Context& cxt )
-{
-}
+    const auto record = [&]( u32 k ) -> X86Vec {
+        if( loaded[ k ] )
+        {
+            return records[ k ];
+        }
 
-//
-// ZeroExtendInstruction
-//
+        const u32 size = calc_byte_size( value.operand( operands[ k ] )->type() );
+        const u32 total = lanes * size;
+        X86Mem src = x86::ptr( cursors[ k ], 0 );
+        X86Vec reg = vec( "record" );
 
-void CjelIRToAsmJitPass::visit_prolog( ZeroExtendInstruction& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    FIXME();
-}
-void CjelIRToAsmJitPass::visit_epilog( ZeroExtendInstruction& value, libcjel_ir::Context& cxt )
-{
-}
+        if( avx and size < width )
+        {
+            static const u32 zext[ 4 ][ 4 ] = {
+                { 0, X86Inst::kIdVpmovzxbw, X86Inst::kIdVpmovzxbd, X86Inst::kIdVpmovzxbq },
+                { 0, 0, X86Inst::kIdVpmovzxwd, X86Inst::kIdVpmovzxwq },
+                { 0, 0, 0, X86Inst::kIdVpmovzxdq },
+            };
+            const u32 from = size == 1 ? 0 : size == 2 ? 1 : 2;
+            c.compiler().emit( zext[ from ][ w ], reg, src );
+        }
+        else
+        {
+            if( total >= 16 )
+            {
+                c.compiler().emit( avx ? X86Inst::kIdVmovdqu : X86Inst::kIdMovdqu, reg, src );
+            }
+            else if( total >= 4 )
+            {
+                src.setSize( total );
+                c.compiler().emit( total == 8 ? X86Inst::kIdMovq : X86Inst::kIdMovd, reg, src );
+            }
+            else
+            {
+                X86Gp word = c.compiler().newU32( "word" );
+                c.compiler().movzx( word, x86::word_ptr( cursors[ k ], 0 ) );
+                c.compiler().emit( X86Inst::kIdMovd, reg, word );
+            }
 
-//
-// TruncationInstruction
-//
+            if( size < width )
+            {
+                X86Vec zeros = vec( "zeros" );
+                c.compiler().emit( X86Inst::kIdPxor, zeros, zeros );
 
-void CjelIRToAsmJitPass::visit_prolog( TruncationInstruction& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    Context& c = static_cast< Context& >( cxt );
+                for( u32 s = size; s < width; s *= 2 )
+                {
+                    static const u32 punpckl[ 3 ][ 2 ] = { { X86Inst::kIdPunpcklbw, 0 },
+                        { X86Inst::kIdPunpcklwd, 0 },
+                        { X86Inst::kIdPunpckldq, 0 } };
+                    reg = packed( punpckl[ s == 1 ? 0 : s == 2 ? 1 : 2 ], reg, zeros );
+                }
+            }
+        }
 
-    const auto& type = value.type();
-    const auto res = &value;
-    const auto arg = value.operand( 0 ).get();
+        VERBOSE( "record( %u, %u ) ;; lanes %u", k, size, lanes );
+        loaded[ k ] = true;
+        records[ k ] = reg;
+        return reg;
+    };
 
-    alloc_reg_for_value( *res, c );
-    alloc_reg_for_value( *arg, c );
+    Label scalar = c.compiler().newLabel();
+    Label head = c.compiler().newLabel();
 
-    switch( type.id() )
+    // packed loads and stores need densely stored elements
+    for( u32 k = 0; k < operands.size(); k++ )
     {
-        case libcjel_ir::Type::BIT:
+        const u32 size = calc_byte_size( value.operand( operands[ k ] )->type() );
+        c.compiler().cmp( strides[ k ], imm( size ) );
+        c.compiler().jne( scalar );
+    }
+
+    c.compiler().cmp( count, imm( lanes ) );
+    c.compiler().jb( scalar );
+    c.compiler().bind( head );
+
+    // byte offsets of elements and result locations
+    std::unordered_map< Value*, std::pair< u32, u32 > > fields;
+    std::vector< std::pair< u32, Value* > > results;
+
+    callee.context()->iterate( Traversal::PREORDER, [&]( Value& node ) {
+        if( not isa< libcjel_ir::Instruction >( node ) )
         {
-            if( type.bitsize() < 1 )
+            return;
+        }
+
+        auto& instruction = static_cast< libcjel_ir::Instruction& >( node );
+        Value* res = &instruction;
+        Value* lhs = instruction.operand( 0 ).get();
+        Value* rhs = instruction.operands().size() > 1 ? instruction.operand( 1 ).get() : nullptr;
+        const u32 size = instruction.type().isBit() ? calc_byte_size( instruction.type() ) : 0;
+
+        if( isa< ExtractInstruction >( instruction ) )
+        {
+            const u64 index = static_cast< BitConstant& >( *rhs ).value().value();
+            fields[ res ] = { streams[ lhs ], element_offset( lhs->type(), index ) };
+        }
+        else if( isa< LoadInstruction >( instruction ) )
+        {
+            const auto field = fields[ lhs ];
+            X86Vec reg = record( field.first );
+
+            if( field.second > 0 )
             {
-                assert( not" bit type has invalid bit-size of '0' " );
+                reg = packed( psrl[ w ], reg, imm( field.second * 8 ) );
             }
-            else if( type.bitsize() <= 8 )
+            if( field.second + size < width )
             {
-                c.val2reg()[ res ] = c.val2reg()[ arg ].r8();
-                VERBOSE( "%s.r8()", arg->label().c_str() );
+                reg = packed( pand, reg, broadcast( ~(u64)0, size ) );
             }
-            else if( type.bitsize() <= 16 )
+
+            lane[ res ] = { reg, false };
+        }
+        else if( isa< StoreInstruction >( instruction ) )
+        {
+            const auto field = fields.find( rhs );
+            results.emplace_back( field == fields.end() ? 0 : field->second.second, lhs );
+        }
+        else if( isa< AndInstruction >( instruction ) or isa< OrInstruction >( instruction ) or
+                 isa< XorInstruction >( instruction ) )
+        {
+            const u32* id = isa< AndInstruction >( instruction )
+                                ? pand
+                                : isa< OrInstruction >( instruction ) ? por : pxor;
+
+            // bitwise operations on masks result in masks
+            const u1 masks = lane.count( lhs ) and lane[ lhs ].mask and lane.count( rhs ) and
+                             lane[ rhs ].mask;
+
+            lane[ res ] = masks ? Lane{ packed( id, lane[ lhs ].reg, lane[ rhs ].reg ), true }
+                                : Lane{ packed( id, get( lhs ), get( rhs ) ), false };
+        }
+        else if( isa< NotInstruction >( instruction ) )
+        {
+            if( lane.count( lhs ) and lane[ lhs ].mask )
             {
-                c.val2reg()[ res ] = c.val2reg()[ arg ].r16();
-                VERBOSE( "%s.r16()", arg->label().c_str() );
+                lane[ res ] = {
+                    packed( pxor, lane[ lhs ].reg, broadcast( ~(u64)0, width ) ), true
+                };
             }
-            else if( type.bitsize() <= 32 )
+            else
             {
-                c.val2reg()[ res ] = c.val2reg()[ arg ].r32();
-                VERBOSE( "%s.r32()", arg->label().c_str() );
+                lane[ res ] = { packed( pxor, get( lhs ), broadcast( ~(u64)0, size ) ), false };
             }
-            else if( type.bitsize() <= 64 )
+        }
+        else if( isa< AddUnsignedInstruction >( instruction ) )
+        {
+            X86Vec reg = packed( padd[ w ], get( lhs ), get( rhs ) );
+
+            if( size < width )
             {
-                c.val2reg()[ res ] = c.val2reg()[ arg ].r64();
-                VERBOSE( "%s.r64()", arg->label().c_str() );
+                // wrap around at the byte size of the result
+                reg = packed( pand, reg, broadcast( ~(u64)0, size ) );
             }
-            else
+
+            lane[ res ] = { reg, false };
+        }
+        else if( isa< EquInstruction >( instruction ) or isa< NeqInstruction >( instruction ) )
+        {
+            // operands are zero extended, so comparing whole lanes is exact
+            X86Vec reg = packed( pcmpeq[ w ], get( lhs ), get( rhs ) );
+
+            if( w == 3 and not avx )
             {
-                assert( not" a bit type of bit-size greater than 64-bit is unsupported for now! " );
+                // both halves of a quadword have to be equal
+                X86Vec swapped = vec( "swapped" );
+                c.compiler().emit( X86Inst::kIdPshufd, swapped, reg, imm( 0xb1 ) );
+                reg = packed( pand, reg, swapped );
             }
-            break;
+
+            if( isa< NeqInstruction >( instruction ) )
+            {
+                reg = packed( pxor, reg, broadcast( ~(u64)0, width ) );
+            }
+
+            lane[ res ] = { reg, true };
         }
-        default:
+        else if( isa< ZeroExtendInstruction >( instruction ) )
         {
-            fprintf(
-                stderr,
-                "unsupported type '%s' for 'trunc' instruction!\n",
-                type.description().c_str() );
-            assert( 0 );
-            break;
+            const u16 bitsize = lhs->type().bitsize();
+            X86Vec reg = get( lhs );
+
+            if( bitsize < calc_byte_size( lhs->type() ) * 8 )
+            {
+                reg = packed( pand, reg, broadcast( ( (u64)1 << bitsize ) - 1, width ) );
+            }
+
+            lane[ res ] = { reg, false };
+        }
+        else if( isa< TruncationInstruction >( instruction ) )
+        {
+            X86Vec reg = get( lhs );
+
+            if( size < width )
+            {
+                reg = packed( pand, reg, broadcast( ~(u64)0, size ) );
+            }
+
+            lane[ res ] = { reg, false };
+        }
+    } );
+
+    // the stored values are placed at their offsets in the result lanes
+    X86Vec out = vec( "out" );
+    c.compiler().emit( avx ? X86Inst::kIdVpxor : X86Inst::kIdPxor, out, out, out );
+
+    for( const auto& result : results )
+    {
+        X86Vec reg = get( result.second );
+
+        if( result.first > 0 )
+        {
+            reg = packed( psll[ w ], reg, imm( result.first * 8 ) );
         }
+
+        out = packed( por, out, reg );
     }
-}
-void CjelIRToAsmJitPass::visit_epilog( TruncationInstruction& value, libcjel_ir::Context& cxt )
-{
-}
 
-//
-// BitConstant
-//
+    // narrow the lanes to the result size, AVX2 packs within 128-bit halves
+    const u32 size = calc_byte_size( value.operand( operands[ 0 ] )->type() );
 
-void CjelIRToAsmJitPass::visit_prolog( BitConstant& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    Context& c = static_cast< Context& >( cxt );
+    for( u32 s = width; s > size; s /= 2 )
+    {
+        static const u32 pslld[ 2 ] = { X86Inst::kIdPslld, X86Inst::kIdVpslld };
+        static const u32 psrad[ 2 ] = { X86Inst::kIdPsrad, X86Inst::kIdVpsrad };
+        static const u32 packssdw[ 2 ] = { X86Inst::kIdPackssdw, X86Inst::kIdVpackssdw };
+        static const u32 packuswb[ 2 ] = { X86Inst::kIdPackuswb, X86Inst::kIdVpackuswb };
 
-    alloc_reg_for_value( value, c );
+        if( s == 8 )
+        {
+            X86Vec reg = vec( "narrow" );
+            c.compiler().emit(
+                avx ? X86Inst::kIdVpshufd : X86Inst::kIdPshufd, reg, out, imm( 0x88 ) );
+            out = reg;
+        }
+        else if( s == 4 )
+        {
+            // sign extended words are packed without saturation
+            out = packed( pslld, out, imm( 16 ) );
+            out = packed( psrad, out, imm( 16 ) );
+            out = packed( packssdw, out, out );
+        }
+        else
+        {
+            out = packed( packuswb, out, out );
+        }
 
-    c.compiler().mov(
-        c.val2reg()[&value ],
-        asmjit::imm( value.value().value() ) );  // FIXME: PPA: value access limited
-                                                 // to 1 word!!!
-    VERBOSE( "mov %s, imm( %s )", value.label().c_str(), value.name().c_str() );
+        if( avx )
+        {
+            X86Vec reg = vec( "narrow" );
+            c.compiler().emit( X86Inst::kIdVpermq, reg, out, imm( 0x08 ) );
+            out = reg;
+        }
+    }
+
+    const u32 total = lanes * size;
+    X86Mem dst = x86::ptr( cursors[ 0 ], 0 );
+
+    if( total == 32 )
+    {
+        c.compiler().emit( X86Inst::kIdVmovdqu, dst, out );
+    }
+    else if( total == 16 )
+    {
+        c.compiler().emit( avx ? X86Inst::kIdVmovdqu : X86Inst::kIdMovdqu, dst, out.xmm() );
+    }
+    else if( total >= 4 )
+    {
+        dst.setSize( total );
+        c.compiler().emit( total == 8 ? ( avx ? X86Inst::kIdVmovq : X86Inst::kIdMovq )
+                                      : ( avx ? X86Inst::kIdVmovd : X86Inst::kIdMovd ),
+            dst,
+            out.xmm() );
+    }
+    else
+    {
+        X86Gp word = c.compiler().newU32( "word" );
+        c.compiler().emit( X86Inst::kIdMovd, word, out.xmm() );
+        c.compiler().mov( x86::word_ptr( cursors[ 0 ], 0 ), word.r16() );
+    }
+
+    for( u32 k = 0; k < operands.size(); k++ )
+    {
+        const u32 size = calc_byte_size( value.operand( operands[ k ] )->type() );
+        c.compiler().add( cursors[ k ], imm( lanes * size ) );
+    }
+
+    c.compiler().sub( count, imm( lanes ) );
+    c.compiler().cmp( count, imm( lanes ) );
+    c.compiler().jae( head );
+    VERBOSE( "jae head ;; %u lanes of %u bytes", lanes, width );
+
+    if( avx )
+    {
+        // the scalar loop and the caller use legacy SSE encodings
+        c.compiler().vzeroupper();
+    }
+
+    c.compiler().bind( scalar );
 }
-void CjelIRToAsmJitPass::visit_epilog( BitConstant& value, libcjel_ir::Context& cxt )
+
+void* CjelIRToAsmJitPass::compile( libcjel_ir::CallInstruction& value, Context& c )
 {
-}
+    auto callees = open_module( value, c );
 
-//
-// StructureConstant
-//
+    // create CallInstruction asm jit, first in the code holder to be its entry
+    Context::Callable& func = c.callable( &value );
+    func.argsize( -1 );
 
-void CjelIRToAsmJitPass::visit_prolog( StructureConstant& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    Context& c = static_cast< Context& >( cxt );
+    const u1 returned = returned_in_register( value.type() );
+
+    FuncSignatureX& fsig = func.funcsig();
+    fsig.init(
+        CallConv::kIdHost, returned ? TypeId::kU64 : TypeId::kVoid, fsig._builderArgList, 0 );
+    if( not returned )
+    {
+        fsig.addArg( TypeId::kUIntPtr );
+    }
+    for( u32 i = 1; i < value.operands().size(); i++ )
+    {
+        if( libcjel_ir::isa< libcjel_ir::Constant >( value.operand( i ) ) )
+        {
+            fsig.addArg( passed_in_register( value.operand( i )->type() ) ? TypeId::kU64
+                                                                            : TypeId::kUIntPtr );
+        }
+    }
+
+    if( fsig.getArgCount() > ENTRY_ARGUMENTS )
+    {
+        fprintf(
+            stderr,
+            "unsupported call '%s' with %u entry arguments!\n",
+            value.name().c_str(),
+            fsig.getArgCount() );
+        assert( 0 );
+    }
 
-    alloc_reg_for_value( value, c );
+    c.compiler().addFunc( func.funcsig() );
+    VERBOSE( "addFunc( %s )", value.name().c_str() );
+
+    X86Gp out;
+    if( not returned )
+    {
+        out = c.compiler().newUIntPtr( "out" );
+        c.compiler().setArg( 0, out );
+        VERBOSE( "setArg( %u, %s )", 0, "out" );
+    }
 
-    u64 byte_size = value.type().wordsize();
-    u64 byte_offset = 0;
+    u32 argument = returned ? 0 : 1;
+    for( u32 i = 1; i < value.operands().size(); i++ )
+    {
+        if( libcjel_ir::isa< libcjel_ir::Constant >( value.operand( i ) ) )
+        {
+            alloc_reg_for_input( *value.operand( i ), argument, c );
+            argument++;
+        }
+        else if( scalarizable( value, i, c ) )
+        {
+            scalarize( value, i, c );
+        }
+    }
 
-    c.compiler().lea( c.val2reg()[&value ], c.compiler().newStack( byte_size, 4 ) );
-    VERBOSE( "lea %s, newStack( %lu, 4 )", value.label().c_str(), byte_size );
+    value.iterate( libcjel_ir::Traversal::PREORDER, this, &c );
 
-    for( std::size_t i = 0; i < value.value().size(); i++ )
+    for( auto v : value.operands() )
     {
-        alloc_reg_for_value( value.value()[ i ], c );
+        if( auto res = cast< libcjel_ir::AllocInstruction >( v ) )
+        {
+            const auto& type = res->type();
+            const u32 size = calc_byte_size( type );
+            auto scalar = c.scalars().find( res );
 
-        c.compiler().mov(
-            x86::ptr( c.val2reg()[&value ], byte_offset ), c.val2reg()[&value.value()[ i ] ] );
-        VERBOSE(
-            "mov ptr( %s, %lu ), %s",
-            value.label().c_str(),
-            byte_offset,
-            value.value()[ i ].label().c_str() );
+            if( returned and scalar != c.scalars().end() )
+            {
+                // the elements are assembled in the return register
+                X86Gp word = c.compiler().newU64( "result" );
+                c.compiler().xor_( word, word );
 
-        byte_offset += value.value()[ i ].type().wordsize();
-    }
-}
-void CjelIRToAsmJitPass::visit_epilog( StructureConstant& value, libcjel_ir::Context& cxt )
-{
-}
+                for( u32 i = 0; i < scalar->second.size(); i++ )
+                {
+                    const auto& element = type.isBit() ? type : *type.results()[ i ];
+                    const u32 offset = type.isBit() ? 0 : element_offset( type, i );
 
-//
-// StringConstant
-//
+                    X86Gp part =
+                        zero_extend_word( scalar->second[ i ], element.bitsize(), c.compiler() );
+                    if( offset > 0 )
+                    {
+                        c.compiler().shl( part, imm( offset * 8 ) );
+                    }
+                    c.compiler().or_( word, part );
+                }
 
-void CjelIRToAsmJitPass::visit_prolog( StringConstant& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    FIXME();
-}
-void CjelIRToAsmJitPass::visit_epilog( StringConstant& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-}
+                c.compiler().ret( word );
+                VERBOSE( "ret scalar( %s )", res->label().c_str() );
+            }
+            else if( returned )
+            {
+                X86Gp word = c.compiler().newU64( "result" );
+                X86Mem memory = x86::ptr( c.val2reg()[ (libcjel_ir::Value*)res ], 0 );
+                memory.setSize( size );
 
-//
-// Interconnect
-//
+                if( size < 4 )
+                {
+                    c.compiler().movzx( word, memory );
+                }
+                else
+                {
+                    // writing the lower half clears the upper one
+                    c.compiler().mov( sub_reg( word, size ), memory );
+                }
 
-void CjelIRToAsmJitPass::visit_prolog( Interconnect& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-    FIXME();
-}
-void CjelIRToAsmJitPass::visit_epilog( Interconnect& value, libcjel_ir::Context& cxt )
-{
-    TRACE( "" );
-}
+                c.compiler().ret( word );
+                VERBOSE( "ret ptr( %s )", res->label().c_str() );
+            }
+            else if( scalar != c.scalars().end() )
+            {
+                store_scalars( *res, out, c );
+            }
+            else if( type.isBit() or type.isStructure() )
+            {
+                copy( out, c.val2reg()[ (libcjel_ir::Value*)res ], size, c );
+                VERBOSE( "copy( out, %s, %u )", res->label().c_str(), size );
+            }
+            else
+            {
+                assert( !"UNIMPLEMENTED!" );
+            }
+        }
+    }
 
-//
-// JiT
-//
+    c.compiler().endFunc();
 
-libcjel_ir::Constant CjelIRToAsmJitPass::execute(
-    libcjel_ir::OperatorInstruction& value, Context& c )
-{
-    libcjel_ir::CjelIRDumpPass dump;
+    return close_module( value, callees, c );
+}
 
-    c.reset();
+void* CjelIRToAsmJitPass::compile_batch( libcjel_ir::CallInstruction& value, Context& c )
+{
+    auto callees = open_module( value, c );
 
     Context::Callable& func = c.callable( &value );
     func.argsize( -1 );
 
     FuncSignatureX& fsig = func.funcsig();
     fsig.init( CallConv::kIdHost, TypeId::kVoid, fsig._builderArgList, 0 );
+    fsig.addArg( TypeId::kU64 );
     fsig.addArg( TypeId::kUIntPtr );
 
+    // the output stream comes first, followed by the streams of all inputs
+    std::vector< u32 > operands;
+    u32 outputs = 0;
+    for( u32 i = 1; i < value.operands().size(); i++ )
+    {
+        if( libcjel_ir::isa< libcjel_ir::AllocInstruction >( value.operand( i ) ) )
+        {
+            operands.insert( operands.begin(), i );
+            outputs++;
+        }
+        else
+        {
+            operands.emplace_back( i );
+        }
+    }
+
+    if( outputs != 1 )
+    {
+        fprintf(
+            stderr,
+            "unsupported batch call '%s' with %u outputs!\n",
+            value.name().c_str(),
+            outputs );
+        assert( 0 );
+    }
+
     c.compiler().addFunc( func.funcsig() );
-    VERBOSE( "addFunc( %s )", value.name().c_str() );
+    VERBOSE( "addFunc( %s ) ;; batch", value.name().c_str() );
 
-    X86Gp out = c.compiler().newUIntPtr( "out" );
-    c.compiler().setArg( 0, out );
-    VERBOSE( "setArg( %u, %s )", 0, "out" );
+    X86Gp count = c.compiler().newU64( "count" );
+    X86Gp streams = c.compiler().newUIntPtr( "streams" );
+    c.compiler().setArg( 0, count );
+    c.compiler().setArg( 1, streams );
 
-    assert( value.operands().size() <= 2 );
-    assert( libcjel_ir::isa< libcjel_ir::Constant >( value.operand( 0 ) ) );
-    if( value.operands().size() > 1 )
+    std::vector< X86Gp > cursors;
+    std::vector< X86Gp > strides;
+    for( u32 k = 0; k < operands.size(); k++ )
+    {
+        cursors.emplace_back( c.compiler().newUIntPtr( "cursor" ) );
+        strides.emplace_back( c.compiler().newU64( "stride" ) );
+
+        c.compiler().mov( cursors[ k ], x86::qword_ptr( streams, k * STREAM_SIZE ) );
+        c.compiler().mov( strides[ k ], x86::qword_ptr( streams, k * STREAM_SIZE + 8 ) );
+    }
+
+    const u32 width = vectorizable( value, c );
+    if( width > 0 )
     {
-        assert( libcjel_ir::isa< libcjel_ir::Constant >( value.operand( 1 ) ) );
+        vectorize( value, operands, cursors, strides, count, width, c );
     }
 
-    value.iterate( libcjel_ir::Traversal::PREORDER, this, &c );
-    value.iterate( libcjel_ir::Traversal::PREORDER, &dump );
+    Label head = c.compiler().newLabel();
+    Label done = c.compiler().newLabel();
 
-    u32 byte_size = calc_byte_size( value.type() );
+    c.compiler().test( count, count );
+    c.compiler().jz( done );
+    c.compiler().bind( head );
 
-    X86Gp tmp = c.compiler().newU8( "tmp" );
-    for( u32 i = 0; i < byte_size; i++ )
+    for( u32 k = 0; k < operands.size(); k++ )
     {
-        c.compiler().mov( tmp, c.val2reg()[&value ] );
-        c.compiler().mov( x86::ptr( out, i ), tmp );
+        Value& operand = *value.operand( operands[ k ] );
+        const auto& type = operand.type();
+
+        if( k > 0 and passed_in_register( type ) )
+        {
+            X86Mem element = x86::ptr( cursors[ k ], 0 );
+            element.setSize( calc_byte_size( type ) );
+
+            c.val2reg()[&operand ] =
+                new_reg_for_bit_type( type, operand.label().c_str(), c.compiler() );
+            c.compiler().mov( c.val2reg()[&operand ], element );
+            VERBOSE( "mov %s, ptr( cursor ) ;; batch input", operand.label().c_str() );
+        }
+        else if( k > 0 )
+        {
+            // structure and wide inputs are used in place
+            c.val2reg()[&operand ] = cursors[ k ];
+        }
+        else if( scalarizable( value, operands[ k ], c ) )
+        {
+            scalarize( value, operands[ k ], c );
+        }
+        else
+        {
+            // the result is computed in place in the output element
+            c.val2reg()[&operand ] = cursors[ k ];
+            zero( cursors[ k ], calc_byte_size( type ), c );
+            VERBOSE( "zero( cursor, %u ) ;; batch output", calc_byte_size( type ) );
+        }
     }
 
-    c.compiler().endFunc();
-    c.compiler().finalize();
+    value.iterate( libcjel_ir::Traversal::PREORDER, this, &c );
 
-    void** func_ptr;
-    Error err = c.runtime().add( &func_ptr, &c.codeholder() );
-    if( err )
+    if( c.scalars().count( value.operand( operands[ 0 ] ).get() ) )
     {
-        fprintf( stderr, "asmjit: %s", DebugUtils::errorAsString( err ) );
-        assert( 0 );
+        store_scalars( *value.operand( operands[ 0 ] ), cursors[ 0 ], c );
     }
 
-    func.funcptr( func_ptr );
+    for( u32 k = 0; k < operands.size(); k++ )
+    {
+        c.compiler().add( cursors[ k ], strides[ k ] );
+    }
 
-    fprintf(
-        stderr,
-        "asmjit: %s @ %p\n"
-        "~~~{.asm}\n"
-        "%s"
-        "~~~\n",
-        value.name().c_str(),
-        func_ptr,
-        c.logger().getString() );
+    c.compiler().dec( count );
+    c.compiler().jnz( head );
+    c.compiler().bind( done );
+    VERBOSE( "jnz head ;; batch" );
+
+    c.compiler().endFunc();
 
-    u8 b[ 10 ];
-    for( u32 i = 0; i < 10; i++ )
-    {
-        b[ i ] = 0xff;
-    }
-
-    printf(
-        "b: %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x\n",
-        b[ 0 ],
-        b[ 1 ],
-        b[ 2 ],
-        b[ 3 ],
-        b[ 4 ],
-        b[ 5 ],
-        b[ 6 ],
-        b[ 7 ],
-        b[ 8 ],
-        b[ 9 ] );
-
-    printf( "calling: %p\n", c.callable( &value ).funcptr() );
-    typedef void ( *CallableType )( void* );
-    ( (CallableType)c.callable( &value ).funcptr() )( &b );
-
-    printf(
-        "b: %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x\n",
-        b[ 0 ],
-        b[ 1 ],
-        b[ 2 ],
-        b[ 3 ],
-        b[ 4 ],
-        b[ 5 ],
-        b[ 6 ],
-        b[ 7 ],
-        b[ 8 ],
-        b[ 9 ] );
-
-    assert( value.type().isBit() );
-    assert( value.type().bitsize() <= 8 );
-
-    return libcjel_ir::BitConstant(
-        std::static_pointer_cast< libcjel_ir::BitType >( value.ptr_type() ), b[ 0 ] );
+    return close_module( value, callees, c );
 }
 
-libcjel_ir::Constant CjelIRToAsmJitPass::execute( libcjel_ir::CallInstruction& value, Context& c )
+void* CjelIRToAsmJitPass::compile( libcjel_ir::Module& value, Context& c )
 {
-    libcjel_ir::CjelIRDumpPass dump;
-
-    // create Builtin/Rule asm jit
-    c.reset();
+    visit_prolog( value, c );
 
-    value.callee()->iterate( libcjel_ir::Traversal::PREORDER, &dump );
-    value.callee()->iterate( libcjel_ir::Traversal::PREORDER, this, &c );
+    for( const auto& function : value.get< Function >() )
+    {
+        function->iterate( libcjel_ir::Traversal::PREORDER, this, &c );
+    }
 
-    // create CallInstruction asm jit
-    c.reset();
+    for( const auto& intrinsic : value.get< Intrinsic >() )
+    {
+        intrinsic->iterate( libcjel_ir::Traversal::PREORDER, this, &c );
+    }
 
-    value.iterate( libcjel_ir::Traversal::PREORDER, &dump );
+    visit_epilog( value, c );
 
-    Context::Callable& func = c.callable( &value );
-    func.argsize( -1 );
+    return c.symbols().empty() ? nullptr : c.functions().back();
+}
 
-    FuncSignatureX& fsig = func.funcsig();
-    fsig.init( CallConv::kIdHost, TypeId::kVoid, fsig._builderArgList, 0 );
-    fsig.addArg( TypeId::kUIntPtr );
+libcjel_ir::Constant CjelIRToAsmJitPass::invoke( void* entry, libcjel_ir::Instruction& value )
+{
+    const u1 returned = returned_in_register( value.type() );
 
-    c.compiler().addFunc( func.funcsig() );
-    VERBOSE( "addFunc( %s )", value.name().c_str() );
+    std::vector< u8 > out( std::max< u32 >( calc_byte_size( value.type() ), sizeof( u64 ) ) );
 
-    // PPA: check if output type matches !!!, maybe we need more
-    // registers/pointers here!!! as args I mean
-    X86Gp out = c.compiler().newUIntPtr( "out" );
-    c.compiler().setArg( 0, out );
-    VERBOSE( "setArg( %u, %s )", 0, "out" );
+    // inputs passed by pointer are encoded into buffers of their own
+    std::vector< std::vector< u8 > > encodings;
+    u64 words[ ENTRY_ARGUMENTS ] = {};
+    u32 argument = 0;
 
-    value.iterate( libcjel_ir::Traversal::PREORDER, this, &c );
+    if( not returned )
+    {
+        words[ argument++ ] = reinterpret_cast< u64 >( out.data() );
+    }
 
-    X86Gp tmp = c.compiler().newU8( "tmp" );
-    for( auto v : value.operands() )
+    for( const auto& operand : value.operands() )
     {
-        if( auto res = cast< libcjel_ir::AllocInstruction >( v ) )
+        if( not libcjel_ir::isa< libcjel_ir::Constant >( operand ) )
         {
-            if( res->type().isBit() )
-            {
-                u32 top = calc_byte_size( res->type() );
-                for( u32 idx = 0; idx < top; idx++ )
-                {
-                    c.compiler().mov(
-                        tmp, x86::ptr( c.val2reg()[ (libcjel_ir::Value*)res ], idx ) );
-                    c.compiler().mov( x86::ptr( out, idx ), tmp );
+            continue;
+        }
 
-                    VERBOSE(
-                        "mov( ptr( out, %u ), ptr( %s, %u ) )", idx, res->label().c_str(), idx );
-                }
-            }
-            else if( res->type().isStructure() )
-            {
-                u32 offset = 0;
+        assert( argument < ENTRY_ARGUMENTS );
 
-                for( auto element : res->type().results() )
-                {
-                    assert( element->isBit() );
+        if( passed_in_register( operand->type() ) )
+        {
+            u8 bytes[ sizeof( u64 ) ] = {};
+            encode( *operand, bytes );
+            memcpy( &words[ argument++ ], bytes, sizeof( u64 ) );
+        }
+        else
+        {
+            encodings.emplace_back( calc_byte_size( operand->type() ) );
+            encode( *operand, encodings.back().data() );
+            words[ argument++ ] = reinterpret_cast< u64 >( encodings.back().data() );
+        }
+    }
 
-                    u32 top = calc_byte_size( *element );
-                    u32 idx = 0;
-                    for( u32 i = 0; i < top; i++ )
-                    {
-                        idx = i + offset;
+    // unused trailing arguments are ignored by the entry point
+    typedef u64 ( *EntryType )( u64, u64, u64, u64, u64, u64, u64, u64 );
+    const u64 result = ( (EntryType)entry )(
+        words[ 0 ], words[ 1 ], words[ 2 ], words[ 3 ], words[ 4 ], words[ 5 ], words[ 6 ],
+        words[ 7 ] );
 
-                        c.compiler().mov(
-                            tmp, x86::ptr( c.val2reg()[ (libcjel_ir::Value*)res ], idx ) );
-                        c.compiler().mov( x86::ptr( out, idx ), tmp );
+    if( returned )
+    {
+        // host is little-endian, the lower bytes hold the result
+        memcpy( out.data(), &result, sizeof( result ) );
+    }
 
-                        VERBOSE(
-                            "mov( ptr( out, %u ), ptr( %s, %u ) )",
-                            idx,
-                            res->label().c_str(),
-                            idx );
-                    }
+    return decode( value.ptr_type(), out.data() );
+}
 
-                    offset += top;
-                }
-            }
-            else
-            {
-                assert( !"UNIMPLEMENTED!" );
-            }
-        }
-    }
+libcjel_ir::Constant CjelIRToAsmJitPass::execute(
+    libcjel_ir::OperatorInstruction& value, Context& c )
+{
+    void* entry = compile( value, c );
+    const auto result = invoke( entry, value );
 
-    c.compiler().endFunc();
-    c.compiler().finalize();
+    for( auto function : c.functions() )
+    {
+        c.runtime().release( function );
+    }
+    c.functions().clear();
 
-    void** func_ptr;
-    Error err = c.runtime().add( &func_ptr, &c.codeholder() );
+    return result;
+}
 
-    fprintf(
-        stderr,
-        "asmjit: %s @ %p, calling %p\n"
-        "~~~{.asm}\n"
-        "%s"
-        "~~~\n",
-        value.name().c_str(),
-        func_ptr,
-        c.callable( value.callee().get() ).funcptr(),
-        c.logger().getString() );
+libcjel_ir::Constant CjelIRToAsmJitPass::execute( libcjel_ir::CallInstruction& value, Context& c )
+{
+    void* entry = compile( value, c );
+    const auto result = invoke( entry, value );
 
-    if( err )
+    for( auto function : c.functions() )
     {
-        fprintf( stderr, "asmjit: %s\n", DebugUtils::errorAsString( err ) );
-        assert( 0 );
+        c.runtime().release( function );
     }
+    c.functions().clear();
+
+    return result;
+}
+
+u32 CjelIRToAsmJitPass::byte_size( const libcjel_ir::Type& type )
+{
+    return calc_byte_size( type );
+}
 
-    func.funcptr( func_ptr );
+u32 CjelIRToAsmJitPass::byte_offset( const libcjel_ir::Type& type, u64 index )
+{
+    return element_offset( type, index );
+}
 
-    u8 b[ 10 ];
-    for( u32 i = 0; i < 10; i++ )
+u1 CjelIRToAsmJitPass::returned_in_register( const libcjel_ir::Type& type )
+{
+    if( not type.isBit() and not type.isStructure() )
     {
-        b[ i ] = 0xff;
+        return false;
     }
 
-    fprintf(
-        stderr,
-        "b: %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x\n",
-        b[ 0 ],
-        b[ 1 ],
-        b[ 2 ],
-        b[ 3 ],
-        b[ 4 ],
-        b[ 5 ],
-        b[ 6 ],
-        b[ 7 ],
-        b[ 8 ],
-        b[ 9 ] );
-
-    fprintf( stderr, "calling: %p\n", c.callable( &value ).funcptr() );
-    typedef void ( *CallableType )( void* );
-    ( (CallableType)c.callable( &value ).funcptr() )( b );
+    const u32 size = calc_byte_size( type );
+    return size == 1 or size == 2 or size == 4 or size == 8;
+}
 
-    fprintf(
-        stderr,
-        "b: %02x %02x %02x %02x %02x %02x %02x %02x %02x %02x\n",
-        b[ 0 ],
-        b[ 1 ],
-        b[ 2 ],
-        b[ 3 ],
-        b[ 4 ],
-        b[ 5 ],
-        b[ 6 ],
-        b[ 7 ],
-        b[ 8 ],
-        b[ 9 ] );
-
-    const auto type = value.ptr_type();
+u1 CjelIRToAsmJitPass::passed_in_register( const libcjel_ir::Type& type )
+{
+    return type.isBit() and not is_wide( type );
+}
 
-    switch( type->id() )
+void CjelIRToAsmJitPass::encode( libcjel_ir::Value& value, u8* buffer )
+{
+    switch( value.id() )
     {
-        case libcjel_ir::Type::BIT:
+        case Value::BIT_CONSTANT:
         {
-            const auto ctype = std::static_pointer_cast< libcjel_ir::BitType >( type );
+            const u64 word = static_cast< BitConstant& >( value ).value().value();
+            const u32 byte_size = calc_byte_size( value.type() );
 
-            if( type->bitsize() < 1 )
-            {
-                assert( not" bit type has invalid bit-size of '0' " );
-            }
-            else if( type->bitsize() <= 8 )
-            {
-                return libcjel_ir::BitConstant( ctype, b[ 0 ] );
-            }
-            else if( type->bitsize() <= 16 )
+            // host is little-endian, the lower bytes hold the value and the
+            // upper limbs of wide constants are zero
+            memcpy( buffer, &word, std::min< u32 >( byte_size, sizeof( word ) ) );
+            if( byte_size > sizeof( word ) )
             {
-                return libcjel_ir::BitConstant( ctype, ( u16 )( *&b[ 0 ] ) );
+                memset( buffer + sizeof( word ), 0, byte_size - sizeof( word ) );
             }
-            else if( type->bitsize() <= 32 )
+            break;
+        }
+        case Value::STRUCTURE_CONSTANT:
+        {
+            const auto& elements = static_cast< StructureConstant& >( value ).value();
+            for( u32 i = 0; i < elements.size(); i++ )
             {
-                return libcjel_ir::BitConstant( ctype, ( u32 )( *&b[ 0 ] ) );
+                encode( elements[ i ], buffer + element_offset( value.type(), i ) );
             }
-            else if( type->bitsize() <= 64 )
+            break;
+        }
+        default:
+        {
+            fprintf(
+                stderr,
+                "unsupported constant value of type '%s' to encode!\n",
+                value.type().description().c_str() );
+            assert( 0 );
+            break;
+        }
+    }
+}
+
+libcjel_ir::Constant CjelIRToAsmJitPass::decode(
+    const libcjel_ir::Type::Ptr& type, const u8* buffer )
+{
+    switch( type->id() )
+    {
+        case libcjel_ir::Type::BIT:
+        {
+            const u32 byte_size = calc_byte_size( *type );
+
+            u64 word = 0;
+            memcpy( &word, buffer, std::min< u32 >( byte_size, sizeof( word ) ) );
+
+            if( type->bitsize() < 64 )
             {
-                return libcjel_ir::BitConstant( ctype, ( u64 )( *&b[ 0 ] ) );
+                word &= ( (u64)1 << type->bitsize() ) - 1;
             }
-            else
+
+            for( u32 limb = 1; limb < byte_size / sizeof( word ); limb++ )
             {
-                assert( not" a bit type of bit-size greater than 64-bit is unsupported for now! " );
+                u64 upper = 0;
+                memcpy( &upper, buffer + limb * sizeof( word ), sizeof( upper ) );
+
+                if( limb == byte_size / sizeof( word ) - 1 and type->bitsize() % 64 != 0 )
+                {
+                    upper &= ( (u64)1 << ( type->bitsize() % 64 ) ) - 1;
+                }
+
+                if( upper != 0 )
+                {
+                    fprintf(
+                        stderr,
+                        "unsupported wide result of type '%s' beyond one word to decode\n",
+                        type->description().c_str() );
+                    assert( 0 );
+                }
             }
-            break;
+
+            return libcjel_ir::BitConstant(
+                std::static_pointer_cast< libcjel_ir::BitType >( type ), word );
         }
         case libcjel_ir::Type::STRUCTURE:
         {
-            assert(
-                value.type().results().size() == 2 and value.type().results()[ 0 ]->isBit() and
-                value.type().results()[ 0 ]->bitsize() <= 8 and
-                *value.type().results()[ 0 ] == *value.type().results()[ 1 ] );
+            std::vector< libcjel_ir::Constant > elements;
 
-            const auto ctv =
-                std::static_pointer_cast< libcjel_ir::StructureType >( value.ptr_type() );
-
-            const auto ct0 =
-                std::static_pointer_cast< libcjel_ir::BitType >( value.type().ptr_results()[ 0 ] );
-
-            const auto ct1 =
-                std::static_pointer_cast< libcjel_ir::BitType >( value.type().ptr_results()[ 1 ] );
+            const auto& results = type->ptr_results();
+            for( u32 i = 0; i < results.size(); i++ )
+            {
+                const u32 offset = element_offset( *type, i );
+                elements.emplace_back( decode( results[ i ], buffer + offset ) );
+            }
 
             return libcjel_ir::StructureConstant(
-                ctv, { BitConstant( ct0, b[ 0 ] ), BitConstant( ct1, b[ 1 ] ) } );
+                std::static_pointer_cast< libcjel_ir::StructureType >( type ), elements );
         }
         default:
         {
-            fprintf( stderr, "unsupported value '%s' to return\n", value.description().c_str() );
+            fprintf( stderr, "unsupported type '%s' to decode\n", type->description().c_str() );
 
             assert( 0 );
             return libcjel_ir::VoidConstant();
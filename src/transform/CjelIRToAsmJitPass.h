@@ -46,16 +46,28 @@
 #include <libpass/PassData>
 #include <libpass/PassResult>
 
+#include <libcjel-rt/Runtime>
+
 #include <libcjel-ir/Visitor>
 
 #include <asmjit/asmjit.h>
 
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace libcjel_ir
 {
     class Value;
+    class Type;
     class Constant;
+    class Module;
+    class CallableUnit;
+    class Instruction;
     class CallInstruction;
     class OperatorInstruction;
+    class LoopStatement;
+    class BranchStatement;
 }
 
 namespace libcjel_rt
@@ -67,6 +79,11 @@ namespace libcjel_rt
       public:
         static char id;
 
+        /**
+           compiles the module of the 'Data' result of this pass, which has
+           to be provided by the driver, and publishes the symbol table of
+           its callables through the same result
+        */
         bool run( libpass::PassResult& pr ) override;
 
         LIBCJEL_IR_VISITOR_INTERFACE;
@@ -80,12 +97,14 @@ namespace libcjel_rt
                 asmjit::FuncSignatureX m_func_sig;
                 void** m_func_ptr;
                 u32 m_arg_size;
+                asmjit::CCFunc* m_func;
 
               public:
                 Callable()
                 : m_func_sig()
                 , m_func_ptr( nullptr )
-                , m_arg_size( 0 ){};
+                , m_arg_size( 0 )
+                , m_func( nullptr ){};
 
                 asmjit::FuncSignatureX& funcsig( void )
                 {
@@ -113,10 +132,286 @@ namespace libcjel_rt
                     }
                     return m_arg_size;
                 }
+
+                /**
+                   function node of a callable declared in the current code
+                   holder, calls to it are resolved through its label
+                */
+                asmjit::CCFunc* func( void ) const
+                {
+                    return m_func;
+                }
+
+                void setFunc( asmjit::CCFunc* func )
+                {
+                    m_func = func;
+                }
+            };
+
+            /**
+               dense numbering of all values seen by a context, the numbers
+               are assigned in first-seen order and are looked up through an
+               open addressed table of value pointers
+            */
+            class Numbering
+            {
+              public:
+                static constexpr u32 NONE = static_cast< u32 >( -1 );
+
+                Numbering()
+                : m_keys( 64, nullptr )
+                , m_numbers( 64, NONE )
+                , m_size( 0 ){};
+
+                u32 size( void ) const
+                {
+                    return m_size;
+                }
+
+                /**
+                   number of 'value' or 'NONE' if it was not numbered yet
+                */
+                u32 find( const libcjel_ir::Value* value ) const
+                {
+                    const std::size_t mask = m_keys.size() - 1;
+
+                    for( std::size_t i = slot( value );; i = ( i + 1 ) & mask )
+                    {
+                        if( m_keys[ i ] == value )
+                        {
+                            return m_numbers[ i ];
+                        }
+                        if( not m_keys[ i ] )
+                        {
+                            return NONE;
+                        }
+                    }
+                }
+
+                u32 number( const libcjel_ir::Value* value )
+                {
+                    const std::size_t mask = m_keys.size() - 1;
+
+                    std::size_t i = slot( value );
+                    for( ; m_keys[ i ]; i = ( i + 1 ) & mask )
+                    {
+                        if( m_keys[ i ] == value )
+                        {
+                            return m_numbers[ i ];
+                        }
+                    }
+
+                    if( ( m_size + 1 ) * 4 > m_keys.size() * 3 )
+                    {
+                        grow();
+                        return number( value );
+                    }
+
+                    m_keys[ i ] = value;
+                    m_numbers[ i ] = m_size;
+                    return m_size++;
+                }
+
+              private:
+                std::size_t slot( const libcjel_ir::Value* value ) const
+                {
+                    const u64 hash = reinterpret_cast< std::uintptr_t >( value ) *
+                                     static_cast< u64 >( 0x9e3779b97f4a7c15 );
+                    return ( hash ^ ( hash >> 32 ) ) & ( m_keys.size() - 1 );
+                }
+
+                void grow( void )
+                {
+                    std::vector< const libcjel_ir::Value* > keys( m_keys.size() * 2, nullptr );
+                    std::vector< u32 > numbers( m_keys.size() * 2, NONE );
+
+                    std::swap( keys, m_keys );
+                    std::swap( numbers, m_numbers );
+
+                    const std::size_t mask = m_keys.size() - 1;
+
+                    for( std::size_t k = 0; k < keys.size(); k++ )
+                    {
+                        if( keys[ k ] )
+                        {
+                            std::size_t i = slot( keys[ k ] );
+                            while( m_keys[ i ] )
+                            {
+                                i = ( i + 1 ) & mask;
+                            }
+
+                            m_keys[ i ] = keys[ k ];
+                            m_numbers[ i ] = numbers[ k ];
+                        }
+                    }
+                }
+
+              private:
+                std::vector< const libcjel_ir::Value* > m_keys;
+                std::vector< u32 > m_numbers;
+                u32 m_size;
+            };
+
+            /**
+               flat table of per value entries indexed by the value number,
+               entries of an older generation count as absent, so clearing
+               the table is a constant time operation, references to entries
+               stay valid while the table grows
+            */
+            template < typename T >
+            class ValueTable
+            {
+              public:
+                ValueTable( Numbering& numbering )
+                : m_numbering( numbering )
+                , m_entries()
+                , m_stamps()
+                , m_generation( 1 ){};
+
+                u1 has( const libcjel_ir::Value* value ) const
+                {
+                    const u32 number = m_numbering.find( value );
+                    return number < m_stamps.size() and m_stamps[ number ] == m_generation;
+                }
+
+                T& operator[]( const libcjel_ir::Value* value )
+                {
+                    const u32 number = m_numbering.number( value );
+
+                    if( number >= m_entries.size() )
+                    {
+                        reserve( number + 1 );
+                    }
+
+                    if( m_stamps[ number ] != m_generation )
+                    {
+                        m_entries[ number ] = T();
+                        m_stamps[ number ] = m_generation;
+                    }
+
+                    return m_entries[ number ];
+                }
+
+                void erase( const libcjel_ir::Value* value )
+                {
+                    const u32 number = m_numbering.find( value );
+                    if( number < m_stamps.size() )
+                    {
+                        m_stamps[ number ] = 0;
+                    }
+                }
+
+                void reserve( std::size_t size )
+                {
+                    if( size > m_entries.size() )
+                    {
+                        m_entries.resize( size );
+                        m_stamps.resize( size, 0 );
+                    }
+                }
+
+                void clear( void )
+                {
+                    m_generation++;
+                }
+
+                std::deque< T >& entries( void )
+                {
+                    return m_entries;
+                }
+
+              private:
+                Numbering& m_numbering;
+                std::deque< T > m_entries;
+                std::deque< u32 > m_stamps;
+                u32 m_generation;
+            };
+
+            /**
+               statement of a parallel scope which is compiled as a function
+               of its own and forked as a job to the thread pool, all values
+               it uses but does not define are passed through a frame
+            */
+            struct Task
+            {
+                libcjel_ir::Value* statement;
+                asmjit::CCFunc* func;
+                std::vector< libcjel_ir::Value* > captures;
+                u1 updates;
+                u1 layered;
+            };
+
+            /**
+               scope which is currently compiled, the statement code emitted
+               after 'cursor' is forked and dropped from the current function,
+               if 'deferred' is set all stores are inserted into the update
+               set held by 'updates', 'slots' stack slots were in use when the
+               scope was entered, if 'layered' is set loads have to look
+               through the sequential layers of the update set
+            */
+            struct Fork
+            {
+                u1 parallel;
+                asmjit::CBNode* cursor;
+                std::vector< libcjel_ir::Value* > constants;
+                std::vector< Task > tasks;
+                u1 deferred;
+                asmjit::X86Gp updates;
+                std::size_t slots;
+                u1 layered;
+            };
+
+            /**
+               stack area of the current function, it holds the value of one
+               scope at a time and is handed out again once the scope is left
+            */
+            struct Slot
+            {
+                asmjit::X86Mem memory;
+                u32 size;
+                u32 alignment;
+                u1 used;
+            };
+
+            /**
+               control-flow statement whose scopes are currently compiled,
+               its scopes are the ones entered at the recorded scope and
+               inlining depth, a 'predicated' branch executes all its scopes
+               and stores through conditional moves, a 'swapped' branch emits
+               its second scope in front of the first one at 'anchor' and a
+               'cold' branch emits its unlikely scope behind the function
+               body, the main path continues at 'resume'
+            */
+            struct Control
+            {
+                libcjel_ir::Value* statement;
+                std::size_t depth;
+                std::size_t inlining;
+                std::size_t promotions;
+                std::vector< asmjit::Label > labels;
+                u32 scope;
+                u1 predicated;
+                u1 swapped;
+                u1 cold;
+                u1 active;
+                asmjit::CBNode* anchor;
+                asmjit::CBNode* resume;
+            };
+
+            /**
+               memory location 'base[ index ]' which is held in 'reg' while a
+               loop is executed and written back to 'memory' at its exit
+            */
+            struct Promotion
+            {
+                libcjel_ir::Value* base;
+                u64 index;
+                asmjit::X86Gp reg;
+                asmjit::X86Mem memory;
             };
 
           private:
-            asmjit::JitRuntime m_runtime;
+            Runtime& m_runtime;
             asmjit::CodeHolder m_codeholder;
             asmjit::StringLogger m_logger;
 
@@ -124,17 +419,52 @@ namespace libcjel_rt
 
             Callable* m_callable_last_accessed;
 
-            std::unordered_map< libcjel_ir::Value*, Callable > m_callables;
+            Numbering m_numbering;
+
+            ValueTable< Callable > m_callables;
+
+            ValueTable< asmjit::X86Gp > m_val2reg;
+            ValueTable< asmjit::X86Mem > m_val2mem;
+
+            std::vector< void* > m_functions;
+
+            std::unordered_map< std::string, void* > m_symbols;
+
+            std::unordered_set< libcjel_ir::Value* > m_called;
+            std::unordered_set< libcjel_ir::Value* > m_inlining;
 
-            std::unordered_map< libcjel_ir::Value*, asmjit::X86Gp > m_val2reg;
-            std::unordered_map< libcjel_ir::Value*, asmjit::X86Mem > m_val2mem;
+            std::vector< Fork > m_forks;
+            std::deque< Task > m_tasks;
+
+            std::vector< Control > m_controls;
+            std::vector< Promotion > m_promotions;
+            asmjit::CBNode* m_cold;
+            std::vector< Slot > m_slots;
+            std::vector< std::size_t > m_live;
+            std::unordered_map< libcjel_ir::Value*, std::vector< asmjit::X86Gp > > m_scalars;
+            std::unordered_map< libcjel_ir::Value*, asmjit::X86Vec > m_vectors;
+            asmjit::CCFunc* m_upper;
+            std::unordered_map< std::string, asmjit::Label > m_pool;
+
+            u1 m_module;
+            u1 m_instrumented;
+            u64 m_profile;
+            std::unordered_map< const libcjel_ir::Value*, u64 > m_invocations;
+            std::vector< std::shared_ptr< void > > m_counters;
 
           public:
-            Context( void )
-            : m_runtime()
+            Context( Runtime& runtime )
+            : m_runtime( runtime )
             , m_codeholder()
             , m_compiler()
             , m_callable_last_accessed( 0 )
+            , m_numbering()
+            , m_callables( m_numbering )
+            , m_val2reg( m_numbering )
+            , m_val2mem( m_numbering )
+            , m_module( false )
+            , m_instrumented( runtime.recompileThreshold() > 0 )
+            , m_profile( 0 )
             {
                 reset();
 
@@ -146,7 +476,7 @@ namespace libcjel_rt
                 m_compiler.onDetach( &m_codeholder );
 
                 m_codeholder.reset();
-                m_codeholder.init( m_runtime.getCodeInfo() );
+                m_codeholder.init( m_runtime.jit().getCodeInfo() );
                 m_codeholder.attach( &m_compiler );
                 m_codeholder.setLogger( &m_logger );
 
@@ -154,25 +484,46 @@ namespace libcjel_rt
 
                 m_val2reg.clear();
                 m_val2mem.clear();
+
+                m_called.clear();
+                m_inlining.clear();
+
+                m_forks.clear();
+                m_tasks.clear();
+
+                m_controls.clear();
+                m_promotions.clear();
+                m_cold = nullptr;
+                m_slots.clear();
+                m_live.clear();
+                m_scalars.clear();
+                m_vectors.clear();
+                m_upper = nullptr;
+                m_pool.clear();
+                m_invocations.clear();
+
+                for( auto& callable : m_callables.entries() )
+                {
+                    callable.setFunc( nullptr );
+                }
             }
 
             u1 hasCallable( libcjel_ir::Value* value )
             {
-                return m_callables.find( value ) != m_callables.end();
+                return m_callables.has( value );
             }
 
             Callable& callable( libcjel_ir::Value* value = nullptr )
             {
                 if( value )
                 {
-                    m_callable_last_accessed =
-                        &m_callables.emplace( value, Callable() ).first->second;
+                    m_callable_last_accessed = &m_callables[ value ];
                 }
 
                 return *m_callable_last_accessed;
             }
 
-            asmjit::JitRuntime& runtime( void )
+            Runtime& runtime( void )
             {
                 return m_runtime;
             }
@@ -192,24 +543,630 @@ namespace libcjel_rt
                 return m_compiler;
             }
 
-            std::unordered_map< libcjel_ir::Value*, asmjit::X86Gp >& val2reg( void )
+            Numbering& numbering( void )
+            {
+                return m_numbering;
+            }
+
+            ValueTable< asmjit::X86Gp >& val2reg( void )
             {
                 return m_val2reg;
             }
 
-            std::unordered_map< libcjel_ir::Value*, asmjit::X86Mem >& val2mem( void )
+            ValueTable< asmjit::X86Mem >& val2mem( void )
             {
                 return m_val2mem;
             }
+
+            /**
+               all functions registered at the runtime by this context
+            */
+            std::vector< void* >& functions( void )
+            {
+                return m_functions;
+            }
+
+            /**
+               entry points of all callables of the last compiled module
+            */
+            std::unordered_map< std::string, void* >& symbols( void )
+            {
+                return m_symbols;
+            }
+
+            /**
+               callables of the code holder which are target of at least one
+               emitted call
+            */
+            std::unordered_set< libcjel_ir::Value* >& called( void )
+            {
+                return m_called;
+            }
+
+            /**
+               intrinsics whose bodies are currently inlined
+            */
+            std::unordered_set< libcjel_ir::Value* >& inlining( void )
+            {
+                return m_inlining;
+            }
+
+            /**
+               scopes enclosing the currently compiled statement
+            */
+            std::vector< Fork >& forks( void )
+            {
+                return m_forks;
+            }
+
+            /**
+               innermost scope collecting updates or a null pointer if stores
+               are written to memory directly
+            */
+            Fork* updates( void )
+            {
+                for( auto fork = m_forks.rbegin(); fork != m_forks.rend(); ++fork )
+                {
+                    if( fork->deferred )
+                    {
+                        return &( *fork );
+                    }
+                }
+                return nullptr;
+            }
+
+            /**
+               forked statements whose functions are not emitted yet
+            */
+            std::deque< Task >& tasks( void )
+            {
+                return m_tasks;
+            }
+
+            std::vector< Control >& controls( void )
+            {
+                return m_controls;
+            }
+
+            /**
+               loop counters currently held in registers
+            */
+            std::vector< Promotion >& promotions( void )
+            {
+                return m_promotions;
+            }
+
+            /**
+               position behind the body of the current function where cold
+               scopes are appended, or a null pointer
+            */
+            asmjit::CBNode* cold( void ) const
+            {
+                return m_cold;
+            }
+
+            void setCold( asmjit::CBNode* cold )
+            {
+                m_cold = cold;
+            }
+
+            /**
+               stack slots of the current function
+            */
+            std::vector< Slot >& slots( void )
+            {
+                return m_slots;
+            }
+
+            /**
+               indices of the slots in use, in the order they were handed out
+            */
+            std::vector< std::size_t >& live( void )
+            {
+                return m_live;
+            }
+
+            /**
+               element registers of allocations which are not kept in memory,
+               keyed by the allocation and the parameters bound to it
+            */
+            std::unordered_map< libcjel_ir::Value*, std::vector< asmjit::X86Gp > >& scalars(
+                void )
+            {
+                return m_scalars;
+            }
+
+            /**
+               registers of vector values which are held in XMM or YMM
+               registers instead of memory
+            */
+            std::unordered_map< libcjel_ir::Value*, asmjit::X86Vec >& vectors( void )
+            {
+                return m_vectors;
+            }
+
+            /**
+               last function which clears the upper halves of the YMM
+               registers at its exit, or a null pointer
+            */
+            asmjit::CCFunc* upper( void ) const
+            {
+                return m_upper;
+            }
+
+            void setUpper( asmjit::CCFunc* upper )
+            {
+                m_upper = upper;
+            }
+
+            /**
+               labels of the constant data blocks emitted behind the code of
+               the code holder, keyed by their bytes
+            */
+            std::unordered_map< std::string, asmjit::Label >& pool( void )
+            {
+                return m_pool;
+            }
+
+            /**
+               true while a whole module is compiled into one code holder
+            */
+            u1 isModule( void ) const
+            {
+                return m_module;
+            }
+
+            void setModule( u1 module )
+            {
+                m_module = module;
+            }
+
+            /**
+               true if the emitted code increments the profile counters of
+               the runtime
+            */
+            u1 isInstrumented( void ) const
+            {
+                return m_instrumented;
+            }
+
+            void setInstrumented( u1 instrumented )
+            {
+                m_instrumented = instrumented;
+            }
+
+            /**
+               profile counters incremented by the functions of this context,
+               the code of the functions has to keep them alive
+            */
+            std::vector< std::shared_ptr< void > >& counters( void )
+            {
+                return m_counters;
+            }
+
+            /**
+               recorded invocations of the compiled callable if the
+               compilation is guided by its profile, '0' otherwise
+            */
+            u64 profile( void ) const
+            {
+                return m_profile;
+            }
+
+            void setProfile( u64 invocations )
+            {
+                m_profile = invocations;
+            }
+
+            /**
+               recorded invocations of 'callable', read once per compilation
+               so all decisions agree while instrumented code keeps running
+            */
+            u64 invocations( const libcjel_ir::Value* callable )
+            {
+                auto result = m_invocations.emplace( callable, 0 );
+                if( result.second )
+                {
+                    result.first->second = *m_runtime.invocations( callable );
+                }
+                return result.first->second;
+            }
+        };
+
+        class Data : public libpass::PassData
+        {
+          public:
+            using Ptr = std::shared_ptr< Data >;
+
+            Data(
+                const std::shared_ptr< libcjel_ir::Module >& module,
+                Runtime& runtime = Runtime::instance() );
+
+            const std::shared_ptr< libcjel_ir::Module >& module( void ) const;
+
+            Runtime& runtime( void ) const;
+
+            /**
+               entry point of the callable 'name' of signature 'void(
+               void*... )' with one pointer per input and output, or a null
+               pointer if there is no such callable
+            */
+            void* symbol( const std::string& name ) const;
+
+            const std::unordered_map< std::string, void* >& symbols( void ) const;
+
+            void setSymbols(
+                const std::unordered_map< std::string, void* >& symbols,
+                const CodeCache::Code::Ptr& code );
+
+          private:
+            std::shared_ptr< libcjel_ir::Module > m_module;
+            Runtime& m_runtime;
+
+            std::unordered_map< std::string, void* > m_symbols;
+            CodeCache::Code::Ptr m_code;
         };
 
       private:
         void alloc_reg_for_value( libcjel_ir::Value& value, Context& c );
 
+        /**
+           XMM or YMM register for a value of the vector 'type'
+        */
+        asmjit::X86Vec new_reg_for_vector_type(
+            const libcjel_ir::Type& type, const char* label, Context& c );
+
+        /**
+           moves 'byte_size' bytes between the vector register 'reg' and
+           'memory', the register is loaded if 'load' is set
+        */
+        void move_vector(
+            const asmjit::X86Vec& reg, asmjit::X86Mem memory, u32 byte_size, u1 load, Context& c );
+
+        /**
+           element 'index' of 'element' type of the vector in 'reg', taken
+           out with word extracts and shuffles
+        */
+        asmjit::X86Gp extract_lane(
+            const asmjit::X86Vec& reg, u32 index, const libcjel_ir::Type& element, Context& c );
+
+        /**
+           lowers the element-wise operation 'value' on vectors held in vector
+           registers to one packed instruction, returns false for all other
+           values
+        */
+        u1 lanewise( libcjel_ir::Instruction& value, Context& c );
+
+        /**
+           binds the constant input 'value' to the entry argument 'argument'
+        */
+        void alloc_reg_for_input( libcjel_ir::Value& value, u32 argument, Context& c );
+
+        /**
+           branch-free lowering of a predicate, compares 'lhs' with 'rhs' or
+           tests 'lhs' against zero if 'rhs' is null and sets the result of
+           'value' to one if 'condition' holds
+        */
+        void compare(
+            libcjel_ir::Value& value,
+            libcjel_ir::Value& lhs,
+            libcjel_ir::Value* rhs,
+            u32 condition,
+            Context& c );
+
+        /**
+           numbers all values of 'value' upfront, so the value tables of 'c'
+           are sized once per function
+        */
+        void number( libcjel_ir::Value& value, Context& c );
+
+        void declare( libcjel_ir::CallableUnit& value, Context& c );
+
+        /**
+           appends all callables transitively called by 'value' which are not
+           already part of 'callables'
+        */
+        void collect(
+            libcjel_ir::CallableUnit& value, std::vector< libcjel_ir::CallableUnit* >& callables );
+
+        /**
+           callable which is executed by a call to 'value', calls to callables
+           which only forward their parameters in a tail call to another
+           callable are resolved to the final callee
+        */
+        libcjel_ir::CallableUnit& target( libcjel_ir::CallableUnit& value );
+
+        /**
+           true if the callee body of 'value' fits into the inline budget of
+           the runtime and all its arguments are passed by pointer
+        */
+        u1 inlinable( libcjel_ir::CallInstruction& value, Context& c );
+
+        /**
+           emits the callee body of 'value' into the current function with
+           its parameters bound to the arguments of 'value'
+        */
+        void inline_call( libcjel_ir::CallInstruction& value, Context& c );
+
+        /**
+           true if the allocation passed as 'operand' of 'value' is a small
+           aggregate which the inlined callee body only accesses through
+           extracts, loads and stores, so its elements can live in registers
+        */
+        u1 scalarizable( libcjel_ir::CallInstruction& value, u32 operand, Context& c );
+
+        /**
+           true if at least two statements of the parallel scope 'value' are
+           large enough to be worth a job of the thread pool
+        */
+        u1 forkable( libcjel_ir::Value& value, Context& c );
+
+        /**
+           passes the frames of all forked statements of 'fork' to the thread
+           pool and returns after all of them have been executed
+        */
+        void spawn( Context::Fork& fork, Context& c );
+
+        /**
+           emits the functions of all pending forked statements, has to be
+           called outside of any function
+        */
+        void compile_tasks( Context& c );
+
+        /**
+           inserts the bit value 'src' of 'type' as update of the location
+           'dst' into the update set of 'fork', wide values are inserted as one
+           update per limb
+        */
+        void update(
+            const asmjit::X86Gp& dst,
+            const asmjit::X86Gp& src,
+            const libcjel_ir::Type& type,
+            Context::Fork& fork,
+            Context& c );
+
+        /**
+           acquires the update set of 'fork' for at least 'capacity' updates,
+           a 'sequential' set is a layer of the enclosing update set
+        */
+        void open_updates( Context::Fork& fork, u64 capacity, u1 sequential, Context& c );
+
+        /**
+           commits the update set of the popped 'fork' into the one of the
+           enclosing scope, or to memory if there is none
+        */
+        void close_updates( Context::Fork& fork, Context& c );
+
+        /**
+           loads the word of 'size' bytes at 'memory' as seen by the scope of
+           'fork', whose sequential layers may hold a newer update of it
+        */
+        asmjit::X86Gp read(
+            const asmjit::X86Mem& memory, u32 size, Context::Fork& fork, Context& c );
+
+        /**
+           materializes all constants used by 'value' upfront, so they are
+           defined on every path through the control flow of 'value'
+        */
+        void hoist( libcjel_ir::Value& value, Context& c );
+
+        /**
+           control-flow statement owning the scope which is entered or left
+           at the current position, or a null pointer
+        */
+        Context::Control* control( Context& c );
+
+        /**
+           true if the short scopes of the branch 'value' only compute and
+           store bit values, so they can be executed unconditionally
+        */
+        u1 convertible( libcjel_ir::BranchStatement& value, Context& c );
+
+        /**
+           predicated branch whose scope is currently compiled, or a null
+           pointer
+        */
+        Context::Control* predicate( Context& c );
+
+        /**
+           moves the cursor behind the body of the current function and
+           returns the position it has to be restored to
+        */
+        asmjit::CBNode* enter_cold( Context& c );
+
+        void leave_cold( asmjit::CBNode* resume, Context& c );
+
+        void enter_scope( Context& c );
+
+        void leave_scope( Context& c );
+
+        /**
+           promotion of the location addressed by 'value' or a null pointer
+        */
+        Context::Promotion* promoted( libcjel_ir::Value& value, Context& c );
+
+        /**
+           emits a loop executing 'factor' bodies of the counted loop 'value'
+           per iteration as long as at least 'factor' iterations remain, the
+           remaining iterations are executed by the regular loop
+        */
+        void unroll(
+            libcjel_ir::LoopStatement& value,
+            libcjel_ir::Value& end,
+            u64 factor,
+            Context::Promotion& counter,
+            Context& c );
+
+        /**
+           address of 'bytes' in the read-only constant pool of the code
+           holder, identical constants of all functions share one entry
+        */
+        asmjit::X86Mem pooled( const std::string& bytes, Context& c );
+
+        /**
+           stack area of 'byte_size' bytes at natural alignment, a released
+           area which fits is reused before the frame grows
+        */
+        asmjit::X86Mem slot( u32 byte_size, Context& c );
+
+        /**
+           hands out the slots again which were taken after the first 'live'
+           ones, unless stores into them are still deferred
+        */
+        void release( std::size_t live, Context& c );
+
+        void callable_prolog( libcjel_ir::CallableUnit& value, Context& c );
+
+        void callable_interlog( libcjel_ir::CallableUnit& value, Context& c );
+
+        void callable_epilog( libcjel_ir::CallableUnit& value, Context& c );
+
+        /**
+           lowers an operation over wide bit values limb by limb, the
+           instruction 'first' is emitted for the lowest limb and 'next' for
+           all others, e.g. 'add' and 'adc' for a carry chain, 'rhs' is null
+           for unary operations
+        */
+        void limbwise(
+            u32 first,
+            u32 next,
+            libcjel_ir::Value& value,
+            libcjel_ir::Value& lhs,
+            libcjel_ir::Value* rhs,
+            Context& c );
+
+        /**
+           copies 'byte_size' bytes from 'src' to 'dst' with 16-byte vector
+           moves and 8, 4, 2 and 1 byte moves for the remaining tail
+        */
+        void copy(
+            const asmjit::X86Gp& dst, const asmjit::X86Gp& src, u32 byte_size, Context& c );
+
+        /**
+           clears 'byte_size' bytes at 'dst' with the same moves as 'copy'
+        */
+        void zero( const asmjit::X86Gp& dst, u32 byte_size, Context& c );
+
+        /**
+           resets 'c' to compile the call 'value' and all its callees into
+           one code holder and returns the callees
+        */
+        std::vector< libcjel_ir::CallableUnit* > open_module(
+            libcjel_ir::CallInstruction& value, Context& c );
+
+        /**
+           emits the callees of 'value' which were not inlined and links the
+           code holder, returns the entry point of 'value'
+        */
+        void* close_module( libcjel_ir::CallInstruction& value,
+            const std::vector< libcjel_ir::CallableUnit* >& callees,
+            Context& c );
+
+        /**
+           lane width in bytes at which the callee body of the batch call
+           'value' is evaluated in vector registers, or zero if the body is
+           not straight-line code of lane-wise bit operations
+        */
+        u32 vectorizable( libcjel_ir::CallInstruction& value, Context& c );
+
+        /**
+           emits a loop which evaluates the batch call 'value' for as many
+           elements per iteration as lanes of 'width' bytes fit into an AVX2
+           or SSE2 register, it is left for the scalar loop as soon as fewer
+           elements remain or if any stream is not dense
+        */
+        void vectorize( libcjel_ir::CallInstruction& value,
+            const std::vector< u32 >& operands,
+            const std::vector< asmjit::X86Gp >& cursors,
+            const std::vector< asmjit::X86Gp >& strides,
+            const asmjit::X86Gp& count,
+            u32 width,
+            Context& c );
+
+        /**
+           keeps the allocation passed as 'operand' of 'value' in zeroed
+           element registers
+        */
+        void scalarize( libcjel_ir::CallInstruction& value, u32 operand, Context& c );
+
+        /**
+           writes the element registers of the scalar 'value' to 'dst'
+        */
+        void store_scalars( libcjel_ir::Value& value, const asmjit::X86Gp& dst, Context& c );
+
+        void* finalize( libcjel_ir::Value& value, Context& c );
+
+        void* link( libcjel_ir::Value& value, Context& c );
+
+        u1 fold( libcjel_ir::Value& value, Context& c );
+
       public:
+        /**
+           compiles an entry point which takes every constant operand of the
+           instruction as an argument, bit values of up to one word by value
+           and all others as pointer to their encoding, results for which
+           'returned_in_register' holds are returned and all others are
+           written through a leading 'out' pointer argument
+        */
+        void* compile( libcjel_ir::OperatorInstruction& value, Context& c );
+
+        void* compile( libcjel_ir::CallInstruction& value, Context& c );
+
+        /**
+           compiles a batch entry point 'void( u64 count, const void* streams )'
+           which evaluates the call 'value' for 'count' elements, 'streams'
+           holds a 'base' pointer and a 'stride' word per stream, first the
+           output of 'value' and then one per constant operand in order, the
+           element 'i' of a stream is the encoding of its value at 'base + i *
+           stride', and the loop around the callee body is part of the code,
+           straight-line bodies of lane-wise bit operations are evaluated for
+           several elements at once while the streams are dense
+        */
+        void* compile_batch( libcjel_ir::CallInstruction& value, Context& c );
+
+        /**
+           compiles all functions and intrinsics of 'value' into one code
+           holder, calls between them are direct, and fills the symbol table
+           of 'c', returns the start of the module code
+        */
+        void* compile( libcjel_ir::Module& value, Context& c );
+
+        libcjel_ir::Constant invoke( void* entry, libcjel_ir::Instruction& value );
+
         libcjel_ir::Constant execute( libcjel_ir::OperatorInstruction& value, Context& c );
 
         libcjel_ir::Constant execute( libcjel_ir::CallInstruction& value, Context& c );
+
+        /**
+           returns the callee of 'value' if its whole body is a tail call
+           which forwards the parameters of 'value' in order, otherwise a null
+           pointer
+        */
+        static libcjel_ir::CallableUnit* forward( libcjel_ir::CallableUnit& value );
+
+        static u32 byte_size( const libcjel_ir::Type& type );
+
+        /**
+           byte offset of the element 'index' of the structure 'type' in
+           memory, encoded constants and results
+        */
+        static u32 byte_offset( const libcjel_ir::Type& type, u64 index );
+
+        /**
+           true if a result of 'type' is returned in the return register of
+           an entry point, its bytes are placed as in memory
+        */
+        static u1 returned_in_register( const libcjel_ir::Type& type );
+
+        /**
+           true if an input of 'type' is passed by value to an entry point
+        */
+        static u1 passed_in_register( const libcjel_ir::Type& type );
+
+        static void encode( libcjel_ir::Value& value, u8* buffer );
+
+        static libcjel_ir::Constant decode(
+            const std::shared_ptr< libcjel_ir::Type >& type, const u8* buffer );
     };
 }
 